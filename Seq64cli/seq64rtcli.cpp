@@ -36,6 +36,7 @@
 
 #if defined PLATFORM_LINUX
 #include <signal.h>
+#include <time.h>                       /* time() to stamp the metrics      */
 #include <unistd.h>
 #endif
 
@@ -70,6 +71,52 @@ seq64_signal_handler (int signalnumber)
         s_seq64cli_running = false;
 }
 
+/**
+ *  Appends the current output-thread statistics to the metrics file given
+ *  by the "-o metrics=filename[,seconds]" option.  A file whose name ends
+ *  in ".csv" gets a CSV line, preceded by the header line if the file is
+ *  empty; any other file gets a line of JSON.
+ *
+ * \param p
+ *      The performance whose statistics are dumped.
+ *
+ * \return
+ *      Returns true if the line could be written.
+ */
+
+static bool
+seq64_dump_metrics (const seq64::perform & p)
+{
+    const std::string & filename = seq64::usr().option_metricsfile();
+    FILE * fp = fopen(filename.c_str(), "a");
+    if (fp != NULL)
+    {
+        seq64::perfstats::snapshot snap;
+        p.get_output_stats(snap);
+
+        long now = long(time(NULL));
+        std::string::size_type len = filename.length();
+        bool csv = len > 4 && filename.compare(len - 4, 4, ".csv") == 0;
+        std::string line;
+        if (csv)
+        {
+            if (ftell(fp) == 0)
+            {
+                line = seq64::perfstats::csv_header();
+                fprintf(fp, "%s\n", line.c_str());
+            }
+            line = seq64::perfstats::to_csv(snap, now);
+        }
+        else
+            line = seq64::perfstats::to_json(snap, now);
+
+        fprintf(fp, "%s\n", line.c_str());
+        fclose(fp);
+        return true;
+    }
+    return false;
+}
+
 #endif  // PLATFORM_LINUX
 
 /**
@@ -195,7 +242,37 @@ main (int argc, char * argv [])
                 else
                     printf("? MIDI file not found: %s\n", fn.c_str());
             }
-            if (ok)
+            std::string renderfile = seq64::usr().option_renderfile();
+            if (ok && ! renderfile.empty())
+            {
+                /*
+                 * Render the song instead of running; the ports opened by
+                 * launch() stay idle, since the output is captured.
+                 */
+
+                std::vector<seq64::render_message> messages;
+                if (optionindex >= argc)
+                {
+                    printf("? Rendering needs a MIDI file\n");
+                    ok = false;
+                }
+                else if (! p.render_song(messages))
+                {
+                    printf("? Song has no triggers to render\n");
+                    ok = false;
+                }
+                else
+                {
+                    seq64::midifile f(renderfile, p.ppqn());
+                    ok = f.write_render(p, messages);
+                    if (ok)
+                        printf("[Rendered to %s]\n", renderfile.c_str());
+                    else
+                        printf("? %s\n", f.error_message().c_str());
+                }
+                p.finish();                         /* tear down performer  */
+            }
+            else if (ok)
             {
                 if (seq64::rc().lash_support())
                     seq64::create_lash_driver(p, argc, argv);
@@ -211,9 +288,31 @@ main (int argc, char * argv [])
                 {
                     if (signal(SIGTERM, seq64_signal_handler) != SIG_ERR)
                     {
+                        bool metrics =
+                            ! seq64::usr().option_metricsfile().empty();
+
+                        int interval = seq64::usr().option_metrics_interval();
+                        int seconds = 0;
                         s_seq64cli_running = true;
                         while (s_seq64cli_running)
+                        {
                             usleep(1000000);
+                            p.poll_autosave();
+                            if (metrics && ++seconds >= interval)
+                            {
+                                seconds = 0;
+                                if (! seq64_dump_metrics(p))
+                                {
+                                    printf
+                                    (
+                                        "? Cannot write metrics to %s\n",
+                                        seq64::usr().option_metricsfile()
+                                            .c_str()
+                                    );
+                                    metrics = false;
+                                }
+                            }
+                        }
                     }
                     else
                         printf("? Cannot set SIGTERM handler\n");
@@ -0,0 +1,72 @@
+#ifndef SEQ64_ALSA_EVENT_HPP
+#define SEQ64_ALSA_EVENT_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          alsa_event.hpp
+ *
+ *  This module declares the encoding of MIDI messages into ALSA sequencer
+ *  events.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Shared by the ALSA midibus of the seq_alsamidi library and the midi_alsa
+ *  class of the seq_rtmidi library.  Empty if ALSA is not supported.
+ */
+
+#include "seq64_features.h"             /* SEQ64_HAVE_LIBASOUND             */
+
+#ifdef SEQ64_HAVE_LIBASOUND
+
+#include <alsa/asoundlib.h>
+
+#include "midibyte.hpp"                 /* seq64::midibyte                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/*
+ *  Free functions
+ */
+
+extern bool encode_channel_event
+(
+    const midibyte buffer [], snd_seq_event_t & ev
+);
+
+}           // namespace seq64
+
+#endif      // SEQ64_HAVE_LIBASOUND
+
+#endif      // SEQ64_ALSA_EVENT_HPP
+
+/*
+ * alsa_event.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,195 @@
+#ifndef SEQ64_AUTOSAVE_HPP
+#define SEQ64_AUTOSAVE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          autosave.hpp
+ *
+ *  This module declares a class for saving the song periodically in the
+ *  background, for recovery after a crash.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Autosaving is done in two steps.  The thread that owns the performance
+ *  (the GUI thread, or the main loop of the command-line application)
+ *  calls autosave::poll() regularly.  When the interval set by
+ *  rc_settings::autosave_interval() has passed and the song has unsaved
+ *  changes, poll() takes a song_snapshot:  a detached copy of the settings
+ *  and triggers of each active sequence, plus a shared event_snapshot of
+ *  its events, and the bytes of the proprietary track.  This takes each
+ *  sequence lock only briefly, and the events of unchanged sequences are
+ *  not copied at all.  The snapshot is then handed to a low-priority thread
+ *  that builds the MIDI file from it, writes it to a temporary file, syncs
+ *  it to the disk, and renames it over the autosave file, so that a crash
+ *  never leaves a half-written autosave file.
+ */
+
+#include <pthread.h>                    /* pthread_t                        */
+#include <string>
+#include <vector>
+
+#include "event_snapshot.hpp"           /* seq64::event_snapshot_ptr        */
+#include "midi_container.hpp"           /* seq64::track_timing              */
+#include "midibyte.hpp"                 /* seq64::midibyte                  */
+#include "mutex.hpp"                    /* seq64::condition_var             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class perform;
+    class sequence;
+
+/**
+ *  One sequence of a song_snapshot.
+ */
+
+struct saved_track
+{
+    int st_number;                  /**< The track (sequence) number.       */
+    sequence * st_sequence;         /**< Detached copy, without its events. */
+    event_snapshot_ptr st_events;   /**< The events of the sequence.        */
+};
+
+/**
+ *  A copy of what midifile::write() saves, made by midifile::take_snapshot()
+ *  and written by midifile::write_snapshot().
+ */
+
+struct song_snapshot
+{
+    std::string ss_filename;                /**< The file to write.         */
+    int ss_ppqn;                            /**< The PPQN of the song.      */
+    track_timing ss_timing;                 /**< Tempo and time signature.  */
+    std::vector<saved_track> ss_tracks;     /**< The active sequences.      */
+    std::vector<midibyte> ss_proprietary;   /**< The SeqSpec track bytes.   */
+
+    song_snapshot ();
+    ~song_snapshot ();
+
+private:        // do not allow these functions to be used
+
+    song_snapshot (const song_snapshot &);
+    song_snapshot & operator = (const song_snapshot &);
+
+};
+
+/**
+ *  Saves the song periodically on a background thread.
+ */
+
+class autosave
+{
+    friend void * autosave_thread_func (void * myautosave);
+
+private:
+
+    /**
+     *  The performance to save.
+     */
+
+    perform & m_perform;
+
+    /**
+     *  Guards m_pending, m_saving, and m_exit, and wakes the thread when
+     *  there is a snapshot to write or when it must exit.
+     */
+
+    condition_var m_condition;
+
+    /**
+     *  The snapshot waiting to be written, or a null pointer.
+     */
+
+    song_snapshot * m_pending;
+
+    /**
+     *  True while the thread writes a snapshot.
+     */
+
+    bool m_saving;
+
+    /**
+     *  Tells the thread to exit.
+     */
+
+    bool m_exit;
+
+    /**
+     *  The autosave thread, once launched.
+     */
+
+    pthread_t m_thread;
+
+    /**
+     *  True if m_thread was launched, and must be joined.
+     */
+
+    bool m_thread_launched;
+
+    /**
+     *  The time of the last check for changes, in wakeup_event::now_us()
+     *  microseconds.
+     */
+
+    std::int64_t m_last_check_us;
+
+private:        // do not allow these functions to be used
+
+    autosave (const autosave &);
+    autosave & operator = (const autosave &);
+
+public:
+
+    autosave (perform & p);
+    ~autosave ();
+
+    void poll ();
+    void stop ();
+
+private:
+
+    bool launch ();
+    void run ();
+    bool save (song_snapshot & ss);
+
+};
+
+/*
+ *  Global functions in the seq64 namespace.
+ */
+
+extern void * autosave_thread_func (void * myautosave);
+
+}           // namespace seq64
+
+#endif      // SEQ64_AUTOSAVE_HPP
+
+/*
+ * autosave.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
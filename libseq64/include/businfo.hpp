@@ -242,9 +242,9 @@ private:
         bus()->init_clock(tick);
     }
 
-    void clock (midipulse tick)
+    void clock (midipulse tick, midipulse ahead)
     {
-        bus()->clock(tick);
+        bus()->clock(tick, ahead);
     }
 
     void sysex (event * ev)
@@ -301,9 +301,13 @@ public:
     void stop ();
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
-    void clock (midipulse tick);
+    void clock (midipulse tick, midipulse ahead = SEQ64_NULL_MIDIPULSE);
     void sysex (event * ev);
-    void play (bussbyte bus, event * e24, midibyte channel);
+    void play
+    (
+        bussbyte bus, event * e24, midibyte channel,
+        midipulse delay = SEQ64_NULL_MIDIPULSE
+    );
     bool set_clock (bussbyte bus, clock_e clocktype);
     void set_all_clocks ();
     clock_e get_clock (bussbyte bus);
@@ -42,6 +42,7 @@
  *  this data.
  */
 
+#include <memory>                       /* std::shared_ptr for SYSEX    */
 #include <string>                       /* used in to_string()          */
 #include <vector>                       /* SYSEX data stored in vector  */
 
@@ -226,6 +227,13 @@ public:
 
 private:
 
+    /**
+     *  The empty container returned by the const get_sysex() for an event
+     *  that has no SysEx/Meta data.
+     */
+
+    static const SysexContainer sm_no_sysex;
+
     /**
      *  Provides the MIDI timestamp in ticks, otherwise known as the "pulses"
      *  in "pulses per quarter note" (PPQN).
@@ -275,9 +283,15 @@ private:
      *  The data buffer for SYSEX messages.  Adapted from Stazed's Seq32
      *  project on GitHub.  This object will also hold the generally small
      *  amounts of data needed for Meta events.
+     *
+     *  Only SysEx and Meta events need this buffer, so it is kept out of
+     *  line.  It is null for all other events, and is shared by the copies
+     *  of an event (undo stack, clipboard, event lists), so that copying an
+     *  event never allocates.  Any modification first makes a private copy
+     *  of a shared buffer; see sysex_buffer().
      */
 
-    SysexContainer m_sysex;
+    std::shared_ptr<SysexContainer> m_sysex;
 
     /**
      *  This event is used to link Note Ons and Offs together.
@@ -762,17 +776,19 @@ public:
 
     bool set_sysex (midibyte * data, int len)
     {
-        m_sysex.clear();
+        m_sysex.reset();
         return append_sysex(data, len);
     }
 
     /**
      * \getter m_sysex from stazed, non-const version for use by midibus.
+     *      Since the caller can modify the data, the buffer is first made
+     *      private to this event.
      */
 
     SysexContainer & get_sysex ()
     {
-        return m_sysex;
+        return sysex_buffer();
     }
 
     /**
@@ -781,7 +797,7 @@ public:
 
     const SysexContainer & get_sysex () const
     {
-        return m_sysex;
+        return m_sysex ? *m_sysex : sm_no_sysex ;
     }
 
     /**
@@ -790,19 +806,19 @@ public:
 
     void set_sysex_size (int len)
     {
-        if (len == 0)
-            m_sysex.clear();
+        if (len <= 0)
+            m_sysex.reset();
         else
-            m_sysex.resize(len);
+            sysex_buffer().resize(len);
     }
 
     /**
-     * \getter m_sysex.size()
+     * \getter m_sysex->size()
      */
 
     int get_sysex_size () const
     {
-        return int(m_sysex.size());
+        return m_sysex ? int(m_sysex->size()) : 0 ;
     }
 
     /**
@@ -1142,6 +1158,10 @@ public:
 
     int get_rank () const;
 
+private:
+
+    SysexContainer & sysex_buffer ();
+
 };          // class event
 
 /*
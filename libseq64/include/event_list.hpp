@@ -52,8 +52,14 @@
 
 #include "seq64_features.h"             /* SEQ64_USE_EVENT_MAP          */
 
+#if defined SEQ64_USE_EVENT_MAP && defined SEQ64_USE_EVENT_VECTOR
+#error Define only one of SEQ64_USE_EVENT_MAP and SEQ64_USE_EVENT_VECTOR
+#endif
+
 #ifdef SEQ64_USE_EVENT_MAP
 #include <map>                          /* std::multimap                */
+#elif defined SEQ64_USE_EVENT_VECTOR
+#include <vector>                       /* std::vector                  */
 #else
 #include <list>                         /* std::list                    */
 #endif
@@ -79,20 +85,46 @@ namespace seq64
 {
 
 /**
- *  The event_list class is a receptable for MIDI events.  Two
- *  implementations, an std::multimap, and the original, an std::list, are
- *  provided for comparison, and are selected at build time, by manually
- *  defining the SEQ64_USE_EVENT_MAP macro near the top of this module.
+ *  The event_list class is a receptable for MIDI events.  Three
+ *  implementations, an std::multimap, a sorted std::vector, and the
+ *  original, an std::list, are provided for comparison, and are selected at
+ *  build time, by manually defining the SEQ64_USE_EVENT_MAP or
+ *  SEQ64_USE_EVENT_VECTOR macro in the seq64_features.h module.
+ *
+ *  The vector keeps the events contiguous and in order, so that the scans
+ *  done by playback and drawing walk through memory linearly.  The price is
+ *  that inserting or removing an event moves the events after it, which
+ *  invalidates all iterators and event pointers.  Therefore, in the vector
+ *  implementation, every operation that leaves the container sorted also
+ *  rebuilds the note and tempo links (see relink()), and client code must
+ *  never add or remove events while iterating over the container.  A series
+ *  of such operations can be bracketed by hold_links() and release_links(),
+ *  so that the links are rebuilt only once.
+ *
+ *  The links stay event pointers in the vector, rather than becoming
+ *  indices.  The link member of the event class, and the sequence and user
+ *  interface code that follows it, are shared by all three containers; the
+ *  list and the multimap never move their events, so pointers suit them.
+ *  And an index shifts on every insertion or removal just as a pointer
+ *  does, so the vector would still have to renumber the links after each
+ *  batch, in the same single pass that relink() makes.
+ *
+ *  The tests/event_list_bench.cpp program times playback, insertion, and
+ *  sorting on a pattern of 100,000 events, for whichever container the
+ *  build selects.
  */
 
 class event_list
 {
 
     friend class editable_events;       // access to event_key class
+    friend class event_stack;           // access to iterators, replace()
+    friend class event_snapshot;        // access to const_iterator
     friend class midifile;              // access to print()
     friend class midi_container;        // access to event_list::iterator
     friend class midi_splitter;         // ditto
     friend class sequence;              // tritto
+    friend class sequence_edit;         // access to hold_links()
     friend class seqdata;               // quaditto
     friend class seqevent;              // quintitto
 
@@ -142,12 +174,23 @@ private:
     typedef std::multimap<event_key, event> Events;
     typedef std::pair<event_key, event> EventsPair;
 
+#elif defined SEQ64_USE_EVENT_VECTOR
+
+    typedef std::vector<event> Events;
+
 #else   // use std::list here:
 
     typedef std::list<event> Events;
 
 #endif  // SEQ64_USE_EVENT_MAP
 
+public:
+
+    /**
+     *  The iterators returned by begin() and end().  Use dref() to get the
+     *  event from one of them, whatever the container.
+     */
+
     typedef Events::iterator iterator;
     typedef Events::const_iterator const_iterator;
     typedef Events::reverse_iterator reverse_iterator;
@@ -188,6 +231,35 @@ private:
 
     bool m_has_time_signature;
 
+    /**
+     *  Counts the structural changes (insertion, removal, sorting, merging,
+     *  and assignment) made to the container.  Client code that caches an
+     *  iterator into the container, such as the play cursor of the sequence
+     *  class, compares against this value to find out if its iterator has
+     *  gone stale.
+     */
+
+    unsigned m_revision;
+
+#ifdef SEQ64_USE_EVENT_VECTOR
+
+    /**
+     *  The depth of hold_links() calls not yet matched by release_links().
+     *  While it is positive, the operations that move events do not rebuild
+     *  the links; see links_moved().
+     */
+
+    int m_link_holds;
+
+    /**
+     *  True if events moved while the links were held, so that the last
+     *  release_links() must rebuild them.
+     */
+
+    bool m_links_stale;
+
+#endif
+
 public:
 
     event_list ();
@@ -286,6 +358,8 @@ public:
     {
 #ifdef SEQ64_USE_EVENT_MAP
         return append(e);
+#elif defined SEQ64_USE_EVENT_VECTOR
+        return insert(e);               /* in place, by time and "rank" */
 #else
         bool result = append(e);
         sort();                         /* by time-stamp and "rank" */
@@ -293,7 +367,10 @@ public:
 #endif
     }
 
+    bool add_linked (const event & e);
     bool append (const event & e);
+    void link_new ();
+    void verify_and_link (midipulse slength);
 
 #ifdef SEQ64_USE_EVENT_MAP
 
@@ -309,7 +386,7 @@ public:
 #else
 
     /**
-     *  Needed as a special case when std::list is used.
+     *  Needed as a special case when std::list or std::vector is used.
      *
      * \param e
      *      Provides the event value to push at the back of the event list.
@@ -318,6 +395,7 @@ public:
     void push_back (const event & e)
     {
         m_events.push_back(e);
+        ++m_revision;
     }
 
 #endif
@@ -331,6 +409,15 @@ public:
         return m_is_modified;
     }
 
+    /**
+     * \getter m_revision
+     */
+
+    unsigned revision () const
+    {
+        return m_revision;
+    }
+
     /**
      * \getter m_has_tempo
      */
@@ -373,6 +460,10 @@ public:
     {
         m_events.erase(ie);
         m_is_modified = true;
+        ++m_revision;
+#ifdef SEQ64_USE_EVENT_VECTOR
+        links_moved();                  /* the later events have moved  */
+#endif
     }
 
     /**
@@ -383,22 +474,49 @@ public:
     {
         m_events.clear();
         m_is_modified = true;
+        ++m_revision;
+    }
+
+    /**
+     *  Makes room for the given number of events, to avoid reallocations
+     *  while appending many of them, such as when reading a MIDI file.  Only
+     *  the std::vector implementation can reserve storage; for the others
+     *  this function does nothing.
+     *
+     * \param count
+     *      The expected number of events.
+     */
+
+    void reserve (int count)
+    {
+#ifdef SEQ64_USE_EVENT_VECTOR
+        if (count > 0)
+            m_events.reserve(std::size_t(count));
+#else
+        (void) count;
+#endif
     }
 
     void merge (event_list & el, bool presort = true);
 
     /**
-     *  Sorts the event list; active only for the std::list implementation.
+     *  Sorts the event list; active only for the std::list and std::vector
+     *  implementations.
      */
 
+#ifdef SEQ64_USE_EVENT_VECTOR
+    void sort ();
+#else
     void sort ()
     {
 #ifdef SEQ64_USE_EVENT_MAP
         // we need nothin' for sorting a multimap
 #else
         m_events.sort();
+        ++m_revision;
 #endif
     }
+#endif
 
     /**
      *  Dereference access for list or map.
@@ -439,9 +557,48 @@ private:                                // functions for friend sequence
      * involved data from the caller.
      */
 
-    void link_new ();
+#ifdef SEQ64_USE_EVENT_VECTOR
+    bool insert (const event & e);
+    void relink ();
+    void links_moved ();
+#endif
+
+    /**
+     *  Starts a batch of changes to the container.  With the std::vector
+     *  implementation, the note and tempo links are then rebuilt only once,
+     *  by the matching release_links(), instead of after every insertion,
+     *  removal, sort, or merge; the links must not be followed until then.
+     *  Calls can nest.  The other implementations do not move events, so
+     *  this function does nothing for them.
+     */
+
+    void hold_links ()
+    {
+#ifdef SEQ64_USE_EVENT_VECTOR
+        ++m_link_holds;
+#endif
+    }
+
+    /**
+     *  Ends a batch of changes started by hold_links(), rebuilding the links
+     *  if events moved during the outermost batch.
+     */
+
+    void release_links ()
+    {
+#ifdef SEQ64_USE_EVENT_VECTOR
+        if (--m_link_holds == 0 && m_links_stale)
+            relink();
+#endif
+    }
+
+    void replace
+    (
+        std::size_t first, std::size_t count, const std::vector<event> & source
+    );
+    void link_notes ();
+    void link_event (iterator ie);
     void clear_links ();
-    void verify_and_link (midipulse slength);
     void link_tempos ();
     void clear_tempo_links ();
     bool mark_selected ();
@@ -0,0 +1,219 @@
+#ifndef SEQ64_EVENT_SNAPSHOT_HPP
+#define SEQ64_EVENT_SNAPSHOT_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_snapshot.hpp
+ *
+ *  This module declares a read-only copy of the events of a sequence, for
+ *  the user-interface views to draw from.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  A snapshot is made by sequence::get_event_snapshot() while it holds the
+ *  sequence lock, and is never changed afterward.  The views iterate over
+ *  it with their own index, without any lock, so that any number of views
+ *  can draw at the same time while the output thread plays the sequence
+ *  and recording changes its events.  The sequence keeps handing out the
+ *  same snapshot until its events change; a view holding an older snapshot
+ *  keeps it alive through the shared pointer until it is done.
+ *
+ *  The copied events are not linked to each other, since a link would
+ *  point into the live event list.  The snapshot keeps the time of the
+ *  linked event of each event instead.
+ */
+
+#include <memory>                       /* std::shared_ptr                  */
+#include <vector>                       /* std::vector of copied events     */
+
+#include "event_list.hpp"               /* seq64::event_list, seq64::event  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Provides a set of methods for drawing certain items.  These values are
+ *  used in the sequence, seqroll, perfroll, and mainwid classes.
+ */
+
+enum draw_type_t
+{
+    DRAW_FIN = 0,           /**< Indicates that drawing is finished.        */
+    DRAW_NORMAL_LINKED,     /**< Used for drawing linked notes.             */
+    DRAW_NOTE_ON,           /**< For starting the drawing of a note.        */
+    DRAW_NOTE_OFF,          /**< For finishing the drawing of a note.       */
+    DRAW_TEMPO              /**< For drawing tempo meta events.             */
+};
+
+/**
+ *  An immutable copy of the events of a sequence, tagged with the version
+ *  of the sequence it was copied from.
+ */
+
+class event_snapshot
+{
+
+private:
+
+    /**
+     *  The sequence::generation() value when the copy was made.
+     */
+
+    unsigned long m_generation;
+
+    /**
+     *  The event_list::revision() value when the copy was made.
+     */
+
+    unsigned m_revision;
+
+    /**
+     *  The count of in-place event changes, such as selection, kept by the
+     *  sequence, when the copy was made.
+     */
+
+    unsigned long m_serial;
+
+    /**
+     *  The length of the sequence when the copy was made.  Tempo lines
+     *  without a following tempo event end here.
+     */
+
+    midipulse m_length;
+
+    /**
+     *  The copies of the events, in time order.
+     */
+
+    std::vector<event> m_events;
+
+    /**
+     *  For each event, the time of the event linked to it, or -1 if it is
+     *  not linked.
+     */
+
+    std::vector<midipulse> m_link_ticks;
+
+public:
+
+    event_snapshot
+    (
+        const event_list & events, midipulse length,
+        unsigned long generation, unsigned long serial
+    );
+
+    /**
+     * \return
+     *      Returns true if the snapshot was copied from the given version of
+     *      a sequence.
+     */
+
+    bool matches
+    (
+        unsigned long generation, unsigned revision,
+        unsigned long serial, midipulse length
+    ) const
+    {
+        return m_generation == generation && m_revision == revision &&
+            m_serial == serial && m_length == length;
+    }
+
+    /**
+     * \getter m_events.size()
+     */
+
+    int count () const
+    {
+        return int(m_events.size());
+    }
+
+    /**
+     * \getter m_length
+     */
+
+    midipulse get_length () const
+    {
+        return m_length;
+    }
+
+    /**
+     * \param index
+     *      The index of the event, from 0 to count() - 1.
+     *
+     * \return
+     *      Returns the copy of the event at the given index.
+     */
+
+    const event & get_event (int index) const
+    {
+        return m_events[index];
+    }
+
+    /**
+     * \param index
+     *      The index of the event, from 0 to count() - 1.
+     *
+     * \return
+     *      Returns the time of the event linked to the given event, or -1
+     *      if the event is not linked.
+     */
+
+    midipulse link_tick (int index) const
+    {
+        return m_link_ticks[index];
+    }
+
+    draw_type_t next_note_event
+    (
+        int & index, midipulse & tick_s, midipulse & tick_f,
+        int & note, bool & selected, int & velocity
+    ) const;
+    bool next_event
+    (
+        int & index, midibyte status, midibyte cc,
+        int evtype = EVENTS_ALL
+    ) const;
+
+};
+
+/**
+ *  A shared pointer to a snapshot, which stays valid after the sequence
+ *  makes a newer one.
+ */
+
+typedef std::shared_ptr<const event_snapshot> event_snapshot_ptr;
+
+}           // namespace seq64
+
+#endif      // SEQ64_EVENT_SNAPSHOT_HPP
+
+/*
+ * event_snapshot.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
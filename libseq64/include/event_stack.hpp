@@ -0,0 +1,177 @@
+#ifndef SEQ64_EVENT_STACK_HPP
+#define SEQ64_EVENT_STACK_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_stack.hpp
+ *
+ *  This module declares a stack of event lists for the undo and redo
+ *  facility of the sequence class.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The sequence class used to keep its undo and redo history in an
+ *  std::stack<event_list>, so that every edit copied the whole pattern, and
+ *  the history grew without bound.  The event_stack offers the same
+ *  push()/pop()/top() interface, but only the top of the stack is a full
+ *  event list.  Each older entry is stored as the difference from the entry
+ *  above it:  the range of events the edit changed, found by trimming the
+ *  events the two lists have in common at the start and at the end.  The
+ *  memory used by these differences can be capped; the oldest entries are
+ *  then forgotten.
+ *
+ *  Finding the changed range costs push() a walk of both lists, O(n) event
+ *  comparisons, even for an edit of one event.  The callers (the many
+ *  editing functions of sequence, and sequence_edit) do not pass the range
+ *  they changed, and some of them (quantizing, moving, pasting) change it
+ *  in places that would be hard to track.  The walk makes no allocations,
+ *  and replaces the copy of the whole list that every push used to make,
+ *  which was O(n) as well; tests/event_stack_check.cpp checks it and times
+ *  it for the container the library is built with.
+ */
+
+#include <deque>                        /* std::deque of the deltas     */
+#include <vector>                       /* std::vector of the events    */
+
+#include "event_list.hpp"               /* seq64::event_list            */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  A stack of event lists that stores only the changes between adjacent
+ *  entries.
+ */
+
+class event_stack
+{
+
+private:
+
+    /**
+     *  Holds the difference between one entry of the stack and the entry
+     *  above it.  Applied to the upper entry, it replaces the events after
+     *  the first ud_prefix events, up to the last ud_suffix events, with
+     *  ud_events, which yields the lower entry.
+     */
+
+    typedef struct
+    {
+        std::size_t ud_prefix;          /**< Leading events in common.      */
+        std::size_t ud_suffix;          /**< Trailing events in common.     */
+        std::vector<event> ud_events;   /**< The events in between.         */
+
+    } undo_delta;
+
+    /**
+     *  The deltas, oldest first.  The delta at the back leads from m_top to
+     *  the entry below it.
+     */
+
+    std::deque<undo_delta> m_deltas;
+
+    /**
+     *  The entry at the top of the stack, stored in full.
+     */
+
+    event_list m_top;
+
+    /**
+     *  Indicates that m_top holds an entry, as opposed to the stack being
+     *  empty.
+     */
+
+    bool m_has_top;
+
+    /**
+     *  An estimate of the bytes used by the deltas.
+     */
+
+    std::size_t m_bytes;
+
+    /**
+     *  The maximum number of bytes the deltas can use, or 0 for no limit.
+     *  The top entry is not counted.
+     */
+
+    std::size_t m_limit;
+
+public:
+
+    event_stack ();
+
+    /**
+     * \getter m_has_top
+     *      Returns true if the stack is empty, as std::stack::empty() does.
+     */
+
+    bool empty () const
+    {
+        return ! m_has_top;
+    }
+
+    /**
+     *  Returns the number of entries in the stack.
+     */
+
+    std::size_t size () const
+    {
+        return m_has_top ? m_deltas.size() + 1 : 0 ;
+    }
+
+    /**
+     * \getter m_top
+     *      Must not be called if the stack is empty.
+     */
+
+    const event_list & top () const
+    {
+        return m_top;
+    }
+
+    void push (const event_list & events);
+    void pop ();
+    void clear ();
+    void limit (int kilobytes);
+
+private:
+
+    static std::size_t cost (const undo_delta & ud);
+    void trim ();
+
+};          // class event_stack
+
+}           // namespace seq64
+
+#endif      // SEQ64_EVENT_STACK_HPP
+
+/*
+ * event_stack.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
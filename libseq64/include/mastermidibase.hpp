@@ -36,13 +36,31 @@
  *  PortMidi.
  */
 
+#include <atomic>                       /* std::atomic<> input statistics   */
 #include <vector>                       /* for channel-filtered recording   */
 
 #include "businfo.hpp"                  /* seq64::businfo & busarray        */
 #include "midibus_common.hpp"
 #include "mutex.hpp"
+#include "ringbuffer.hpp"               /* seq64::ringbuffer output batch   */
 #include "user_midi_bus.hpp"
 
+/**
+ *  The number of channel messages that the output batch of the master buss
+ *  can hold.  If a frame of playback produces more messages than this, the
+ *  batch is simply flushed early.
+ */
+
+#define SEQ64_OUTPUT_BATCH_MAX          2048
+
+/**
+ *  The longest time the input thread waits for input before checking
+ *  whether it should exit, in milliseconds.  Matches the poll() timeout of
+ *  the ALSA implementation.
+ */
+
+#define SEQ64_INPUT_WAIT_MS             1000
+
 /*
  *  Do not document a namespace; it breaks Doxygen.
  */
@@ -53,6 +71,37 @@ namespace seq64
     class midibus;
     class sequence;
 
+/**
+ *  A MIDI channel message packed for the output batch of the master buss.
+ *  See mastermidibase::post().
+ */
+
+struct batch_message
+{
+    bussbyte bm_bus;                /**< The output buss to play it on.     */
+    midibyte bm_status;             /**< Status, without the channel.       */
+    midibyte bm_channel;            /**< The channel to play it on.         */
+    midibyte bm_d0;                 /**< First data byte.                   */
+    midibyte bm_d1;                 /**< Second data byte.                  */
+    midipulse bm_late;              /**< Lateness, for scheduled output.    */
+};
+
+/**
+ *  A channel message captured, instead of played, while the song is
+ *  rendered offline.  See mastermidibase::capture_output() and
+ *  perform::render_song().
+ */
+
+struct render_message
+{
+    midipulse rm_tick;              /**< The tick it was due at.            */
+    bussbyte rm_bus;                /**< The output buss it was played on.  */
+    midibyte rm_status;             /**< Status, including the channel.     */
+    midibyte rm_d0;                 /**< First data byte.                   */
+    midibyte rm_d1;                 /**< Second data byte, if any.          */
+    midibyte rm_size;               /**< Message size, 2 or 3 bytes.        */
+};
+
 /**
  *  The class that "supervises" all of the midibus objects?
  */
@@ -113,6 +162,21 @@ protected:
 
     int m_queue;
 
+    /**
+     *  If true, the output busses are in the scheduled mode:  each played
+     *  event is stamped to be delivered by the API's queue m_lookahead_ms
+     *  after it was due, rather than sent directly.  Set by api_init() in
+     *  the implementations that support it (currently ALSA only).
+     */
+
+    bool m_scheduled_output;
+
+    /**
+     *  The lookahead used in the scheduled-output mode, in milliseconds.
+     */
+
+    int m_lookahead_ms;
+
     /**
      *  Resolution in parts per quarter note.
      */
@@ -155,6 +219,65 @@ protected:
 
     sequence * m_seq;
 
+    /**
+     *  Holds the channel messages played by the sequences during one call
+     *  of perform::play().  The output thread appends to it with post(),
+     *  without locking, and flush() sends the whole batch to the busses
+     *  under a single lock of m_mutex.  Any thread can flush(); the mutex
+     *  makes the flushing threads a single consumer.
+     */
+
+    ringbuffer<batch_message> m_output_batch;
+
+    /**
+     *  If not null, the played channel messages are appended to this vector
+     *  instead of being sent to the busses.  Used for the offline rendering
+     *  of the song.
+     */
+
+    std::vector<render_message> * m_render;
+
+    /**
+     *  The tick of the frame being rendered.  A captured message is stamped
+     *  with this tick, minus its lateness.
+     */
+
+    midipulse m_render_tick;
+
+    /**
+     *  The number of channel messages sent to the busses, for the events
+     *  per frame of the output statistics.  Written under m_mutex.
+     */
+
+    std::atomic<long> m_events_sent;
+
+    /**
+     *  Wakes the input thread when input arrives.  Signalled directly by
+     *  the implementations that receive input in a callback (currently
+     *  JACK), so that their api_poll_for_midi() can block on it instead of
+     *  sleeping and polling.
+     */
+
+    wakeup_event m_input_wakeup;
+
+    /**
+     *  The time the input being handled was signalled, in
+     *  wakeup_event::now_us() microseconds, or 0.  Used only by the input
+     *  thread.
+     */
+
+    std::int64_t m_input_arrival_us;
+
+    /**
+     *  The number of signalled input batches handled, and the total and
+     *  maximum time from the signal to the end of the handling, in
+     *  microseconds.  Written only by the input thread.
+     */
+
+    std::atomic<long> m_input_batches;
+    std::atomic<std::int64_t> m_input_total_us;
+    std::atomic<std::int64_t> m_input_max_us;
+
     /**
      *  The locking mutex.  This object is passed to an automutex object that
      *  lends exception-safety to the mutex locking.
@@ -276,13 +399,29 @@ public:
     void stop ();
     void port_start (int client, int port);
     void port_exit (int client, int port);
-    void play (bussbyte bus, event * e24, midibyte channel);
+    void play (bussbyte bus, event * e24, midibyte channel, midipulse late = 0);
+    void post
+    (
+        bussbyte bus, const event & ev, midibyte channel, midipulse late = 0
+    );
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void emit_clock (midipulse tick);
     void sysex (event * event);
     void print () const;
     void flush ();
+    void capture_output (std::vector<render_message> * messages);
+
+    /**
+     * \setter m_render_tick
+     *      Called before each frame of an offline render.
+     */
+
+    void capture_tick (midipulse tick)
+    {
+        m_render_tick = tick;
+    }
+
     void set_sequence_input (bool state, sequence * seq);
     void dump_midi_input (event in);                    /* seq32 function */
     bool initialize_buses ();
@@ -293,6 +432,65 @@ public:
     int poll_for_midi ();
     bool is_more_input ();
     bool get_midi_event (event * in);
+    void input_handled ();
+
+    /**
+     * \getter m_input_wakeup
+     *      Provides the wakeup that an input callback signals.
+     */
+
+    wakeup_event & input_wakeup ()
+    {
+        return m_input_wakeup;
+    }
+
+    /**
+     *  Wakes the input thread, so that it can notice it is to exit.
+     */
+
+    void wake_input ()
+    {
+        m_input_wakeup.signal();
+    }
+
+    /**
+     * \getter m_input_batches
+     */
+
+    long input_batches () const
+    {
+        return m_input_batches.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \getter m_input_total_us / m_input_batches
+     */
+
+    std::int64_t input_latency_avg_us () const
+    {
+        long batches = input_batches();
+        return batches > 0 ?
+            m_input_total_us.load(std::memory_order_relaxed) / batches :
+            0 ;
+    }
+
+    /**
+     * \getter m_input_max_us
+     */
+
+    std::int64_t input_latency_max_us () const
+    {
+        return m_input_max_us.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \getter m_events_sent
+     */
+
+    long events_sent () const
+    {
+        return m_events_sent.load(std::memory_order_relaxed);
+    }
 
     bool set_clock (bussbyte bus, clock_e clock_type);
     bool set_input (bussbyte bus, bool inputing);
@@ -302,6 +500,7 @@ public:
 
     void set_ppqn (int ppqn);
     void set_beats_per_minute (midibpm bpm);
+    midipulse output_latency_ticks () const;
 
 protected:
 
@@ -417,6 +616,20 @@ protected:
         // no code for base, alsmidi, or portmidi
     }
 
+    /**
+     *  Provides the delay that the MIDI API adds to every output message,
+     *  for the output_latency_ticks() function.
+     *
+     * \return
+     *      Returns the delay in microseconds, 0 if the API sends the
+     *      messages right away.
+     */
+
+    virtual long api_output_latency_us () const
+    {
+        return 0;                       // no delay for base, alsa, portmidi
+    }
+
     virtual void api_port_start (int /* client */, int /* port */)
     {
         // no code for portmidi
@@ -441,6 +654,12 @@ private:
 
     bool save_clock (bussbyte bus, clock_e clock);
     bool save_input (bussbyte bus, bool inputing);
+    void play_event
+    (
+        bussbyte bus, event * e24, midibyte channel, midipulse late
+    );
+    void play_batch ();
+    midipulse lookahead_ticks () const;
 #if 0
     void swap ();
 #endif
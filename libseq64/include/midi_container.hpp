@@ -209,6 +209,25 @@ const midilong c_reserved_1  =  0x24240018; /**< Reserved for expansion.    */
 const midilong c_reserved_2  =  0x24240019; /**< Reserved for expansion.    */
 const midilong c_tempo_track =  0x2424001A; /**< Reserved for expansion.    */
 
+/**
+ *  The values of the performance that midi_container::fill() writes to the
+ *  first track as the Time Signature and Set Tempo events.  Copying them
+ *  lets a track be filled on a thread that must not read the performance,
+ *  as the autosave thread does.
+ */
+
+struct track_timing
+{
+    int tt_beats_per_bar;               /**< Time signature numerator.      */
+    int tt_beat_width;                  /**< Time signature denominator.    */
+    int tt_clocks_per_metronome;        /**< MIDI clocks per click.         */
+    int tt_32nds_per_quarter;           /**< 32nd notes per quarter note.   */
+    long tt_us_per_quarter_note;        /**< The tempo, in microseconds.    */
+
+    track_timing ();
+    explicit track_timing (const perform & p);
+};
+
 /**
  *    This class is the abstract base class for a container of MIDI track
  *    information.  It is the base class for midi_list and midi_vector.
@@ -248,6 +267,7 @@ public:
     }
 
     void fill (int tracknumber, const perform & p);
+    void fill (int tracknumber, const track_timing & tt);
 
     /**
      *  Returns the size of the container, in midibytes.  Must be overridden
@@ -336,12 +356,12 @@ private:
     void fill_proprietary ();
     void fill_time_sig_and_tempo
     (
-        const perform & p,
+        const track_timing & tt,
         bool has_time_sig = false,
         bool has_tempo    = false
     );
-    void fill_time_sig (const perform & p);
-    void fill_tempo (const perform & p);
+    void fill_time_sig (const track_timing & tt);
+    void fill_tempo (const track_timing & tt);
     midipulse song_fill_seq_event
     (
         const trigger & trig, midipulse prev_timestamp
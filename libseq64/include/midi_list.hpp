@@ -61,8 +61,7 @@ class midi_list : public midi_container
 private:
 
     /**
-     *  Provides the type of this container.  This type is basically the same
-     *  as the midifile::m_char_list container in the midifile module.
+     *  Provides the type of this container.
      */
 
     typedef std::list<midibyte> CharList;
@@ -476,12 +476,15 @@ public:
     bool deinit_in ();
     bool init_out_sub ();
     bool init_in_sub ();
-    void play (event * e24, midibyte channel);
+    void play
+    (
+        event * e24, midibyte channel, midipulse delay = SEQ64_NULL_MIDIPULSE
+    );
     void sysex (event * e24);
     void flush ();
     void start ();
     void stop ();
-    void clock (midipulse tick);
+    void clock (midipulse tick, midipulse ahead = SEQ64_NULL_MIDIPULSE);
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void print ();
@@ -576,6 +579,19 @@ protected:
 
     virtual void api_play (event * e24, midibyte channel) = 0;
 
+    /**
+     *  Plays the event through the API's queue, \a delay ticks from now.
+     *  Implementations without a usable queue send the event directly.
+     */
+
+    virtual void api_play_scheduled
+    (
+        event * e24, midibyte channel, midipulse /* delay */
+    )
+    {
+        api_play(e24, channel);
+    }
+
     /**
      *  Handles implementation details for SysEx messages.
      *
@@ -605,6 +621,16 @@ protected:
     virtual void api_stop () = 0;
     virtual void api_clock (midipulse tick) = 0;
 
+    /**
+     *  Sends a MIDI clock through the API's queue, \a delay ticks from now.
+     *  Implementations without a usable queue send the clock directly.
+     */
+
+    virtual void api_clock_scheduled (midipulse tick, midipulse /* delay */)
+    {
+        api_clock(tick);
+    }
+
 };          // class midibase (ALSA version)
 
 /*
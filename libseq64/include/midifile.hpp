@@ -44,7 +44,6 @@
  */
 
 #include <string>
-#include <list>
 #include <vector>
 
 #include "globals.h"                    /* SEQ64_USE_DEFAULT_PPQN       */
@@ -67,12 +66,10 @@
 namespace seq64
 {
     class perform;                      /* forward reference            */
+    struct render_message;              /* forward reference            */
+    struct song_snapshot;               /* forward reference            */
 
-#if defined SEQ64_USE_MIDI_VECTOR
-    class midi_vector;
-#else
-    class midi_list;
-#endif
+    class midi_container;               /* forward reference            */
 
 /**
  *  This class handles the parsing and writing of MIDI files.  In addition to
@@ -138,24 +135,39 @@ private:
     const std::string m_name;
 
     /**
-     *  This vector of characters holds our MIDI data.  We could also use
-     *  a string of characters, unsigned.  This member is resized to the
-     *  putative size of the MIDI file, in the parse() function.  Then the
-     *  whole file is read into it, as if it were an array.  This member is an
-     *  input buffer.
+     *  Points to the MIDI data being parsed, m_file_size bytes of it.  On
+     *  POSIX systems, the parse() function maps the file into memory, and
+     *  the data is read directly from the mapping, without a copy.
+     *  Otherwise, or if the mapping fails, it points to m_file_data.  This
+     *  member is valid only during parse().
+     */
+
+    const midibyte * m_data;
+
+    /**
+     *  This vector of characters holds our MIDI data if the file could not
+     *  be mapped.  This member is resized to the putative size of the MIDI
+     *  file, in the read_data() function.  Then the whole file is read into
+     *  it, as if it were an array.  This member is an input buffer.
      */
 
-    std::vector<midibyte> m_data;
+    std::vector<midibyte> m_file_data;
 
     /**
-     *  Provides a list of characters.  The class pushes each MIDI byte into
-     *  this list using the write_byte() function.  Also note that the write()
-     *  function calls sequence::fill_list() to fill a temporary
-     *  std::list<char> (!) buffer, then writes that data <i> backwards </i> to
-     *  this member.  This member is an output buffer.
+     *  The start of the memory mapping of the file, or a null pointer if the
+     *  file is not mapped.
      */
 
-    std::list<midibyte> m_char_list;
+    void * m_mapping;
+
+    /**
+     *  Provides a contiguous buffer of characters.  The class appends each
+     *  MIDI byte to this buffer using the write_byte() function, and
+     *  write_file() then writes the whole buffer to the file in one call.
+     *  This member is an output buffer.
+     */
+
+    std::vector<midibyte> m_char_vector;
 
     /**
      *  Use the new format for the proprietary footer section of the Seq24
@@ -218,6 +230,13 @@ public:
     bool write_song (perform & p);
 #endif
 
+    bool write_render
+    (
+        perform & p, const std::vector<render_message> & messages
+    );
+    void take_snapshot (perform & p, song_snapshot & ss);
+    bool write_snapshot (song_snapshot & ss);
+
     /**
      * \getter m_error_message
      */
@@ -252,6 +271,9 @@ public:
 
 private:
 
+    bool open_data ();
+    bool read_data ();
+    void close_data ();
     bool parse_smf_0 (perform & p, int screenset);
     bool parse_smf_1 (perform & p, int screenset, bool is_smf0 = false);
     midilong parse_prop_header (int file_size);
@@ -284,8 +306,8 @@ private:
     }
 
     /**
-     *  Writes 1 byte.  The byte is written to the m_char_list member, using a
-     *  call to push_back().
+     *  Writes 1 byte.  The byte is appended to the m_char_vector member,
+     *  using a call to push_back().
      *
      * \param c
      *      The MIDI byte to be "written".
@@ -293,7 +315,7 @@ private:
 
     void write_byte (midibyte c)
     {
-        m_char_list.push_back(c);
+        m_char_vector.push_back(c);
     }
 
     void write_varinum (midilong);
@@ -312,14 +334,9 @@ private:
     long track_name_size (const std::string & trackname) const;
     void errdump (const std::string & msg);
     void errdump (const std::string & msg, unsigned long p);
-    void write_track
-    (
-#if defined SEQ64_USE_MIDI_VECTOR
-        const midi_vector & lst
-#else
-        const midi_list & lst
-#endif
-    );
+    void write_track (const midi_container & lst);
+    bool write_file (const std::string & action);
+    bool write_file_synced (const std::string & action);
 
     /**
      *  Returns the size of a sequence-number event, which is always 5
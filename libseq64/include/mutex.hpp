@@ -37,8 +37,12 @@
  *          easily.
  *      -   seq64::condition_var.  Provides a common usage paradigm, for the
  *          perform object.
+ *      -   seq64::wakeup_event.  Lets a real-time thread wake a waiting
+ *          thread without locking.
  */
 
+#include <atomic>
+#include <cstdint>                      /* std::int64_t                     */
 #include <pthread.h>
 
 /*
@@ -161,6 +165,54 @@ public:
     condition_var ();
     void wait ();
     void signal ();
+    void broadcast ();
+
+};
+
+/**
+ *  A wakeup flag that one thread can wait on, and that another thread,
+ *  including a real-time one such as the JACK process callback, can set
+ *  without taking a lock.  On Linux it is an eventfd, so signal() is a
+ *  single write() and wait() a poll() with a timeout.  Elsewhere, wait()
+ *  simply sleeps for a millisecond, as the polling code used to do.
+ *
+ *  The time of the first signal() since the last take_signal_time() is
+ *  recorded, so that the waiter can measure its wakeup latency.
+ */
+
+class wakeup_event
+{
+
+private:
+
+    /**
+     *  The eventfd file descriptor, or -1 if unavailable.
+     */
+
+    int m_fd;
+
+    /**
+     *  The time of the earliest pending signal, in microseconds of
+     *  wakeup_event::now_us(), or 0 if none is pending.
+     */
+
+    std::atomic<std::int64_t> m_signal_us;
+
+private:        // do not allow these functions to be used
+
+    wakeup_event (const wakeup_event &);
+    wakeup_event & operator = (const wakeup_event &);
+
+public:
+
+    wakeup_event ();
+    ~wakeup_event ();
+
+    void signal ();
+    bool wait (int timeoutms);
+    std::int64_t take_signal_time ();
+
+    static std::int64_t now_us ();
 
 };
 
@@ -53,15 +53,18 @@
  *  handle_midi_control_ex().
  */
 
+#include <atomic>                       /* std::atomic<> play stamp         */
 #include <vector>                       /* std::vector                      */
 #include <pthread.h>                    /* pthread_t C structure            */
 
+#include "autosave.hpp"                 /* seq64::autosave background saves */
 #include "globals.h"                    /* globals, nullptr, & more         */
 #include "jack_assistant.hpp"           /* optional seq64::jack_assistant   */
 #include "gui_assistant.hpp"            /* seq64::gui_assistant             */
 #include "keys_perform.hpp"             /* seq64::keys_perform              */
 #include "mastermidibus.hpp"            /* seq64::mastermidibus for ALSA    */
 #include "midi_control.hpp"             /* seq64::midi_control "struct"     */
+#include "perfstats.hpp"                /* seq64::perfstats output timing   */
 #include "sequence.hpp"                 /* seq64::sequence                  */
 
 /**
@@ -85,6 +88,27 @@
 
 #define SEQ64_ALL_TRACKS                (-1)
 
+/**
+ *  The number of 32-bit words in each changed-sequences bitset.
+ */
+
+#define SEQ64_DIRTY_WORDS               ((c_max_sequence + 31) / 32)
+
+/**
+ *  The number of keys of the MIDI control lookup table, one for each pair of
+ *  a status byte (0x80 to 0xFF) and a first data byte (0x00 to 0x7F).
+ */
+
+#define SEQ64_MIDI_CONTROL_KEYS         (128 * 128)
+
+/**
+ *  The number of frames per beat played by perform::render_song().  The
+ *  captured messages keep their exact ticks whatever the frame size; this
+ *  value only sets how often the song-mode trigger and mute logic runs.
+ */
+
+#define SEQ64_RENDER_FRAMES_PER_BEAT    16
+
 /*
  *  All Sequencer64 library code is in the seq64 namespace.
  */
@@ -177,6 +201,7 @@ class perform
     friend class sequence;              // for setting tempo from events
     friend void * input_thread_func (void * myperf);
     friend void * output_thread_func (void * myperf);
+    friend void * play_worker_thread_func (void * myperf);
 
 #ifdef SEQ64_JACK_SUPPORT
 
@@ -428,46 +453,25 @@ private:
     bool m_seqs_active[c_max_sequence];
 
     /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status; did some process modify the sequence?
-     *  Was it's mute/unmute status changed?
+     *  The changed-sequences bitsets, one per kind of dirtiness (see
+     *  seq64::dirty_kind_t in sequence.hpp).  A sequence sets its
+     *  bits when it is marked dirty, and perform sets all of them when a
+     *  sequence is activated or deactivated.  The is_dirty_*() functions
+     *  test and clear one bit.  All of this is lock-free, so that a viewer
+     *  polling the dirtiness of many sequences never contends with the
+     *  output thread for the sequence mutexes.  These bitsets replace the
+     *  seq24 "was-active" boolean arrays.
      */
 
-    bool m_was_active_main[c_max_sequence];
+    std::atomic<unsigned> m_dirty_seqs[DIRTY_KINDS][SEQ64_DIRTY_WORDS];
 
     /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status for editing the mute/unmute status during
-     *  pattern editing.
+     *  Incremented every time any sequence is marked dirty.  A viewer that
+     *  saves the value it last saw can skip its redraw scan entirely when
+     *  the value has not changed.
      */
 
-    bool m_was_active_edit[c_max_sequence];
-
-    /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status for editing the mute/unmute status during
-     *  performance/song editing.
-     */
-
-    bool m_was_active_perf[c_max_sequence];
-
-    /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status for editing the mute/unmute status during
-     *  performance names editing.  Not sure that it serves a real purpose;
-     *  perhaps created with an eye to editing the pattern name in the song
-     *  editor?
-     */
-
-    bool m_was_active_names[c_max_sequence];
+    std::atomic<unsigned long> m_dirty_generation;
 
     /**
      *  Saves the current playing state of each pattern.
@@ -536,6 +540,66 @@ private:
 
     bool m_in_thread_launched;
 
+    /**
+     *  The worker threads that help the output thread play the patterns of
+     *  each frame.  Empty if the [output-thread] settings ask for no
+     *  workers, in which case the output thread plays them all by itself.
+     */
+
+    std::vector<pthread_t> m_play_threads;
+
+    /**
+     *  Wakes the worker threads for each frame.  Protects m_play_frame and
+     *  m_play_exit.
+     */
+
+    condition_var m_play_start;
+
+    /**
+     *  Signalled by the last worker thread to finish its part of a frame.
+     *  Protects m_play_pending.
+     */
+
+    condition_var m_play_done;
+
+    /**
+     *  Counts the frames handed to the worker threads.  A worker waits for
+     *  this value to change.
+     */
+
+    unsigned m_play_frame;
+
+    /**
+     *  Tells the worker threads to exit.
+     */
+
+    bool m_play_exit;
+
+    /**
+     *  The number of worker threads that have not finished their part of the
+     *  current frame.
+     */
+
+    int m_play_pending;
+
+    /**
+     *  The next pattern to be claimed by a thread playing the current frame.
+     */
+
+    std::atomic<int> m_play_next;
+
+    /**
+     *  The tick of the frame handed to the worker threads.
+     */
+
+    midipulse m_play_tick;
+
+    /**
+     *  The playback mode of the frame handed to the worker threads.
+     */
+
+    bool m_play_song_mode;
+
     /**
      *  Indicates that playback is running.  However, this flag is conflated
      *  with some JACK support, and we have to supplement it with another
@@ -711,6 +775,18 @@ private:
 
     mutable midipulse m_tick;
 
+    /**
+     *  The tick last given to play(), and the time at which it was played,
+     *  in wakeup_event::now_us() microseconds, so that the input thread can
+     *  convert the arrival time of a recorded event to an exact tick.  Both
+     *  are written by the output thread, under the m_play_stamp_seq
+     *  sequence lock:  the sequence is odd while they are being written.
+     */
+
+    std::atomic<unsigned> m_play_stamp_seq;
+    std::atomic<midipulse> m_play_stamp_tick;
+    std::atomic<std::int64_t> m_play_stamp_us;
+
     /**
      *  Let's try to save the last JACK pad structure tick for re-use with
      *  resume after pausing.
@@ -776,6 +852,31 @@ private:
 
     midi_control m_midi_cc_off[c_midi_controls_extended];
 
+    /**
+     *  The MIDI control lookup table.  For each key (see midi_control_key()),
+     *  the entries of m_midi_control_entries[] from m_midi_control_index[key]
+     *  up to m_midi_control_index[key + 1] are the MIDI controls that match
+     *  the key.  The last element holds the number of entries.
+     */
+
+    unsigned short m_midi_control_index[SEQ64_MIDI_CONTROL_KEYS + 1];
+
+    /**
+     *  The active MIDI controls, grouped by key.  Each entry encodes a
+     *  control number and a midi_control::action as control * 3 + action,
+     *  so that the entries of a key are in the order the controls used to be
+     *  scanned.
+     */
+
+    unsigned short m_midi_control_entries[3 * c_midi_controls_extended];
+
+    /**
+     *  Set by midi_controls_changed(), so that the input thread rebuilds the
+     *  lookup table before it handles the next MIDI control event.
+     */
+
+    std::atomic<bool> m_midi_control_stale;
+
     /**
      *  Holds the OR'ed control status values.  Need to learn more about this
      *  one.  It is used in the replace, snapshot, and queue functionality.
@@ -898,6 +999,19 @@ private:
 
     condition_var m_condition_var;
 
+    /**
+     *  The timing statistics of the output thread, always collected.  See
+     *  get_output_stats().
+     */
+
+    perfstats m_output_stats;
+
+    /**
+     *  Saves the song periodically in the background.  See poll_autosave().
+     */
+
+    autosave m_autosave;
+
 #ifdef SEQ64_JACK_SUPPORT
 
     /**
@@ -1401,6 +1515,7 @@ public:
     }
 
     unsigned short combine_bytes (midibyte b0, midibyte b1);
+    midipulse input_tick (std::int64_t arrivalus);
     void FF_rewind ();
     bool FF_RW_timeout ();          /* called by free-function of same name */
 
@@ -1536,6 +1651,43 @@ public:
     void clear_sequence_triggers (int seq);
     void print_triggers () const;
     void print_busses () const;
+    bool render_song (std::vector<render_message> & messages);
+
+    /**
+     *  Copies the timing statistics of the output thread:  wakeup lateness,
+     *  frame processing time, events per frame, MIDI clock jitter, and
+     *  missed deadlines.  Lock-free; safe to call from any thread at any
+     *  time.
+     *
+     * \param [out] s
+     *      The destination of the copy.
+     */
+
+    void get_output_stats (perfstats::snapshot & s) const
+    {
+        m_output_stats.get(s);
+    }
+
+    /**
+     *  Sets the timing statistics of the output thread back to zero.
+     */
+
+    void reset_output_stats ()
+    {
+        m_output_stats.reset();
+    }
+
+    /**
+     *  Autosaves the song in the background if the [autosave] interval has
+     *  passed and the song has unsaved changes.  Must be called about once
+     *  a second by the thread that owns the performance, such as the GUI
+     *  timer.
+     */
+
+    void poll_autosave ()
+    {
+        m_autosave.poll();
+    }
 
     /**
      *  The rough opposite of launch(); it doesn't stop the threads.  A minor
@@ -2082,6 +2234,16 @@ public:
     bool is_dirty_edit (int seq);
     bool is_dirty_perf (int seq);
     bool is_dirty_names (int seq);
+    void mark_dirty (int seq, unsigned kinds);
+
+    /**
+     * \getter m_dirty_generation
+     */
+
+    unsigned long dirty_generation () const
+    {
+        return m_dirty_generation.load(std::memory_order_acquire);
+    }
     bool is_exportable (int seq) const;
 
     void set_screenset (int ss);
@@ -2131,6 +2293,28 @@ public:
         m_seqs_in_set = seqs;
     }
 
+    midi_control & midi_control_toggle (int ctl);
+    midi_control & midi_control_on (int ctl);
+    midi_control & midi_control_off (int ctl);
+
+    /**
+     *  Tells the input thread to rebuild the MIDI control lookup table.  To
+     *  be called after the controls obtained from midi_control_toggle(),
+     *  midi_control_on(), and midi_control_off() have been modified.
+     */
+
+    void midi_controls_changed ()
+    {
+        m_midi_control_stale = true;
+    }
+
+    void midi_control_event (const event & ev);
+    int midi_control_matches
+    (
+        midibyte status, midibyte data, std::vector<int> & entries
+    );
+    bool create_master_bus ();
+
 private:
 
     /**
@@ -2209,10 +2393,6 @@ private:
         is_modified(true);
     }
 
-    midi_control & midi_control_toggle (int ctl);
-    midi_control & midi_control_on (int ctl);
-    midi_control & midi_control_off (int ctl);
-    void midi_control_event (const event & ev);
     void handle_midi_control (int control, bool state);
     bool handle_midi_control_ex (int control, midi_control::action a, int v);
     const std::string & get_screen_set_notepad (int screenset) const;
@@ -2346,6 +2526,8 @@ private:
 
     void launch_input_thread ();
     void launch_output_thread ();
+    void launch_play_workers ();
+    void stop_play_workers ();
 
     /**
      *  Initializes JACK support, if SEQ64_JACK_SUPPORT is defined.  Who calls
@@ -2429,6 +2611,31 @@ private:
         return seq < c_midi_controls_extended;
     }
 
+    /**
+     *  Provides the key of the MIDI control lookup table for a status byte
+     *  and a first data byte.
+     *
+     * \param status
+     *      The status byte, which must be 0x80 or greater.
+     *
+     * \param data
+     *      The first data byte, which must be less than 0x80.
+     *
+     * \return
+     *      Returns an index less than SEQ64_MIDI_CONTROL_KEYS.
+     */
+
+    static int midi_control_key (int status, int data)
+    {
+        return ((status - 0x80) << 7) | data;
+    }
+
+    void rebuild_midi_control_index ();
+    bool dispatch_midi_control
+    (
+        int ctl, midi_control::action a, midibyte value, int offset
+    );
+
     /**
      * \getter m_max_sets
      */
@@ -2506,6 +2713,7 @@ private:
 
     bool is_seq_valid (int seq) const;
     bool is_mseq_valid (int seq) const;
+    bool take_dirty (int seq, dirty_kind_t kind);
     bool install_sequence (sequence * seq, int seqnum);
     void inner_start (bool state);
     void inner_stop (bool midiclock = false);
@@ -2557,7 +2765,9 @@ private:
 private:
 
     bool log_current_tempo ();
-    bool create_master_bus ();
+    void play_in_parallel (midipulse tick);
+    void play_claimed_sequences ();
+    void play_worker_func ();
 
     /**
      *  Saves the clock settings read from the "rc" file so that they can be
@@ -2644,6 +2854,7 @@ private:
 
 extern void * output_thread_func (void * p);
 extern void * input_thread_func (void * p);
+extern void * play_worker_thread_func (void * p);
 
 }           // namespace seq64
 
@@ -0,0 +1,184 @@
+#ifndef SEQ64_PERFSTATS_HPP
+#define SEQ64_PERFSTATS_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          perfstats.hpp
+ *
+ *  This module declares a class for collecting timing statistics on the
+ *  output thread of a performance.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The statistics are always collected.  The output thread is the only
+ *  writer; each value costs a few atomic additions, and no lock is ever
+ *  taken, so any thread can read the statistics at any time, with
+ *  perform::get_output_stats(), without disturbing playback.  A snapshot
+ *  is consistent within each metric, but the metrics are not read
+ *  together atomically.
+ *
+ *  Each metric keeps a count, a total, a maximum, and a histogram with
+ *  power-of-two buckets:  bucket 0 counts the zero values, and bucket n
+ *  counts the values from 2^(n-1) to 2^n - 1.  The last bucket also counts
+ *  all of the larger values.
+ */
+
+#include <atomic>                       /* std::atomic<> counters           */
+#include <cstdint>                      /* std::int64_t                     */
+#include <string>                       /* std::string for the dumps        */
+
+/**
+ *  The number of buckets in the histogram of a metric.  With microseconds,
+ *  the last bucket starts at 16.384 ms.
+ */
+
+#define SEQ64_STATS_BUCKETS             16
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The values of one metric, as copied by perfstats::get().
+ */
+
+struct stats_values
+{
+    long sv_count;                          /**< The number of values.      */
+    std::int64_t sv_total;                  /**< The sum of the values.     */
+    std::int64_t sv_max;                    /**< The largest value.         */
+    long sv_buckets[SEQ64_STATS_BUCKETS];   /**< The histogram.             */
+};
+
+/**
+ *  Collects the timing statistics of the output thread.
+ */
+
+class perfstats
+{
+
+public:
+
+    /**
+     *  The metrics collected.
+     */
+
+    enum metric_t
+    {
+        LATENESS = 0,       /**< Wakeup lateness of the output thread, us.  */
+        FRAME_TIME,         /**< Time spent playing a frame, us.            */
+        FRAME_EVENTS,       /**< MIDI events sent during a frame.           */
+        CLOCK_JITTER,       /**< Error of a MIDI clock interval, us.        */
+        METRICS             /**< The number of metrics.                     */
+    };
+
+    /**
+     *  A copy of all of the statistics, for the readers.
+     */
+
+    struct snapshot
+    {
+        stats_values ss_metrics[METRICS];   /**< One entry per metric_t.    */
+        long ss_underruns;                  /**< Missed output deadlines.   */
+        std::int64_t ss_elapsed_us;         /**< Time since the last reset. */
+    };
+
+private:
+
+    /**
+     *  The atomic counters of one metric.
+     */
+
+    struct metric
+    {
+        std::atomic<long> m_count;
+        std::atomic<std::int64_t> m_total;
+        std::atomic<std::int64_t> m_max;
+        std::atomic<long> m_buckets[SEQ64_STATS_BUCKETS];
+    };
+
+    /**
+     *  The counters of all of the metrics.
+     */
+
+    metric m_metrics[METRICS];
+
+    /**
+     *  The number of output frames whose wakeup deadline had already passed
+     *  when the frame was done.
+     */
+
+    std::atomic<long> m_underruns;
+
+    /**
+     *  The time of the last reset, in wakeup_event::now_us() microseconds.
+     */
+
+    std::atomic<std::int64_t> m_reset_us;
+
+private:        // do not allow these functions to be used
+
+    perfstats (const perfstats &);
+    perfstats & operator = (const perfstats &);
+
+public:
+
+    perfstats ();
+
+    void add (metric_t which, std::int64_t value);
+
+    /**
+     *  Counts an output deadline that was missed.
+     */
+
+    void underrun ()
+    {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void reset ();
+    void get (snapshot & s) const;
+
+    static const char * name (metric_t which);
+    static std::int64_t bucket_limit (int bucket);
+    static std::int64_t average (const stats_values & sv);
+    static std::int64_t percentile (const stats_values & sv, int percent);
+    static std::string to_json (const snapshot & s, long timestamp);
+    static std::string csv_header ();
+    static std::string to_csv (const snapshot & s, long timestamp);
+
+};
+
+}           // namespace seq64
+
+#endif      // SEQ64_PERFSTATS_HPP
+
+/*
+ * perfstats.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -44,6 +44,45 @@
 
 #include "seq64_features.h"             /* SEQ64_USE_ZOOM_POWER_OF_2    */
 
+/**
+ *  Limits and default for the lookahead used by the ALSA scheduled-output
+ *  mode, in milliseconds.  The lookahead must cover the worst lateness of the
+ *  output thread, but it also delays every event by that amount.
+ */
+
+#define SEQ64_MINIMUM_LOOKAHEAD_MS        1
+#define SEQ64_DEFAULT_LOOKAHEAD_MS       10
+#define SEQ64_MAXIMUM_LOOKAHEAD_MS      500
+
+/**
+ *  The highest SCHED_FIFO priority that can be requested for the output
+ *  thread.  This is the Linux maximum.
+ */
+
+#define SEQ64_MAXIMUM_FIFO_PRIORITY      99
+
+/**
+ *  The largest number of worker threads that can help the output thread
+ *  play the patterns of a frame.
+ */
+
+#define SEQ64_MAXIMUM_PLAY_WORKERS       16
+
+/**
+ *  The default cap, in kilobytes, on the memory used by the undo history,
+ *  and again by the redo history, of each sequence.  A value of 0 removes
+ *  the cap.
+ */
+
+#define SEQ64_DEFAULT_UNDO_MEMORY_KB   8192
+
+/**
+ *  The default name of the autosave file.  A name without a directory is
+ *  taken to be in the configuration directory.
+ */
+
+#define SEQ64_DEFAULT_AUTOSAVE_FILE    "autosave.midi"
+
 /*
  *  Do not document a namespace; it breaks Doxygen.
  */
@@ -131,6 +170,13 @@ private:
     bool m_filter_by_channel;       /**< Record only sequence channel data. */
     bool m_manual_alsa_ports;       /**< [manual-alsa-ports] setting.       */
     bool m_reveal_alsa_ports;       /**< [reveal-alsa-ports] setting.       */
+    bool m_alsa_scheduled_output;   /**< [alsa-scheduled-output] setting.   */
+    int m_alsa_lookahead_ms;        /**< Scheduling lookahead, in ms.       */
+    int m_output_priority;          /**< Output thread SCHED_FIFO priority. */
+    int m_output_cpu;               /**< Output thread CPU, or -1 for any.  */
+    int m_play_workers;             /**< Pattern-playing worker threads.    */
+    int m_undo_memory_kb;           /**< Undo history cap, 0 for no cap.    */
+    int m_autosave_interval;        /**< Autosave period in s, 0 for none.  */
     bool m_print_keys;              /**< Show hot-key in main window slot.  */
     bool m_device_ignore;           /**< From seq24 module, unused!         */
     int m_device_ignore_num;        /**< From seq24 module, unused!         */
@@ -156,6 +202,13 @@ private:
 
     std::string m_last_used_dir;
 
+    /**
+     *  Holds the name of the file that the song is autosaved to.  See
+     *  autosave_filespec().
+     */
+
+    std::string m_autosave_filename;
+
     /**
      *  Holds the current "rc" and "user" configuration directory.  This value
      *  is "~/.config/sequencer64" by default.
@@ -221,6 +274,7 @@ public:
 
     std::string config_filespec () const;
     std::string user_filespec () const;
+    std::string autosave_filespec () const;
     void set_defaults ();
 
     /**
@@ -390,6 +444,74 @@ public:
         return m_reveal_alsa_ports;
     }
 
+    /**
+     * \getter m_alsa_scheduled_output
+     */
+
+    bool alsa_scheduled_output () const
+    {
+        return m_alsa_scheduled_output;
+    }
+
+    /**
+     * \getter m_alsa_lookahead_ms
+     */
+
+    int alsa_lookahead_ms () const
+    {
+        return m_alsa_lookahead_ms;
+    }
+
+    /**
+     * \getter m_output_priority
+     *      A value of 0 means that the output thread uses the normal
+     *      scheduler, unless the --priority option is in force.
+     */
+
+    int output_priority () const
+    {
+        return m_output_priority;
+    }
+
+    /**
+     * \getter m_output_cpu
+     */
+
+    int output_cpu () const
+    {
+        return m_output_cpu;
+    }
+
+    /**
+     * \getter m_play_workers
+     *      A value of 0 means that the output thread plays all of the
+     *      patterns by itself.
+     */
+
+    int play_workers () const
+    {
+        return m_play_workers;
+    }
+
+    /**
+     * \getter m_undo_memory_kb
+     */
+
+    int undo_memory_kb () const
+    {
+        return m_undo_memory_kb;
+    }
+
+    /**
+     * \getter m_autosave_interval
+     *      A value of 0 means that the song is not autosaved.
+     */
+
+    int autosave_interval () const
+    {
+        return m_autosave_interval;
+    }
+
     /**
      * \getter m_print_keys
      */
@@ -466,6 +588,15 @@ public:
 
     void last_used_dir (const std::string & value);
 
+    /**
+     * \getter m_autosave_filename
+     */
+
+    const std::string & autosave_filename () const
+    {
+        return m_autosave_filename;
+    }
+
     /**
      * \getter m_config_directory
      */
@@ -672,6 +803,40 @@ protected:
         m_reveal_alsa_ports = flag;
     }
 
+    /**
+     * \setter m_alsa_scheduled_output
+     */
+
+    void alsa_scheduled_output (bool flag)
+    {
+        m_alsa_scheduled_output = flag;
+    }
+
+    void alsa_lookahead_ms (int ms);
+    void output_priority (int priority);
+    void output_cpu (int cpu);
+    void play_workers (int count);
+
+    /**
+     * \setter m_undo_memory_kb
+     *      Negative values are taken as 0, which means "no cap".
+     */
+
+    void undo_memory_kb (int kb)
+    {
+        m_undo_memory_kb = kb > 0 ? kb : 0 ;
+    }
+
+    /**
+     * \setter m_autosave_interval
+     *      Negative values are taken as 0, which turns autosaving off.
+     */
+
+    void autosave_interval (int seconds)
+    {
+        m_autosave_interval = seconds > 0 ? seconds : 0 ;
+    }
+
     /**
      * \setter m_print_keys
      */
@@ -700,6 +865,7 @@ protected:
     bool interaction_method (interaction_method_t value);
     bool mute_group_saving (mute_group_handling_t mgh);
     void jack_session_uuid (const std::string & value);
+    void autosave_filename (const std::string & value);
     void config_directory (const std::string & value);
     void set_config_files (const std::string & value);
     void config_filename (const std::string & value);
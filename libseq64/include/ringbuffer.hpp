@@ -0,0 +1,232 @@
+#ifndef SEQ64_RINGBUFFER_HPP
+#define SEQ64_RINGBUFFER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          ringbuffer.hpp
+ *
+ *  This module declares/defines a small fixed-capacity ring buffer.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  This module defines the following class template:
+ *
+ *      -   seq64::ringbuffer.  A wait-free single-producer/single-consumer
+ *          queue of fixed capacity.  The producer and the consumer may run
+ *          in different threads without any locking.  Several consumers
+ *          can share one ringbuffer only if they serialize their calls to
+ *          pop() and front() with a mutex of their own.
+ */
+
+#include <atomic>
+#include <vector>
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  A fixed-capacity ring buffer for one producer thread and one consumer
+ *  thread.  The storage is allocated once by the constructor, so that
+ *  push() and pop() never allocate.  One slot is always kept empty to tell
+ *  a full ring from an empty one.
+ */
+
+template <typename T>
+class ringbuffer
+{
+
+private:
+
+    /**
+     *  The storage for the items, of size capacity + 1.
+     */
+
+    std::vector<T> m_items;
+
+    /**
+     *  The index of the next item to be read.  Written only by the consumer.
+     */
+
+    std::atomic<std::size_t> m_head;
+
+    /**
+     *  The index of the next slot to be written.  Written only by the
+     *  producer.
+     */
+
+    std::atomic<std::size_t> m_tail;
+
+private:        // do not allow these functions to be used
+
+    ringbuffer (const ringbuffer &);
+    ringbuffer & operator = (const ringbuffer &);
+
+public:
+
+    /**
+     *  Allocates the storage of the ring.
+     *
+     * \param capacity
+     *      The maximum number of items the ring can hold.
+     */
+
+    ringbuffer (std::size_t capacity)
+     :
+        m_items     (capacity + 1),
+        m_head      (0),
+        m_tail      (0)
+    {
+        // Empty body
+    }
+
+    /**
+     * \getter m_items.size() - 1
+     */
+
+    std::size_t capacity () const
+    {
+        return m_items.size() - 1;
+    }
+
+    /**
+     *  Checks for items to read.  Meant for the consumer.
+     */
+
+    bool empty () const
+    {
+        return m_head.load(std::memory_order_relaxed) ==
+            m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     *  Counts the items that can be read.  Exact for the consumer; for the
+     *  producer it can only be an overestimate.
+     */
+
+    std::size_t count () const
+    {
+        std::size_t head = m_head.load(std::memory_order_acquire);
+        std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : m_items.size() - head + tail ;
+    }
+
+    /**
+     *  Appends an item.  Called only by the producer.
+     *
+     * \param item
+     *      The item to be copied into the ring.
+     *
+     * \return
+     *      Returns false if the ring is full, in which case the item is not
+     *      added.
+     */
+
+    bool push (const T & item)
+    {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t next = tail + 1;
+        if (next == m_items.size())
+            next = 0;
+
+        if (next == m_head.load(std::memory_order_acquire))
+            return false;                               /* ring is full     */
+
+        m_items[tail] = item;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     *  Appends a number of items, all or none of them.  Called only by the
+     *  producer.
+     *
+     * \param items
+     *      Points to the items to be copied into the ring.
+     *
+     * \param count
+     *      The number of items to copy.
+     *
+     * \return
+     *      Returns false if the ring does not have room for all of the items,
+     *      in which case none of them are added.
+     */
+
+    bool push (const T * items, std::size_t count)
+    {
+        std::size_t size = m_items.size();
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t head = m_head.load(std::memory_order_acquire);
+        std::size_t used = tail >= head ? tail - head : size - head + tail ;
+        if (count > size - 1 - used)
+            return false;                               /* not enough room  */
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_items[tail] = items[i];
+            if (++tail == size)
+                tail = 0;
+        }
+        m_tail.store(tail, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     *  Provides the oldest item.  Called only by the consumer, and only if
+     *  empty() returned false.
+     */
+
+    const T & front () const
+    {
+        return m_items[m_head.load(std::memory_order_relaxed)];
+    }
+
+    /**
+     *  Removes the oldest item.  Called only by the consumer, and only if
+     *  empty() returned false.
+     */
+
+    void pop ()
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed) + 1;
+        if (head == m_items.size())
+            head = 0;
+
+        m_head.store(head, std::memory_order_release);
+    }
+
+};          // class ringbuffer
+
+}           // namespace seq64
+
+#endif      // SEQ64_RINGBUFFER_HPP
+
+/*
+ * ringbuffer.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -290,12 +290,16 @@
 #define SEQ64_SOLID_PIANOROLL_GRID
 
 /**
- *  An option we've preserved from Seq24, but have disabled until we find a
- *  need for it, is to tally some "statistics" about recording and playback.
+ * \obsolete
+ *      The timing statistics of the output thread are now always collected;
+ *      see the perfstats class.
+ *
+ *  An option we've preserved from Seq24 was to tally some "statistics"
+ *  about recording and playback.
+ *
+ *      #undef  SEQ64_STATISTICS_SUPPORT
  */
 
-#undef  SEQ64_STATISTICS_SUPPORT
-
 /**
  *  Provides additional sequence menu entries from Seq32 that we think are
  *  pretty useful no matter what.  Now a permanent option.
@@ -331,7 +335,27 @@
  * pattern slot.  They play fine, though.  Still exploring this issue.
  */
 
+#ifndef SEQ64_EVENT_CONTAINER_CHOSEN
 #undef  SEQ64_USE_EVENT_MAP             /* the map seems to work well!  */
+#endif
+
+/**
+ *  An alternative to both the list and the multimap:  a sorted, contiguous
+ *  std::vector of events.  Playback and drawing then scan the events without
+ *  chasing list nodes through memory, at the cost of moving the later events
+ *  on each insertion or removal, and of rebuilding the note links after it.
+ *  Do not define it together with SEQ64_USE_EVENT_MAP.  Still experimental,
+ *  so it is not defined by default.
+ *
+ *  A build that defines SEQ64_EVENT_CONTAINER_CHOSEN picks the container
+ *  itself, by defining one of these two macros, or neither, on the command
+ *  line, such as in the CPPFLAGS given to "configure".  The whole tree must
+ *  then be built with the same flags.  See tests/event_list_bench.cpp.
+ */
+
+#ifndef SEQ64_EVENT_CONTAINER_CHOSEN
+#undef  SEQ64_USE_EVENT_VECTOR
+#endif
 
 /**
  *  Determins which implementation of a MIDI byte container is used.
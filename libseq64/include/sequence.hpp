@@ -38,18 +38,50 @@
  *  module, and now just call its member functions to do the actual work.
  */
 
+#include <atomic>                       /* std::atomic<> dirty flag  */
+#include <memory>                       /* std::shared_ptr summary   */
 #include <string>
-#include <stack>
+#include <vector>                       /* std::vector of deferred output */
 
 #include "seq64_features.h"             /* various feature #defines */
 #include "calculations.hpp"             /* measures_to_ticks()      */
 #include "event_list.hpp"               /* seq64::event_list        */
+#include "event_snapshot.hpp"           /* seq64::event_snapshot    */
+#include "event_stack.hpp"              /* seq64::event_stack       */
+#include "mastermidibase.hpp"           /* seq64::batch_message     */
 #include "midi_container.hpp"           /* seq64::midi_container    */
 #include "midibus.hpp"                  /* seq64::midibus           */
 #include "mutex.hpp"                    /* seq64::mutex, automutex  */
 #include "scales.h"                     /* key and scale constants  */
 #include "triggers.hpp"                 /* seq64::triggers, etc.    */
 
+/**
+ *  The bit masks of the kinds of dirtiness of a sequence, for
+ *  sequence::mark_dirty() and perform::mark_dirty().  See
+ *  seq64::dirty_kind_t.
+ */
+
+#define SEQ64_DIRTY_MAIN        (1u << seq64::DIRTY_MAIN)
+#define SEQ64_DIRTY_EDIT        (1u << seq64::DIRTY_EDIT)
+#define SEQ64_DIRTY_PERF        (1u << seq64::DIRTY_PERF)
+#define SEQ64_DIRTY_NAMES       (1u << seq64::DIRTY_NAMES)
+#define SEQ64_DIRTY_ALL         ((1u << seq64::DIRTY_KINDS) - 1)
+
+/**
+ *  The number of columns over which sequence::get_note_summary() decimates
+ *  the notes of a sequence.  Lines of the same pitch that are less than one
+ *  column apart are merged into one line.
+ */
+
+#define SEQ64_SUMMARY_COLUMNS   512
+
+/**
+ *  The number of held-back calls for which sequence::reserve_deferred()
+ *  makes room, enough for the output of a busy frame of one sequence.
+ */
+
+#define SEQ64_DEFERRED_RESERVE  256
+
 /**
  *  Enables the Stazed/Seq32 code for adding overwrite and expand looping
  *  modes to the legacy merge looping recording mode.
@@ -81,20 +113,6 @@ namespace seq64
     class mastermidibus;
     class perform;
 
-/**
- *  Provides a set of methods for drawing certain items.  These values are
- *  used in the sequence, seqroll, perfroll, and mainwid classes.
- */
-
-enum draw_type_t
-{
-    DRAW_FIN = 0,           /**< Indicates that drawing is finished.        */
-    DRAW_NORMAL_LINKED,     /**< Used for drawing linked notes.             */
-    DRAW_NOTE_ON,           /**< For starting the drawing of a note.        */
-    DRAW_NOTE_OFF,          /**< For finishing the drawing of a note.       */
-    DRAW_TEMPO              /**< For drawing tempo meta events.             */
-};
-
 #ifdef SEQ64_STAZED_EXPAND_RECORD
 
 /**
@@ -112,6 +130,87 @@ enum loop_record_t
 
 #endif  // SEQ64_STAZED_EXPAND_RECORD
 
+/**
+ *  The kinds of output that a sequence holds back while a worker thread of
+ *  the perform object plays a frame of it.  See sequence::play_deferred().
+ */
+
+enum deferred_t
+{
+    DEFERRED_POST,          /**< A mastermidibase::post() by play().        */
+    DEFERRED_PLAY,          /**< A mastermidibase::play() of a Note Off.    */
+    DEFERRED_FLUSH,         /**< A mastermidibase::flush().                 */
+    DEFERRED_TEMPO          /**< A perform::set_beats_per_minute().         */
+};
+
+/**
+ *  The kinds of dirtiness of a sequence, one per kind of view that needs to
+ *  redraw it.  Each value is the index of a changed-sequences bitset of the
+ *  perform object, which each view clears with its own
+ *  perform::is_dirty_*() function.  Only the edit kind is also kept by the
+ *  sequence itself, for sequence::is_dirty_edit().
+ */
+
+enum dirty_kind_t
+{
+    DIRTY_MAIN = 0,         /**< Patterns panel (mainwid).                  */
+    DIRTY_EDIT,             /**< Pattern editor (seqedit).                  */
+    DIRTY_PERF,             /**< Song editor roll (perfroll).               */
+    DIRTY_NAMES,            /**< Song editor names (perfnames).             */
+    DIRTY_KINDS             /**< The number of kinds.                       */
+};
+
+/**
+ *  One call held back by sequence::play_deferred(), to be made by
+ *  sequence::replay_output().
+ */
+
+struct deferred_output
+{
+    deferred_t do_kind;             /**< The call to be made.               */
+    batch_message do_message;       /**< The message to post or to play.    */
+    midibpm do_bpm;                 /**< The tempo to set.                  */
+};
+
+/**
+ *  One line of the note summary of a sequence.  The fields have the meaning
+ *  of the parameters of event_snapshot::next_note_event().
+ */
+
+struct note_summary_item
+{
+    draw_type_t nsi_type;           /**< The kind of line to draw.          */
+    midipulse nsi_tick_start;       /**< The start of the line.             */
+    midipulse nsi_tick_finish;      /**< The end of the line.               */
+    int nsi_note;                   /**< The note, or the scaled tempo.     */
+    int nsi_velocity;               /**< The loudest velocity of the line.  */
+};
+
+/**
+ *  The note range and the decimated note lines of a sequence, as drawn by
+ *  the pattern slots and the song editor.  Built by
+ *  sequence::get_note_summary() and never changed afterward, so that a
+ *  viewer can keep one as long as it likes.
+ */
+
+struct note_summary
+{
+    unsigned long ns_serial;        /**< In-place change count at build.    */
+    unsigned ns_revision;           /**< event_list::revision() at build.   */
+    midipulse ns_length;            /**< The length of the sequence.        */
+    bool ns_have_notes;             /**< False if no notes and no tempos.   */
+    int ns_low_note;                /**< The lowest note or scaled tempo.   */
+    int ns_high_note;               /**< The highest note or scaled tempo.  */
+    std::vector<note_summary_item> ns_items;    /**< The lines to draw.     */
+};
+
+/**
+ *  A shared pointer to a note summary, which stays valid after the
+ *  sequence builds a newer one.
+ */
+
+typedef std::shared_ptr<const note_summary> note_summary_ptr;
+
 /**
  *  The sequence class is firstly a receptable for a single track of MIDI
  *  data read from a MIDI file or edited into a pattern.  More members than
@@ -122,6 +221,7 @@ class sequence
 {
     friend class perform;               /* access to set_parent()   */
     friend class triggers;              /* will unfriend later      */
+    friend class sequence_edit;         /* batches the bulk edits   */
 
 public:
 
@@ -145,10 +245,10 @@ private:
 
     /**
      *  Provides a stack of event-lists for use with the undo and redo
-     *  facility.
+     *  facility.  It stores only the events changed by each edit.
      */
 
-    typedef std::stack<event_list> EventStack;
+    typedef event_stack EventStack;
 
 private:
 
@@ -233,10 +333,60 @@ private:
     EventStack m_events_redo;
 
     /**
-     *  An iterator for drawing events.
+     *  The read-only copy of the events handed out to the views by
+     *  get_event_snapshot(), replaced when the events change.
      */
 
-    event_list::iterator m_iterator_draw;
+    event_snapshot_ptr m_event_snapshot;
+
+    /**
+     *  Counts the changes made to the events in place, such as selection,
+     *  which change neither the generation nor the event-list revision, so
+     *  that get_event_snapshot() knows to copy the events again, and
+     *  get_note_summary() to rebuild the summary.  Guarded by m_mutex.
+     */
+
+    unsigned long m_snapshot_serial;
+
+    /**
+     *  The cached note summary, rebuilt by get_note_summary() when the
+     *  event-list revision, the in-place change count, or the length of the
+     *  sequence no longer matches.
+     */
+
+    note_summary_ptr m_note_summary;
+
+    /**
+     *  The play cursor.  Points to the next event that play() will consider,
+     *  so that each output frame starts where the previous one stopped,
+     *  instead of scanning the event list from the beginning.  The cursor is
+     *  valid only while m_play_revision matches the revision of m_events and
+     *  the frame starts at m_play_next_tick.
+     */
+
+    event_list::iterator m_iterator_play;
+
+    /**
+     *  The offset, a multiple of m_length, that is added to the time-stamp of
+     *  the event at m_iterator_play to get its position in (offset) global
+     *  ticks.  It grows by m_length each time the cursor wraps around.
+     */
+
+    midipulse m_play_offset_base;
+
+    /**
+     *  The offset tick at which the next frame is expected to start.  If the
+     *  next frame starts anywhere else, or if this value is
+     *  SEQ64_NULL_MIDIPULSE, the play cursor is repositioned.
+     */
+
+    midipulse m_play_next_tick;
+
+    /**
+     *  The event_list::revision() value for which m_iterator_play is valid.
+     */
+
+    unsigned m_play_revision;
 
     /**
      *  A new feature for recording, based on a "stazed" feature.  If true
@@ -292,6 +442,24 @@ private:
 
     mastermidibus * m_masterbus;
 
+    /**
+     *  True while play_deferred() runs.  The calls that play() and
+     *  off_playing_notes() make on the master buss and on the parent are
+     *  then appended to m_deferred instead.
+     */
+
+    bool m_defer_output;
+
+    /**
+     *  The calls held back by play_deferred(), in order.  The perform
+     *  object calls reserve_deferred() when its worker threads are running,
+     *  so that defer() does not allocate on the output path, and clear()
+     *  keeps the capacity from frame to frame, so that a frame busier than
+     *  the reserve allocates only the first time.
+     */
+
+    std::vector<deferred_output> m_deferred;
+
     /**
      *  Provides a "map" for Note On events.  It is used when muting, to shut
      *  off the notes that are playing.
@@ -360,15 +528,20 @@ private:
     mutable midipulse m_unit_measure;
 
     /**
-     *  These flags indicate that the content of the sequence has changed due
-     *  to recording, editing, performance management, or even (?) a
-     *  name change.
+     *  Indicates that the content of the sequence has changed, for the
+     *  pattern editor.  The other views get their dirtiness from the
+     *  perform object.
      */
 
-    bool m_dirty_main;          /**< Provides the main dirtiness flag.      */
-    bool m_dirty_edit;          /**< Provides the main is-edited flag.      */
-    bool m_dirty_perf;          /**< Provides performance dirty flagflag.   */
-    bool m_dirty_names;         /**< Provides the names dirtiness flag.     */
+    std::atomic<bool> m_dirty_edit;
+
+    /**
+     *  The change generation, incremented every time the sequence is marked
+     *  dirty.  A viewer can compare it with the value it last saw to find
+     *  out, without locking, whether the sequence changed.
+     */
+
+    std::atomic<unsigned long> m_generation;
 
     /**
      *  Indicates that the sequence is currently being edited.
@@ -1074,13 +1247,19 @@ public:
         return m_thru;
     }
 
-    bool is_dirty_main ();
     bool is_dirty_edit ();
-    bool is_dirty_perf ();
-    bool is_dirty_names ();
     void set_dirty_mp ();
     void set_dirty ();
 
+    /**
+     * \getter m_generation
+     */
+
+    unsigned long generation () const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
     /**
      * \getter m_midi_channel
      */
@@ -1104,6 +1283,9 @@ public:
     void print_triggers () const;
     void play (midipulse tick, bool playback_mode);
     void play_queue (midipulse tick, bool playbackmode);
+    void play_deferred (midipulse tick, bool playbackmode);
+    void replay_output ();
+    void reserve_deferred ();
     bool add_note
     (
         midipulse tick, midipulse len, int note,
@@ -1121,6 +1303,15 @@ public:
     );
     bool append_event (const event & er);
 
+    /**
+     *  Calls event_list::reserve(), before a series of append_event() calls.
+     */
+
+    void reserve_events (int count)
+    {
+        m_events.reserve(count);
+    }
+
     /**
      *  Calls event_list::sort().
      */
@@ -1331,23 +1522,12 @@ public:
     void off_playing_notes ();
     void stop (bool song_mode = false);
     void pause (bool song_mode = false);
-    void inc_draw_marker ();
-    void reset_draw_marker ();
     void reset_draw_trigger_marker ();
-    void reset_ex_iterator (event_list::const_iterator & evi);
-    draw_type_t get_next_note_event
-    (
-        midipulse & tick_s, midipulse & tick_f, int & note,
-        bool & selected, int & velocity
-    );
+    event_snapshot_ptr get_event_snapshot ();
+    event_snapshot_ptr copy_for_save (sequence & rhs);
+    void load_event_snapshot (const event_snapshot & es);
     bool get_minmax_note_events (int & lowest, int & highest);
-    bool get_next_event (midibyte & status, midibyte & cc);
-    bool get_next_event_ex
-    (
-        midibyte status, midibyte cc,
-        event_list::const_iterator & ev,
-        int evtype = EVENTS_ALL
-    );
+    note_summary_ptr get_note_summary ();
 
     bool get_next_trigger
     (
@@ -1495,8 +1675,34 @@ private:
         const event & e, midibyte status, midipulse tick_s, midipulse tick_f
     ) const;
 
+    void mark_dirty (unsigned kinds);
     void set_parent (perform * p);
-    void put_event_on_bus (event & ev);
+    void put_event_on_bus (event & ev, midipulse late = 0);
+    void post_event_on_bus (const event & ev, midipulse late);
+    void defer (deferred_t kind, const event & ev, midipulse late);
+    bool count_playing_note (const event & ev);
+    void seek_play_cursor (midipulse tick);
+
+    /**
+     *  Makes the next get_event_snapshot() copy the events again.  Called
+     *  with m_mutex held, after changing events in place.
+     */
+
+    void invalidate_snapshot ()
+    {
+        ++m_snapshot_serial;
+    }
+
+    /**
+     *  Forces play() to reposition the play cursor at the next frame.
+     *  Called when the last tick or the length changes.
+     */
+
+    void reset_play_cursor ()
+    {
+        m_play_next_tick = SEQ64_NULL_MIDIPULSE;
+    }
+
 #ifdef SEQ64_STAZED_EXPAND_RECORD
     void reset_loop ();
 #endif
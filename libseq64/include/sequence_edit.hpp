@@ -0,0 +1,162 @@
+#ifndef SEQ64_SEQUENCE_EDIT_HPP
+#define SEQ64_SEQUENCE_EDIT_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          sequence_edit.hpp
+ *
+ *  This module declares a transaction for changing many events of a
+ *  sequence at once.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The bulk editing functions of the sequence class (quantizing, pasting,
+ *  moving, stretching, transposing, and so on) used to add each changed
+ *  event to a temporary event_list with event_list::add(), which sorts the
+ *  whole std::list on every call, and then to relink and redraw the
+ *  pattern, sometimes more than once.  A sequence_edit holds the sequence
+ *  lock for the whole edit and collects the changes instead:
+ *
+ *      -   New events are appended, unsorted.
+ *      -   Events to remove are marked, as the marking functions of the
+ *          sequence class already do.
+ *      -   Events changed in place are simply noted, along with whether
+ *          their time-stamps changed.
+ *
+ *  The commit() then applies them all in one pass:  one removal of the
+ *  marked events, one sort of the new events (and of the pattern, only if
+ *  time-stamps changed in place), one merge, one linear relink, and one
+ *  dirty notification.  The undo entry, if wanted, is pushed once, when the
+ *  edit starts.
+ */
+
+#include "event_list.hpp"               /* seq64::event_list, seq64::event  */
+#include "mutex.hpp"                    /* seq64::automutex                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class sequence;
+
+/**
+ *  A batch of changes to the events of one sequence, applied all at once.
+ *  The object locks the sequence for its whole lifetime, and commits when
+ *  it is destroyed, if commit() was not called before.
+ */
+
+class sequence_edit
+{
+
+private:
+
+    /**
+     *  The sequence being edited.
+     */
+
+    sequence & m_seq;
+
+    /**
+     *  Holds the sequence lock from the start of the edit to its end.
+     */
+
+    automutex m_locker;
+
+    /**
+     *  The new events, in the order they were added.  They are sorted only
+     *  once, by commit().
+     */
+
+    event_list m_added;
+
+    /**
+     *  True if events were changed in place, or added, or marked for
+     *  removal.
+     */
+
+    bool m_changed;
+
+    /**
+     *  True if the time-stamps of events were changed in place, so that the
+     *  events of the sequence must be sorted again.
+     */
+
+    bool m_retimed;
+
+    /**
+     *  True if remove() was called, so that commit() must remove the marked
+     *  events.
+     */
+
+    bool m_removing;
+
+    /**
+     *  True once commit() has applied the changes.
+     */
+
+    bool m_committed;
+
+private:        // do not allow these functions to be used
+
+    sequence_edit (const sequence_edit &);
+    sequence_edit & operator = (const sequence_edit &);
+
+public:
+
+    sequence_edit (sequence & s, bool undo = true);
+    ~sequence_edit ();
+
+    void add (const event & e);
+    void remove (event & e);
+
+    /**
+     *  Notes that the caller changed events of the sequence in place.
+     *
+     * \param retimed
+     *      True if any time-stamp was changed, so that the events must be
+     *      sorted again.
+     */
+
+    void modified (bool retimed = false)
+    {
+        m_changed = true;
+        if (retimed)
+            m_retimed = true;
+    }
+
+    void commit ();
+
+};
+
+}           // namespace seq64
+
+#endif      // SEQ64_SEQUENCE_EDIT_HPP
+
+/*
+ * sequence_edit.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
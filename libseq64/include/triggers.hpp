@@ -35,9 +35,9 @@
  *  a bit easier to understand.
  */
 
-#include <string>
-#include <list>
 #include <stack>
+#include <string>
+#include <vector>
 
 /**
  *  Indicates that there is no paste-trigger.  This is a new feature from the
@@ -113,7 +113,7 @@ public:
      *      Returns true if m_tick_start is less than rhs's.
      */
 
-    bool operator < (const trigger & rhs)
+    bool operator < (const trigger & rhs) const
     {
         return m_tick_start < rhs.m_tick_start;
     }
@@ -261,6 +261,11 @@ public:
 /**
  *  The triggers class is a receptable the triggers that can be used with a
  *  sequence object.
+ *
+ *  The triggers are kept in a vector, sorted by start tick.  Since they do
+ *  not overlap (add() trims or removes the triggers that a new trigger
+ *  overlaps), they are also sorted by end tick, and the trigger at a given
+ *  tick can be found by a binary search.
  */
 
 class triggers
@@ -289,7 +294,7 @@ private:
      *  Exposes the triggers type, currently needed for midi_container only.
      */
 
-    typedef std::list<trigger> List;
+    typedef std::vector<trigger> List;
 
     /**
      *  Provides a stack for use with the undo/redo features of the
@@ -332,16 +337,22 @@ private:
     Stack m_redo_stack;
 
     /**
-     *  An iterator for cycling through the triggers during playback.
+     *  The position found by the last call to play(), used as a hint by the
+     *  next call.  Since the song position usually stays within the same
+     *  trigger from one output frame to the next, play() usually costs no
+     *  search at all.  The hint is always checked before being used, so it
+     *  need not be updated when the triggers are edited.
      */
 
-    List::iterator m_iterator_play_trigger;
+    std::size_t m_play_index;
 
     /**
-     *  An iterator for cycling through the triggers during drawing.
+     *  The index of the next trigger to be returned by next() during
+     *  drawing.  An index, unlike an iterator, stays usable if the vector
+     *  grows.
      */
 
-    List::iterator m_iterator_draw_trigger;
+    std::size_t m_draw_index;
 
     /**
      *  Set to true if there is an active trigger in the trigger clipboard.
@@ -451,6 +462,8 @@ public:
     midipulse get_selected_start ();
     midipulse get_selected_end ();
     midipulse get_maximum ();
+    std::size_t play_index (midipulse tick);
+    List::iterator find (midipulse tick);
     void move (midipulse starttick, midipulse distance, bool direction);
     void copy (midipulse starttick, midipulse distance);
 
@@ -476,7 +489,7 @@ public:
 
     void reset_draw_trigger_marker ()
     {
-        m_iterator_draw_trigger = m_triggers.begin();
+        m_draw_index = 0;
     }
 
     void set_trigger_paste_tick (midipulse tick)
@@ -780,6 +780,30 @@ class user_settings
 
     std::string m_user_option_logfile;
 
+    /**
+     *  If not empty, the seq64cli application renders the song of the MIDI
+     *  file given on the command line to this MIDI file, as fast as
+     *  possible, and exits, instead of running.  Specified by the
+     *  "-o render=filename" option, and never saved.
+     */
+
+    std::string m_user_option_renderfile;
+
+    /**
+     *  If not empty, the seq64cli application appends the timing statistics
+     *  of the output thread to this file periodically, as CSV if the file
+     *  name ends in ".csv", and as JSON lines otherwise.  Specified by the
+     *  "-o metrics=filename[,seconds]" option, and never saved.
+     */
+
+    std::string m_user_option_metricsfile;
+
+    /**
+     *  The number of seconds between two dumps to the metrics file.
+     */
+
+    int m_user_option_metrics_interval;
+
 public:
 
     user_settings ();
@@ -1575,6 +1599,33 @@ public:
 
     std::string option_logfile () const;
 
+    /**
+     * \getter m_user_option_renderfile
+     */
+
+    const std::string & option_renderfile () const
+    {
+        return m_user_option_renderfile;
+    }
+
+    /**
+     * \getter m_user_option_metricsfile
+     */
+
+    const std::string & option_metricsfile () const
+    {
+        return m_user_option_metricsfile;
+    }
+
+    /**
+     * \getter m_user_option_metrics_interval
+     */
+
+    int option_metrics_interval () const
+    {
+        return m_user_option_metrics_interval;
+    }
+
 public:         // used in main application module and the userfile class
 
     /**
@@ -1678,6 +1729,36 @@ public:         // used in main application module and the userfile class
         m_user_option_logfile = logfile;
     }
 
+    /**
+     * \setter m_user_option_renderfile
+     */
+
+    void option_renderfile (const std::string & renderfile)
+    {
+        m_user_option_renderfile = renderfile;
+    }
+
+    /**
+     * \setter m_user_option_metricsfile
+     */
+
+    void option_metricsfile (const std::string & metricsfile)
+    {
+        m_user_option_metricsfile = metricsfile;
+    }
+
+    /**
+     * \setter m_user_option_metrics_interval
+     *
+     * \param seconds
+     *      The dump interval.  Values less than 1 are set to 1.
+     */
+
+    void option_metrics_interval (int seconds)
+    {
+        m_user_option_metrics_interval = seconds > 1 ? seconds : 1 ;
+    }
+
     void midi_ppqn (int ppqn);
     void midi_buss_override (char buss);
     void velocity_override (int vel);
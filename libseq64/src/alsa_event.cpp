@@ -0,0 +1,118 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          alsa_event.cpp
+ *
+ *  This module defines the encoding of MIDI messages into ALSA sequencer
+ *  events.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Both ALSA output implementations, the midibus of seq_alsamidi and the
+ *  midi_alsa class of seq_rtmidi, encode the events they play here.
+ */
+
+#include "alsa_event.hpp"
+#include "event.hpp"                    /* EVENT_NOTE_OFF and friends       */
+
+#ifdef SEQ64_HAVE_LIBASOUND
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Encodes a channel-voice message directly into an ALSA sequencer event,
+ *  using the snd_seq_ev_set_*() macros.  This avoids creating and freeing an
+ *  snd_midi_event_t parser (a heap allocation) for every event played on the
+ *  output thread.
+ *
+ * \param buffer
+ *      Provides the status byte (including the channel) and the two data
+ *      bytes of the message.
+ *
+ * \param ev
+ *      Provides the ALSA event to be filled in.  It must already be cleared.
+ *
+ * \return
+ *      Returns true if the status was a channel-voice status, and the event
+ *      was filled in.  Otherwise, the caller must use the slow path.
+ */
+
+bool
+encode_channel_event (const midibyte buffer [], snd_seq_event_t & ev)
+{
+    bool result = true;
+    int channel = buffer[0] & 0x0F;
+    switch (buffer[0] & 0xF0)
+    {
+    case EVENT_NOTE_OFF:
+        snd_seq_ev_set_noteoff(&ev, channel, buffer[1], buffer[2]);
+        break;
+
+    case EVENT_NOTE_ON:
+        snd_seq_ev_set_noteon(&ev, channel, buffer[1], buffer[2]);
+        break;
+
+    case EVENT_AFTERTOUCH:
+        snd_seq_ev_set_keypress(&ev, channel, buffer[1], buffer[2]);
+        break;
+
+    case EVENT_CONTROL_CHANGE:
+        snd_seq_ev_set_controller(&ev, channel, buffer[1], buffer[2]);
+        break;
+
+    case EVENT_PROGRAM_CHANGE:
+        snd_seq_ev_set_pgmchange(&ev, channel, buffer[1]);
+        break;
+
+    case EVENT_CHANNEL_PRESSURE:
+        snd_seq_ev_set_chanpress(&ev, channel, buffer[1]);
+        break;
+
+    case EVENT_PITCH_WHEEL:
+        snd_seq_ev_set_pitchbend
+        (
+            &ev, channel, ((int(buffer[2]) << 7) | int(buffer[1])) - 8192
+        );
+        break;
+
+    default:
+        result = false;
+        break;
+    }
+    return result;
+}
+
+}           // namespace seq64
+
+#endif      // SEQ64_HAVE_LIBASOUND
+
+/*
+ * alsa_event.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
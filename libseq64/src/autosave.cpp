@@ -0,0 +1,317 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          autosave.cpp
+ *
+ *  This module defines a class for saving the song periodically in the
+ *  background, for recovery after a crash.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The autosave file is an ordinary Sequencer64 MIDI file, so a song is
+ *  recovered simply by opening it.  Saving the song normally does not
+ *  remove it.
+ */
+
+#include <sched.h>                      /* sched_setscheduler()             */
+#include <stdio.h>                      /* printf(), fprintf()              */
+#include <string.h>                     /* memset()                         */
+
+#include "autosave.hpp"
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  The snapshot starts empty.
+ */
+
+song_snapshot::song_snapshot ()
+ :
+    ss_filename     (),
+    ss_ppqn         (0),
+    ss_timing       (),
+    ss_tracks       (),
+    ss_proprietary  ()
+{
+    // Empty body
+}
+
+/**
+ *  Deletes the detached sequences of the snapshot.
+ */
+
+song_snapshot::~song_snapshot ()
+{
+    for (std::size_t t = 0; t < ss_tracks.size(); ++t)
+        delete ss_tracks[t].st_sequence;
+}
+
+/**
+ *  Principal constructor.  The thread is launched by the first poll() that
+ *  finds autosaving enabled.
+ *
+ * \param p
+ *      The performance to save.
+ */
+
+autosave::autosave (perform & p)
+ :
+    m_perform           (p),
+    m_condition         (),
+    m_pending           (nullptr),
+    m_saving            (false),
+    m_exit              (false),
+    m_thread            (),
+    m_thread_launched   (false),
+    m_last_check_us     (wakeup_event::now_us())
+{
+    // Empty body
+}
+
+/**
+ *  Stops the thread, if launched.
+ */
+
+autosave::~autosave ()
+{
+    stop();
+}
+
+/**
+ *  Checks whether the song is due to be autosaved, and if so, takes a
+ *  snapshot of it and hands the snapshot to the autosave thread.  Must be
+ *  called regularly, about once a second, by the thread that owns the
+ *  performance, as it reads the performance the way midifile::write()
+ *  does.  Nothing is done if autosaving is disabled, if the interval has
+ *  not passed, if the song has no unsaved changes, or if the previous
+ *  snapshot is still being written.
+ */
+
+void
+autosave::poll ()
+{
+    int interval = rc().autosave_interval();
+    if (interval <= 0)
+        return;
+
+    std::int64_t now = wakeup_event::now_us();
+    if (now - m_last_check_us < std::int64_t(interval) * 1000000)
+        return;
+
+    m_last_check_us = now;
+    if (! m_perform.is_modified())
+        return;
+
+    if (! m_thread_launched && ! launch())
+        return;
+
+    m_condition.lock();
+    bool busy = m_saving || not_nullptr(m_pending);
+    m_condition.unlock();
+    if (busy)
+        return;
+
+    song_snapshot * ss = new song_snapshot;
+    ss->ss_filename = rc().autosave_filespec();
+    ss->ss_ppqn = m_perform.ppqn();
+    if (ss->ss_filename.empty())
+    {
+        delete ss;
+        return;
+    }
+
+    midifile f
+    (
+        ss->ss_filename, ss->ss_ppqn,
+        rc().legacy_format(), usr().global_seq_feature()
+    );
+    f.take_snapshot(m_perform, *ss);
+    m_condition.lock();
+    m_pending = ss;
+    m_condition.signal();
+    m_condition.unlock();
+}
+
+/**
+ *  Tells the thread to exit, and waits for it.  A snapshot that is not yet
+ *  written is discarded.  Must be called before the performance goes away.
+ */
+
+void
+autosave::stop ()
+{
+    if (m_thread_launched)
+    {
+        m_condition.lock();
+        m_exit = true;
+        m_condition.signal();
+        m_condition.unlock();
+        pthread_join(m_thread, NULL);
+        m_thread_launched = false;
+    }
+    if (not_nullptr(m_pending))
+    {
+        delete m_pending;
+        m_pending = nullptr;
+    }
+}
+
+/**
+ *  Creates the autosave thread.
+ *
+ * \return
+ *      Returns true if the thread was created.
+ */
+
+bool
+autosave::launch ()
+{
+    m_exit = false;
+    int err = pthread_create(&m_thread, NULL, autosave_thread_func, this);
+    if (err == 0)
+    {
+        m_thread_launched = true;
+    }
+    else
+    {
+        fprintf(stderr, "? couldn't create autosave thread (error %d)\n", err);
+    }
+
+    return m_thread_launched;
+}
+
+/**
+ *  The loop of the autosave thread.  It waits for poll() to hand it a
+ *  snapshot, writes it, and waits again, until stop() tells it to exit.
+ */
+
+void
+autosave::run ()
+{
+    for (;;)
+    {
+        m_condition.lock();
+        while (! m_exit && is_nullptr(m_pending))
+            m_condition.wait();
+
+        if (m_exit)
+        {
+            m_condition.unlock();
+            break;
+        }
+
+        song_snapshot * ss = m_pending;
+        m_pending = nullptr;
+        m_saving = true;
+        m_condition.unlock();
+
+        (void) save(*ss);
+        delete ss;
+
+        m_condition.lock();
+        m_saving = false;
+        m_condition.unlock();
+    }
+}
+
+/**
+ *  Writes a snapshot to the autosave file.  Errors are reported on the
+ *  console, and the next autosave simply tries again.
+ *
+ * \param ss
+ *      The snapshot to write.
+ *
+ * \return
+ *      Returns true if the file was written.
+ */
+
+bool
+autosave::save (song_snapshot & ss)
+{
+    midifile f
+    (
+        ss.ss_filename, ss.ss_ppqn,
+        rc().legacy_format(), usr().global_seq_feature()
+    );
+    bool result = f.write_snapshot(ss);
+    if (result)
+    {
+        if (rc().stats())
+            printf("[Autosaved '%s']\n", ss.ss_filename.c_str());
+    }
+    else
+        printf("? autosave: %s\n", f.error_message().c_str());
+
+    return result;
+}
+
+/**
+ *  Runs the autosave thread.  Where possible, the thread is given the idle
+ *  scheduling policy, so that it only uses time that neither the output
+ *  thread nor the user interface needs.
+ *
+ * \param myautosave
+ *      Provides the autosave object.
+ *
+ * \return
+ *      Always returns a null pointer.
+ */
+
+void *
+autosave_thread_func (void * myautosave)
+{
+    autosave * a = (autosave *) myautosave;
+
+#ifdef SCHED_IDLE
+    struct sched_param schp;
+    memset(&schp, 0, sizeof(sched_param));
+    if (sched_setscheduler(0, SCHED_IDLE, &schp) != 0)
+    {
+        fprintf
+        (
+            stderr,
+            "? autosave_thread_func: couldn't sched_setscheduler(IDLE)\n"
+        );
+    }
+#endif
+
+    a->run();
+    return nullptr;
+}
+
+}           // namespace seq64
+
+/*
+ * autosave.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
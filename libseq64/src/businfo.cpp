@@ -415,14 +415,18 @@ busarray::init_clock (midipulse tick)
  *
  * \param tick
  *      Provides the tick value for all busses use as the clock tick.
+ *
+ * \param ahead
+ *      If not SEQ64_NULL_MIDIPULSE, the lookahead, in ticks, with which the
+ *      clocks are scheduled.  See midibase::clock().
  */
 
 void
-busarray::clock (midipulse tick)
+busarray::clock (midipulse tick, midipulse ahead)
 {
     std::vector<businfo>::iterator bi;
     for (bi = m_container.begin(); bi != m_container.end(); ++bi)
-        bi->clock(tick);
+        bi->clock(tick, ahead);
 }
 
 /**
@@ -453,13 +457,20 @@ busarray::sysex (event * ev)
  *      The MIDI channel on which to play the event.  Sequencer64 controls
  *      the actual channel of playback, no matter what the channel specified
  *      in the event.
+ *
+ * \param delay
+ *      If not SEQ64_NULL_MIDIPULSE, the event is scheduled to go out this
+ *      many ticks from now.  See midibase::play().
  */
 
 void
-busarray::play (bussbyte bus, event * e24, midibyte channel)
+busarray::play
+(
+    bussbyte bus, event * e24, midibyte channel, midipulse delay
+)
 {
     if (bus < count() && m_container[bus].active())
-        m_container[bus].bus()->play(e24, channel);
+        m_container[bus].bus()->play(e24, channel, delay);
 }
 
 /**
@@ -316,10 +316,17 @@ static const char * const s_help_4 =
 "\n"
 " seq64cli:    daemonize     Makes this application fork to the background.\n"
 "              no-daemonize  Or not.\n"
+"              render=file   Render the song of the given MIDI file to 'file',\n"
+"                            a standard MIDI file, as fast as possible, and\n"
+"                            exit, instead of running.\n"
+"              metrics=file[,seconds]  Append the output timing statistics\n"
+"                            to 'file' every 'seconds' (default 1), as\n"
+"                            CSV if 'file' ends in '.csv', else as JSON.\n"
 "\n"
-"The 'daemonize' option works only in the CLI build. The 'sets' option works in\n"
-"the CLI build as well.  Specify the '--user-save' option to make these options\n"
-"permanent in the sequencer64.usr configuration file.\n"
+"The 'daemonize', 'render', and 'metrics' options work only in the CLI\n"
+"build.  The 'sets' option works in the CLI build as well.  Specify\n"
+"'--user-save' to make these options permanent in the sequencer64.usr\n"
+"configuration file; the 'render' and 'metrics' options are never saved.\n"
 "\n"
     ;
 
@@ -498,6 +505,30 @@ parse_o_options (int argc, char * argv [])
                                 result = true;
                                 usr().option_logfile(arg);
                             }
+                            else if (optionname == "render")
+                            {
+                                result = ! arg.empty();
+                                usr().option_renderfile(arg);
+                            }
+                            else if (optionname == "metrics")
+                            {
+                                /*
+                                 * The arg is of the form "file[,seconds]".
+                                 */
+
+                                std::string::size_type comma = arg.rfind(',');
+                                if (comma != std::string::npos)
+                                {
+                                    std::string secs = arg.substr(comma + 1);
+                                    usr().option_metrics_interval
+                                    (
+                                        atoi(secs.c_str())
+                                    );
+                                    arg = arg.substr(0, comma);
+                                }
+                                result = ! arg.empty();
+                                usr().option_metricsfile(arg);
+                            }
 #if defined SEQ64_MULTI_MAINWID
                             else if (optionname == "wid")
                             {
@@ -1115,6 +1146,12 @@ const static std::string s_build_use_event_map = "ON";
 const static std::string s_build_use_event_map = "off";
 #endif
 
+#ifdef SEQ64_USE_EVENT_VECTOR
+const static std::string s_build_use_event_vector = "ON";
+#else
+const static std::string s_build_use_event_vector = "off";
+#endif
+
 #ifdef SEQ64_STAZED_CHORD_GENERATOR
 const static std::string s_build_chord_generator = "ON";
 #else
@@ -1147,12 +1184,6 @@ const static std::string s_build_follow_progress = "ON";
 const static std::string s_build_follow_progress = "off";
 #endif
 
-#ifdef SEQ64_STATISTICS_SUPPORT
-const static std::string s_statistics_support = "ON";
-#else
-const static std::string s_statistics_support = "off";
-#endif
-
 #ifdef SEQ64_STAZED_TRANSPOSE
 const static std::string s_seq32_transpose = "ON";
 #else
@@ -1208,6 +1239,7 @@ build_details ()
 << "PortMIDI support * = "       << s_build_portmidi_support      << std::endl
 << "Event editor * = "           << s_event_editor                << std::endl
 << "Event multimap (vs list) = " << s_build_use_event_map         << std::endl
+<< "Event vector (vs list) = "   << s_build_use_event_vector      << std::endl
 << "Follow progress bar = "      << s_build_follow_progress       << std::endl
 << "Highlight edit pattern * = " << s_build_edit_highlight        << std::endl
 << "Highlight empty patterns = " << s_build_highlight_empty       << std::endl
@@ -1224,7 +1256,6 @@ build_details ()
 << "Solid piano-roll grid = "    << s_build_solid_grid            << std::endl
 << "Main window scroll-bars = "  << s_je_pattern_scrollbars       << std::endl
 << "Multiple main windows * = "  << s_multiple_mainwids           << std::endl
-<< "Statistics support * = "     << s_statistics_support          << std::endl
 << "Debug code * = "             << s_debug_mode                  << std::endl
 << std::endl
 << "* option is enabled/disabled via the configure script." << std::endl
@@ -88,6 +88,13 @@
 namespace seq64
 {
 
+/**
+ *  The buffer seen through the const get_sysex() by events without any
+ *  SysEx/Meta data.
+ */
+
+const event::SysexContainer event::sm_no_sysex;
+
 /**
  *  This constructor simply initializes all of the class members.
  */
@@ -98,7 +105,7 @@ event::event ()
     m_status        (EVENT_NOTE_OFF),
     m_channel       (EVENT_NULL_CHANNEL),
     m_data          (),                     /* a two-element array  */
-    m_sysex         (),                     /* an std::vector       */
+    m_sysex         (),                     /* null, no ex data     */
     m_linked        (nullptr),
     m_has_link      (false),
     m_selected      (false),
@@ -136,7 +143,7 @@ event::event (const event & rhs)
     m_status        (rhs.m_status),
     m_channel       (rhs.m_channel),
     m_data          (),                     /* a two-element array      */
-    m_sysex         (rhs.m_sysex),          /* copies a vector of data  */
+    m_sysex         (rhs.m_sysex),          /* shares the ex data       */
     m_linked        (nullptr),              /* pointer, not yet handled */
     m_has_link      (false),                /* must indicate that fact  */
     m_selected      (rhs.m_selected),
@@ -150,7 +157,7 @@ event::event (const event & rhs)
 /**
  *  This destructor explicitly deletes m_sysex and sets it to null.
  *  The restart_sysex() function does what we need.  But now that m_sysex is a
- *  vector, no action is needed.
+ *  shared pointer, no action is needed.
  */
 
 event::~event ()
@@ -165,7 +172,7 @@ event::~event ()
  *  when the MIDI file is read, so we don't handle them for now.
  *
  * \warning
- *      This function now copies the SysEx data, but the inclusion of SysEx
+ *      This function now shares the SysEx data, but the inclusion of SysEx
  *      events was not complete in Seq24, and it is still not complete in
  *      Sequencer64.  Nor does it currently bother with the link the event
  *      might have.
@@ -356,14 +363,35 @@ event::set_meta_status (midibyte metatype)
 }
 
 /**
- *  Deletes and clears out the SYSEX buffer.  (The m_sysex member used to be a
- *  pointer.)
+ *  Deletes and clears out the SYSEX buffer.  Only this event lets go of the
+ *  buffer; copies of this event that share it keep their data.
  */
 
 void
 event::restart_sysex ()
 {
-    m_sysex.clear();
+    m_sysex.reset();
+}
+
+/**
+ *  Provides the SYSEX buffer for modification.  The buffer is created if
+ *  this event has none yet, and is copied if it is still shared with other
+ *  events, so that changing the data of one event never changes the data of
+ *  its copies.
+ *
+ * \return
+ *      Returns a reference to the buffer, now owned only by this event.
+ */
+
+event::SysexContainer &
+event::sysex_buffer ()
+{
+    if (! m_sysex)
+        m_sysex = std::make_shared<SysexContainer>();
+    else if (m_sysex.use_count() > 1)
+        m_sysex = std::make_shared<SysexContainer>(*m_sysex);
+
+    return *m_sysex;
 }
 
 /**
@@ -393,10 +421,11 @@ event::append_sysex (midibyte * data, int dsize)
     bool result = false;
     if (not_nullptr(data) && (dsize > 0))
     {
+        SysexContainer & ex = sysex_buffer();
         result = true;
         for (int i = 0; i < dsize; ++i)
         {
-            m_sysex.push_back(data[i]);
+            ex.push_back(data[i]);
             if (data[i] == EVENT_MIDI_SYSEX_END)
             {
                 result = false;
@@ -448,9 +477,10 @@ event::append_meta_data (midibyte metatype, midibyte * data, int dsize)
     bool result = false;
     if (not_nullptr(data) && (dsize > 0))
     {
+        SysexContainer & ex = sysex_buffer();
         set_meta_status(metatype);          // m_channel = metatype;
         for (int i = 0; i < dsize; ++i)
-            m_sysex.push_back(data[i]);
+            ex.push_back(data[i]);
 
         result = true;
     }
@@ -472,7 +502,7 @@ event::append_meta_data (midibyte metatype, midibyte * data, int dsize)
 bool
 event::append_sysex (midibyte data)
 {
-    m_sysex.push_back(data);
+    sysex_buffer().push_back(data);
     return data != EVENT_MIDI_SYSEX_END;
 }
 
@@ -499,7 +529,7 @@ event::print () const
             if (use_linefeeds && (i % 16) == 0)
                 printf("\n         ");
 
-            printf("%02X ", m_sysex[i]);
+            printf("%02X ", get_sysex()[i]);
         }
         printf("\n");
     }
@@ -562,10 +592,11 @@ event::tempo () const
     midibpm result = 0.0;
     if (is_tempo() && get_sysex_size() == 3)
     {
+        const SysexContainer & ex = *m_sysex;
         midibyte b[3];
-        b[0] = m_sysex[0];                  /* convert vector to array type */
-        b[1] = m_sysex[1];
-        b[2] = m_sysex[2];
+        b[0] = ex[0];                       /* convert vector to array type */
+        b[1] = ex[1];
+        b[2] = ex[2];
         result = bpm_from_bytes(b);
     }
     return result;
@@ -38,10 +38,19 @@
  *  SEQ64_USE_EVENT_MAP versus SEQ64_USE_EVENTEDIT_MAP.
  */
 
+#include <iterator>                     /* std::advance()               */
 #include <stdio.h>                      /* C::printf()                  */
 
+#include <vector>                       /* std::vector for link_notes() */
+
 #include "easy_macros.h"
-#include "event_list.hpp"
+#include "event_list.hpp"               /* also the seq64_features.h    */
+#include "globals.h"                    /* c_midi_notes                 */
+
+#ifdef SEQ64_USE_EVENT_VECTOR
+#include <algorithm>                    /* std::upper_bound(), etc.     */
+#include <functional>                   /* std::mem_fn()                */
+#endif
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -121,7 +130,14 @@ event_list::event_list ()
     m_events                (),
     m_is_modified           (false),
     m_has_tempo             (false),
-    m_has_time_signature    (false)
+    m_has_time_signature    (false),
+#ifdef SEQ64_USE_EVENT_VECTOR
+    m_revision              (0),
+    m_link_holds            (0),
+    m_links_stale           (false)
+#else
+    m_revision              (0)
+#endif
 {
     // No code needed
 }
@@ -138,9 +154,18 @@ event_list::event_list (const event_list & rhs)
     m_events                (rhs.m_events),
     m_is_modified           (rhs.m_is_modified),
     m_has_tempo             (rhs.m_has_tempo),
-    m_has_time_signature    (rhs.m_has_time_signature)
+    m_has_time_signature    (rhs.m_has_time_signature),
+#ifdef SEQ64_USE_EVENT_VECTOR
+    m_revision              (0),
+    m_link_holds            (0),
+    m_links_stale           (false)
+#else
+    m_revision              (0)
+#endif
 {
-    // No code needed
+#ifdef SEQ64_USE_EVENT_VECTOR
+    relink();                           /* links still point into rhs   */
+#endif
 }
 
 /**
@@ -160,6 +185,10 @@ event_list::operator = (const event_list & rhs)
         m_is_modified           = rhs.m_is_modified;
         m_has_tempo             = rhs.m_has_tempo;
         m_has_time_signature    = rhs.m_has_time_signature;
+        ++m_revision;                   /* iterators into us are now stale  */
+#ifdef SEQ64_USE_EVENT_VECTOR
+        links_moved();                  /* links still point into rhs       */
+#endif
     }
     return *this;
 }
@@ -246,6 +275,10 @@ event_list::append (const event & e)
 
     m_events.insert(p);                 /* std::multimap operation  */
 
+#elif defined SEQ64_USE_EVENT_VECTOR
+
+    m_events.push_back(e);              /* unsorted, until sort()   */
+
 #else   // SEQ64_USE_EVENT_MAP
 
     m_events.push_front(e);             /* std::list operation      */
@@ -253,13 +286,68 @@ event_list::append (const event & e)
 #endif
 
     m_is_modified = true;
+    ++m_revision;
+    if (e.is_tempo())
+        m_has_tempo = true;
+
+    if (e.is_time_signature())
+        m_has_time_signature = true;
+
+    return true;
+}
+
+/**
+ *  Adds an event in sorted order, as add() does, and links it if it is a
+ *  Note On or Note Off, as link_new() would, but without going through the
+ *  whole container.  This is the path for events recorded while the
+ *  pattern plays.  For the std::list, the insertion point is found by
+ *  walking back from the end, which is where recorded events usually go,
+ *  instead of sorting the whole list.
+ *
+ * \param e
+ *      Provides the event to be added to the list.
+ *
+ * \return
+ *      Returns true.
+ */
+
+bool
+event_list::add_linked (const event & e)
+{
+#ifdef SEQ64_USE_EVENT_VECTOR
+
+    return insert(e);                   /* insert() relinks everything  */
+
+#else
+
+#ifdef SEQ64_USE_EVENT_MAP
+    iterator ie = m_events.insert(std::make_pair(event_key(e), e));
+#else
+    iterator pos = m_events.end();
+    while (pos != m_events.begin())     /* in front of equal events,    */
+    {                                   /* as add() puts them           */
+        iterator prev = pos;
+        --prev;
+        if (dref(prev) < e)
+            break;
+
+        pos = prev;
+    }
+    iterator ie = m_events.insert(pos, e);
+#endif
+
+    m_is_modified = true;
+    ++m_revision;
     if (e.is_tempo())
         m_has_tempo = true;
 
     if (e.is_time_signature())
         m_has_time_signature = true;
 
+    link_event(ie);
     return true;
+
+#endif  // SEQ64_USE_EVENT_VECTOR
 }
 
 #ifdef SEQ64_USE_EVENT_MAP
@@ -319,6 +407,128 @@ event_list::merge (event_list & el, bool /*presort*/ )
         );
         warnprint(tmp);
     }
+    ++m_revision;
+}
+
+#elif defined SEQ64_USE_EVENT_VECTOR
+
+/**
+ *  Provides a merge operation for the sorted event vector.  The events of
+ *  \a el are appended, and the two sorted runs are then merged in place,
+ *  which keeps the existing events ahead of equivalent inserted ones, as
+ *  std::list::merge() does.  Like std::list::merge(), this function empties
+ *  \a el.
+ *
+ * \param el
+ *      Provides the event list to be merged into the current event list.
+ *
+ * \param presort
+ *      If true, the events of \a el are sorted first.  If false, they must
+ *      already be sorted.
+ */
+
+void
+event_list::merge (event_list & el, bool presort)
+{
+    if (presort)
+        std::stable_sort(el.m_events.begin(), el.m_events.end());
+
+    std::size_t middle = m_events.size();
+    m_events.insert(m_events.end(), el.m_events.begin(), el.m_events.end());
+    std::inplace_merge
+    (
+        m_events.begin(), m_events.begin() + middle, m_events.end()
+    );
+    el.clear();
+    if (el.has_tempo())
+        m_has_tempo = true;
+
+    if (el.has_time_signature())
+        m_has_time_signature = true;
+
+    m_is_modified = true;
+    ++m_revision;
+    links_moved();
+}
+
+/**
+ *  Sorts the event vector by time-stamp and rank.  The sort is stable, like
+ *  std::list::sort(), so that events that compare equal keep the order in
+ *  which they were appended.
+ */
+
+void
+event_list::sort ()
+{
+    std::stable_sort(m_events.begin(), m_events.end());
+    ++m_revision;
+    links_moved();
+}
+
+/**
+ *  Inserts an event at its sorted position, after any events that compare
+ *  equal to it.  This replaces the append() and sort() pair that add()
+ *  uses for the std::list implementation, and costs a binary search plus
+ *  the move of the later events.
+ *
+ * \param e
+ *      Provides the event to be inserted.
+ *
+ * \return
+ *      Returns true.
+ */
+
+bool
+event_list::insert (const event & e)
+{
+    m_events.insert(std::upper_bound(m_events.begin(), m_events.end(), e), e);
+    m_is_modified = true;
+    ++m_revision;
+    if (e.is_tempo())
+        m_has_tempo = true;
+
+    if (e.is_time_signature())
+        m_has_time_signature = true;
+
+    links_moved();
+    return true;
+}
+
+/**
+ *  Rebuilds the links between Note On and Note Off events, and between
+ *  tempo events, after the events have moved in memory.  Unlike
+ *  verify_and_link(), this function neither uses nor changes the "marked"
+ *  flags, which the editing functions of the sequence class use while the
+ *  container changes under them, and it prunes nothing.
+ */
+
+void
+event_list::relink ()
+{
+    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
+    {
+        event & e = dref(i);
+        if (! e.is_tempo())                     /* see link_tempos() below  */
+            e.clear_link();
+    }
+    link_notes();
+    link_tempos();
+    m_links_stale = false;
+}
+
+/**
+ *  Called after the events have moved in memory.  Rebuilds the links at
+ *  once, unless hold_links() is in force, in which case the last
+ *  release_links() rebuilds them.
+ */
+
+void
+event_list::links_moved ()
+{
+    if (m_link_holds > 0)
+        m_links_stale = true;
+    else
+        relink();
 }
 
 #else   // SEQ64_USE_EVENT_MAP
@@ -330,69 +540,210 @@ event_list::merge (event_list & el, bool presort)
         el.m_events.sort();
 
     m_events.merge(el.m_events);
+    ++m_revision;
+    ++el.m_revision;
 }
 
 #endif  // SEQ64_USE_EVENT_MAP
 
 /**
- *  Links a new event.  This function checks for a note on, then look for
- *  its note off.  This function is provided in the event_list because it
- *  does not depend on any external data.  Also note that any desired
- *  thread-safety must be provided by the caller.
+ *  Replaces a range of events, given by position, with a sequence of events.
+ *  This function is meant for the event_stack class, which stores only the
+ *  part of an event list that an edit changed.  The replacement events are
+ *  inserted, in order, at the position of the removed range, so that the
+ *  container keeps the layout it had when that range was saved.  The note
+ *  links are not checked; the caller must call verify_and_link() if they
+ *  matter.
+ *
+ * \param first
+ *      The position of the first event to be removed.
+ *
+ * \param count
+ *      The number of events to be removed.
+ *
+ * \param source
+ *      Provides the events to be inserted in place of the removed events.
  */
 
 void
-event_list::link_new ()
+event_list::replace
+(
+    std::size_t first, std::size_t count, const std::vector<event> & source
+)
 {
-    bool endfound = false;
-    for (Events::iterator on = m_events.begin(); on != m_events.end(); ++on)
+    iterator pos = m_events.begin();
+    std::advance(pos, first);
+    iterator last = pos;
+    std::advance(last, count);
+    pos = m_events.erase(pos, last);
+#ifndef SEQ64_USE_EVENT_MAP
+    m_events.insert(pos, source.begin(), source.end());
+#endif
+    for
+    (
+        std::vector<event>::const_iterator ei = source.begin();
+        ei != source.end(); ++ei
+    )
     {
-        event & eon = dref(on);
-        if (eon.is_note_on() && ! eon.is_linked())  /* note on, unlinked?   */
+        const event & e = *ei;
+#ifdef SEQ64_USE_EVENT_MAP
+        m_events.insert(pos, std::make_pair(event_key(e), e));  /* as hint  */
+#endif
+        if (e.is_tempo())
+            m_has_tempo = true;
+
+        if (e.is_time_signature())
+            m_has_time_signature = true;
+    }
+    m_is_modified = true;
+    ++m_revision;
+#ifdef SEQ64_USE_EVENT_VECTOR
+    links_moved();                      /* the later events have moved  */
+#endif
+}
+
+/**
+ *  Links the unlinked Note On events to unlinked Note Off events of the same
+ *  note.  Each Note On, in order, takes the first free Note Off after it,
+ *  or, failing that, the first free one from the start of the pattern,
+ *  which handles notes that wrap around the end of the pattern.
+ *
+ *  This is done in one pass, keeping, for each note, the queue of Note Ons
+ *  still waiting for a Note Off.  A Note Off goes to the oldest waiting Note
+ *  On, which gives the same pairs as searching forward from each Note On.
+ *  The Note Ons still waiting at the end take, in order, the Note Offs that
+ *  were found before any waiting Note On.  The channel is not considered,
+ *  since the events are stored without it.
+ *
+ * \threadunsafe
+ *      As in most case, the caller will use an automutex to call this
+ *      function safely.
+ */
+
+void
+event_list::link_notes ()
+{
+    std::vector<event *> ons[c_midi_notes];     /* Note Ons waiting, FIFO   */
+    std::vector<event *> offs[c_midi_notes];    /* Note Offs left unlinked  */
+    std::size_t head[c_midi_notes] = { 0 };     /* front of each ons queue  */
+    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
+    {
+        event & e = dref(i);
+        if (e.is_linked())
+            continue;
+
+        if (e.is_note_on())
         {
-            Events::iterator off = on;              /* point to note on     */
-            ++off;                                  /* get next element     */
-            endfound = false;
-            while (off != m_events.end())
+            ons[e.get_note()].push_back(&e);
+        }
+        else if (e.is_note_off())
+        {
+            midibyte n = e.get_note();
+            if (head[n] < ons[n].size())
             {
-                event & eoff = dref(off);
-                if                  /* off event, == notes, and not linked  */
-                (
-                    eoff.is_note_off() &&
-                    eoff.get_note() == eoff.get_note() && ! eoff.is_linked()
-                )
-                {
-                    eon.link(&eoff);                /* link backward        */
-                    eoff.link(&eon);                /* link forward         */
-                    endfound = true;                /* note on fulfilled    */
-                    break;
-                }
-                ++off;
+                event * eon = ons[n][head[n]++];
+                eon->link(&e);                  /* link backward            */
+                e.link(eon);                    /* link forward             */
+            }
+            else
+                offs[n].push_back(&e);
+        }
+    }
+    for (int n = 0; n < c_midi_notes; ++n)      /* wrap-around Note Offs    */
+    {
+        std::size_t off = 0;
+        while (head[n] < ons[n].size() && off < offs[n].size())
+        {
+            event * eon = ons[n][head[n]++];
+            event * eoff = offs[n][off++];
+            eon->link(eoff);
+            eoff->link(eon);
+        }
+    }
+}
+
+/**
+ *  Links one new Note On or Note Off event, without going through the whole
+ *  container.  A Note On is linked to the next event of the same note, if
+ *  that is an unlinked Note Off; otherwise it waits for its Note Off.  A
+ *  Note Off is linked to the nearest unlinked Note On of the same note
+ *  before it, wrapping around to the end of the pattern.  When recording,
+ *  the Note On comes first, and is normally just a few events before its
+ *  Note Off.  The Note On used to search the whole pattern, wrapping around,
+ *  for a Note Off that had not been played yet.
+ *
+ * \threadunsafe
+ *
+ * \param ie
+ *      Provides an iterator to the new event.
+ */
+
+void
+event_list::link_event (iterator ie)
+{
+    event & e = dref(ie);
+    if (e.is_linked())
+        return;
+
+    if (e.is_note_on())
+    {
+        iterator i = ie;
+        for (++i; i != m_events.end(); ++i)
+        {
+            event & eoff = dref(i);
+            if (! (eoff.is_note_on() || eoff.is_note_off()))
+                continue;
+
+            if (eoff.get_note() != e.get_note())
+                continue;
+
+            if (eoff.is_note_off() && ! eoff.is_linked())
+            {
+                e.link(&eoff);
+                eoff.link(&e);
             }
-            if (! endfound)
+            break;                              /* next event of the note   */
+        }
+    }
+    else if (e.is_note_off())
+    {
+        iterator i = ie;
+        for (;;)
+        {
+            if (i == m_events.begin())
+                i = m_events.end();             /* wrap around              */
+
+            --i;
+            if (i == ie)
+                break;                          /* no Note On found         */
+
+            event & eon = dref(i);
+            if
+            (
+                eon.is_note_on() &&
+                eon.get_note() == e.get_note() && ! eon.is_linked()
+            )
             {
-                off = m_events.begin();
-                while (off != on)
-                {
-                    event & eoff = dref(off);
-                    if              /* off event, == notes, and not linked  */
-                    (
-                        eoff.is_note_off() &&
-                        eoff.get_note() == eon.get_note() && ! eoff.is_linked()
-                    )
-                    {
-                        eon.link(&eoff);            /* link backward        */
-                        eoff.link(&eon);            /* link forward         */
-                        endfound = true;            /* note on fulfilled    */
-                        break;
-                    }
-                    ++off;
-                }
+                eon.link(&e);
+                e.link(&eon);
+                break;
             }
         }
     }
 }
 
+/**
+ *  Links the new (unlinked) events.  This function is provided in the
+ *  event_list because it does not depend on any external data.  Also note
+ *  that any desired thread-safety must be provided by the caller.
+ */
+
+void
+event_list::link_new ()
+{
+    link_notes();
+}
+
 /**
  *  This function verifies state: all note-ons have an off, and it links
  *  note-offs with their note-ons.
@@ -414,58 +765,11 @@ event_list::link_new ()
 void
 event_list::verify_and_link (midipulse slength)
 {
-    clear_links();
-    for (event_list::iterator on = m_events.begin(); on != m_events.end(); ++on)
-    {
-        event & eon = dref(on);
-        if (eon.is_note_on())               /* Note On, find its Note Off   */
-        {
-            event_list::iterator off = on;  /* next possible Note Off...    */
-            ++off;                          /* ...starting here             */
-            bool endfound = false;
-            while (off != m_events.end())
-            {
-                event & eoff = dref(off);
-                if                          /* Off, == notes, not marked    */
-                (
-                    eoff.is_note_off() &&
-                    eoff.get_note() == eon.get_note() && ! eoff.is_marked()
-                )
-                {
-                    eon.link(&eoff);                    /* link + mark */
-                    eoff.link(&eon);
-                    eon.mark();
-                    eoff.mark();
-                    endfound = true;
-                    break;
-                }
-                ++off;
-            }
-            if (! endfound)
-            {
-                off = m_events.begin();
-                while (off != on)
-                {
-                    event & eoff = dref(off);
-                    if
-                    (
-                        eoff.is_note_off() &&
-                        eoff.get_note() == eon.get_note() && ! eoff.is_marked()
-                    )
-                    {
-                        eon.link(&eoff);                /* link + mark */
-                        eoff.link(&eon);
-                        eon.mark();
-                        eoff.mark();
-                        endfound = true;
-                        break;
-                    }
-                    ++off;
-                }
-            }
-        }
-    }
-    unmark_all();
+    clear_links();                          /* also unmarks all events      */
+    link_notes();
+#ifdef SEQ64_USE_EVENT_VECTOR
+    m_links_stale = false;                  /* the notes are linked afresh  */
+#endif
     mark_out_of_range(slength);
     remove_marked();                        /* prune out-of-range events    */
 
@@ -639,6 +943,20 @@ bool
 event_list::remove_marked ()
 {
     bool result = false;
+#ifdef SEQ64_USE_EVENT_VECTOR
+    Events::iterator i = std::remove_if
+    (
+        m_events.begin(), m_events.end(), std::mem_fn(&event::is_marked)
+    );
+    if (i != m_events.end())
+    {
+        m_events.erase(i, m_events.end());
+        m_is_modified = true;
+        ++m_revision;
+        links_moved();                  /* only once, not per event */
+        result = true;
+    }
+#else
     Events::iterator i = m_events.begin();
     while (i != m_events.end())
     {
@@ -653,6 +971,7 @@ event_list::remove_marked ()
         else
             ++i;
     }
+#endif
     return result;
 }
 
@@ -0,0 +1,226 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_snapshot.cpp
+ *
+ *  This module defines a read-only copy of the events of a sequence, for
+ *  the user-interface views to draw from.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The iteration functions replace the sequence functions that walked the
+ *  shared, unlocked m_iterator_draw member of the sequence.
+ */
+
+#include "calculations.hpp"             /* seq64::tempo_to_note_value()     */
+#include "event_snapshot.hpp"
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Copies the events.  The caller must hold the lock of the sequence that
+ *  owns the events.
+ *
+ * \param events
+ *      The events to copy.
+ *
+ * \param length
+ *      The length of the sequence.
+ *
+ * \param generation
+ *      The change generation of the sequence.
+ *
+ * \param serial
+ *      The count of in-place event changes of the sequence.
+ */
+
+event_snapshot::event_snapshot
+(
+    const event_list & events, midipulse length,
+    unsigned long generation, unsigned long serial
+) :
+    m_generation    (generation),
+    m_revision      (events.revision()),
+    m_serial        (serial),
+    m_length        (length),
+    m_events        (),
+    m_link_ticks    ()
+{
+    m_events.reserve(events.count());
+    m_link_ticks.reserve(events.count());
+    event_list::const_iterator i;
+    for (i = events.begin(); i != events.end(); ++i)
+    {
+        const event & er = DREF(i);
+        m_events.push_back(er);         /* the copy drops the link          */
+        m_link_ticks.push_back
+        (
+            er.is_linked() ? er.get_linked()->get_timestamp() : -1
+        );
+    }
+}
+
+/**
+ *  Finds the next note or tempo event to draw, starting at the given index.
+ *  This is the former sequence::get_next_note_event(), with the iterator
+ *  supplied by the caller.
+ *
+ * \param [in,out] index
+ *      The index to start at, 0 for the first call.  On return, it is the
+ *      index just after the event found.
+ *
+ * \param [out] tick_s
+ *      Provides a pointer destination for the start time.
+ *
+ * \param [out] tick_f
+ *      Provides a pointer destination for the finish time.
+ *
+ * \param [out] note
+ *      Provides a pointer destination for the note pitch value.  If the
+ *      event is the special case of a tempo event, then this value is the
+ *      tempo value scaled to 0 to 127 for display purposes.
+ *
+ * \param [out] selected
+ *      Provides a pointer destination for the selection status of the note.
+ *
+ * \param [out] velocity
+ *      Provides a pointer destination for the note velocity.
+ *
+ * \return
+ *      Returns a draw_type_t value:  DRAW_NORMAL_LINKED, DRAW_NOTE_ON,
+ *      DRAW_NOTE_OFF, DRAW_TEMPO, or DRAW_FIN when there are no more events.
+ */
+
+draw_type_t
+event_snapshot::next_note_event
+(
+    int & index, midipulse & tick_s, midipulse & tick_f,
+    int & note, bool & selected, int & velocity
+) const
+{
+    tick_f = 0;
+    while (index < count())
+    {
+        const event & drawevent = m_events[index];
+        midipulse linktick = m_link_ticks[index];
+        bool isnoteon = drawevent.is_note_on();
+        bool islinked = linktick >= 0;
+        tick_s   = drawevent.get_timestamp();
+        note     = drawevent.get_note();
+        selected = drawevent.is_selected();
+        velocity = drawevent.get_note_velocity();
+        ++index;                                /* go until end or Note On  */
+        if (isnoteon && islinked)
+        {
+            tick_f = linktick;
+            return DRAW_NORMAL_LINKED;
+        }
+        else if (isnoteon && ! islinked)
+        {
+            return DRAW_NOTE_ON;
+        }
+        else if (drawevent.is_note_off() && ! islinked)
+        {
+            return DRAW_NOTE_OFF;
+        }
+        else if (drawevent.is_tempo())
+        {
+            note = int(tempo_to_note_value(drawevent.tempo()));
+            tick_f = islinked ? linktick : m_length ;
+            return DRAW_TEMPO;
+        }
+    }
+    return DRAW_FIN;
+}
+
+/**
+ *  Finds the next event, starting at the given index, that matches the
+ *  given status and control character.  This is the former
+ *  sequence::get_next_event_ex(), with an index instead of an iterator.
+ *  Tempo events always match.  If the status is EVENT_ANY, then any event
+ *  matches.
+ *
+ * \param [in,out] index
+ *      The index to start at, 0 for the first call.  On return, it is the
+ *      index of the event found; the caller must increment it before the
+ *      next call.
+ *
+ * \param status
+ *      The type of event to be obtained.
+ *
+ * \param cc
+ *      The continuous controller value that might be desired.
+ *
+ * \param evtype
+ *      A stazed parameter for picking all events (EVENTS_ALL), unselected
+ *      events (EVENTS_UNSELECTED), or selected events (any greater value).
+ *      Defaults to EVENTS_ALL.
+ *
+ * \return
+ *      Returns true if an event was found.
+ */
+
+bool
+event_snapshot::next_event
+(
+    int & index, midibyte status, midibyte cc,
+    int evtype
+) const
+{
+    for ( ; index < count(); ++index)
+    {
+        const event & drawevent = m_events[index];
+        bool istempo = drawevent.is_tempo();
+        bool ok = drawevent.get_status() == status || istempo;
+        if (! ok)
+            ok = status == EVENT_ANY;
+
+        if (ok)
+        {
+            if (evtype == EVENTS_UNSELECTED && drawevent.is_selected())
+                continue;           /* keep trying to find one              */
+
+            if (evtype > EVENTS_UNSELECTED && ! drawevent.is_selected())
+                continue;           /* keep trying to find one              */
+
+            midibyte d0;
+            drawevent.get_data(d0);
+            if (istempo || event::is_desired_cc_or_not_cc(status, cc, d0))
+                return true;
+        }
+    }
+    return false;
+}
+
+}           // namespace seq64
+
+/*
+ * event_snapshot.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
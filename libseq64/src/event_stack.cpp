@@ -0,0 +1,266 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_stack.cpp
+ *
+ *  This module defines the stack of event lists used for the undo and redo
+ *  facility of the sequence class.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Pushing an entry costs one pass that compares the new list with the top
+ *  entry, without allocating, plus the copying of the changed events only.
+ *  Popping an entry costs a pass to the changed range plus the copying of
+ *  the events that are put back.
+ */
+
+#include "event_stack.hpp"
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Compares the MIDI content of two events.  The editing flags (selected,
+ *  marked, painted) and the links are ignored; the sequence unselects all
+ *  events and rebuilds the links after undo and redo anyway.
+ *
+ * \param a
+ *      The first event to compare.
+ *
+ * \param b
+ *      The second event to compare.
+ *
+ * \return
+ *      Returns true if the events hold the same data.
+ */
+
+static bool
+same_event (const event & a, const event & b)
+{
+    if (a.get_timestamp() != b.get_timestamp())
+        return false;
+
+    if (a.get_status() != b.get_status() || a.get_channel() != b.get_channel())
+        return false;
+
+    midibyte a0, a1, b0, b1;
+    a.get_data(a0, a1);
+    b.get_data(b0, b1);
+    if (a0 != b0 || a1 != b1)
+        return false;
+
+    return a.get_sysex() == b.get_sysex();
+}
+
+/**
+ *  Default constructor.  The stack is empty, and has no memory limit.
+ */
+
+event_stack::event_stack ()
+ :
+    m_deltas    (),
+    m_top       (),
+    m_has_top   (false),
+    m_bytes     (0),
+    m_limit     (0)
+{
+    // Empty body
+}
+
+/**
+ *  Pushes a copy of an event list onto the stack.  If the stack is empty,
+ *  the list is copied in full.  Otherwise, the events that the list and the
+ *  current top entry have in common at the start and at the end are
+ *  skipped.  Only the top entry's events in between are saved, in a new
+ *  delta, and then they are replaced by the new list's events in between,
+ *  making the top entry a copy of the new list.
+ *
+ *  The events in common are found by comparing the two lists from each end,
+ *  which takes O(n) time even for a small edit; see event_stack.hpp.
+ *
+ * \param events
+ *      The event list to push.
+ */
+
+void
+event_stack::push (const event_list & events)
+{
+    if (! m_has_top)
+    {
+        m_top = events;
+        m_has_top = true;
+        return;
+    }
+
+    std::size_t newcount = std::size_t(events.count());
+    std::size_t oldcount = std::size_t(m_top.count());
+    std::size_t common = newcount < oldcount ? newcount : oldcount ;
+    std::size_t prefix = 0;
+    event_list::const_iterator ni = events.begin();
+    event_list::const_iterator oi = m_top.begin();
+    while (prefix < common && same_event(DREF(ni), DREF(oi)))
+    {
+        ++prefix;
+        ++ni;
+        ++oi;
+    }
+
+    std::size_t suffix = 0;
+    event_list::const_iterator ne = events.end();
+    event_list::const_iterator oe = m_top.end();
+    while (suffix < common - prefix)
+    {
+        --ne;
+        --oe;
+        if (! same_event(DREF(ne), DREF(oe)))
+            break;
+
+        ++suffix;
+    }
+
+    undo_delta ud;
+    ud.ud_prefix = prefix;
+    ud.ud_suffix = suffix;
+    ud.ud_events.reserve(oldcount - prefix - suffix);
+    for (std::size_t n = prefix; n < oldcount - suffix; ++n, ++oi)
+        ud.ud_events.push_back(DREF(oi));
+
+    std::vector<event> changed;
+    changed.reserve(newcount - prefix - suffix);
+    for (std::size_t n = prefix; n < newcount - suffix; ++n, ++ni)
+        changed.push_back(DREF(ni));
+
+    m_top.replace(prefix, oldcount - prefix - suffix, changed);
+    m_bytes += cost(ud);
+    m_deltas.push_back(ud);
+    trim();
+}
+
+/**
+ *  Pops the top entry off the stack.  The next entry is restored by
+ *  applying the most recent delta to the top entry.  Must not be called if
+ *  the stack is empty.
+ */
+
+void
+event_stack::pop ()
+{
+    if (m_deltas.empty())
+    {
+        clear();
+    }
+    else
+    {
+        const undo_delta & ud = m_deltas.back();
+        std::size_t count = std::size_t(m_top.count());
+        m_top.replace
+        (
+            ud.ud_prefix, count - ud.ud_prefix - ud.ud_suffix, ud.ud_events
+        );
+        m_bytes -= cost(ud);
+        m_deltas.pop_back();
+    }
+}
+
+/**
+ *  Empties the stack.
+ */
+
+void
+event_stack::clear ()
+{
+    m_deltas.clear();
+    m_top.clear();
+    m_has_top = false;
+    m_bytes = 0;
+}
+
+/**
+ * \setter m_limit
+ *
+ * \param kilobytes
+ *      The maximum size of the deltas, in kilobytes, or 0 (or any negative
+ *      value) for no limit.  If the stack is already larger, its oldest
+ *      entries are dropped.
+ */
+
+void
+event_stack::limit (int kilobytes)
+{
+    m_limit = kilobytes > 0 ? std::size_t(kilobytes) * 1024 : 0 ;
+    trim();
+}
+
+/**
+ *  Estimates the memory used by a delta, including the SysEx/Meta data of
+ *  its events.  Since that data is shared with the copies of an event, this
+ *  estimate errs on the high side.
+ *
+ * \param ud
+ *      The delta to be measured.
+ *
+ * \return
+ *      Returns the approximate number of bytes used by the delta.
+ */
+
+std::size_t
+event_stack::cost (const undo_delta & ud)
+{
+    std::size_t result = sizeof(undo_delta);
+    for
+    (
+        std::vector<event>::const_iterator ei = ud.ud_events.begin();
+        ei != ud.ud_events.end(); ++ei
+    )
+    {
+        result += sizeof(event) + std::size_t(ei->get_sysex_size());
+    }
+    return result;
+}
+
+/**
+ *  Drops the oldest entries of the stack until the deltas fit within the
+ *  memory limit.  The top entry is always kept.
+ */
+
+void
+event_stack::trim ()
+{
+    while (m_limit > 0 && m_bytes > m_limit && ! m_deltas.empty())
+    {
+        m_bytes -= cost(m_deltas.front());
+        m_deltas.pop_front();
+    }
+}
+
+}           // namespace seq64
+
+/*
+ * event_stack.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
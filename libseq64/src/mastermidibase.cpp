@@ -73,12 +73,23 @@ mastermidibase::mastermidibase
     m_master_clocks     (),
     m_master_inputs     (),
     m_queue             (0),
+    m_scheduled_output  (false),
+    m_lookahead_ms      (0),
     m_ppqn              (choose_ppqn(ppqn)),
     m_beats_per_minute  (bpm),          /* beats per minute                 */
     m_dumping_input     (false),
     m_vector_sequence   (),             /* stazed feature                   */
     m_filter_by_channel (false),        /* set based on configuration       */
     m_seq               (nullptr),
+    m_output_batch      (SEQ64_OUTPUT_BATCH_MAX),
+    m_render            (nullptr),
+    m_render_tick       (0),
+    m_events_sent       (0),
+    m_input_wakeup      (),
+    m_input_arrival_us  (0),
+    m_input_batches     (0),
+    m_input_total_us    (0),
+    m_input_max_us      (0),
     m_mutex             ()
 {
     // Empty body now
@@ -179,7 +190,9 @@ mastermidibase::stop ()
 /**
  *  Generates the MIDI clock for each of the output busses.  Also calls the
  *  api_clock() function, which does nothing for the original ALSA
- *  implementation and the PortMidi implementation.
+ *  implementation and the PortMidi implementation.  In the scheduled-output
+ *  mode, the clock goes through the same queue, with the same lookahead, as
+ *  the events played, so that it stays in step with the notes.
  *
  * \threadsafe
  *
@@ -192,7 +205,10 @@ mastermidibase::emit_clock (midipulse tick)
 {
     automutex locker(m_mutex);
     api_clock();
-    m_outbus_array.clock(tick);
+    if (m_scheduled_output)
+        m_outbus_array.clock(tick, lookahead_ticks());
+    else
+        m_outbus_array.clock(tick);
 }
 
 /**
@@ -232,9 +248,10 @@ mastermidibase::set_beats_per_minute (midibpm bpm)
 }
 
 /**
- *  Flushes our local queue events out  The implementation-specific API
- *  function is called.  For example, ALSA provides a function to "drain" the
- *  output.
+ *  Flushes our local queue events out.  First the output batch filled by
+ *  post() is played, in order, on the output busses.  Then the
+ *  implementation-specific API function is called.  For example, ALSA
+ *  provides a function to "drain" the output.
  *
  * \threadsafe
  */
@@ -243,9 +260,32 @@ void
 mastermidibase::flush ()
 {
     automutex locker(m_mutex);
+    play_batch();
     api_flush();
 }
 
+/**
+ *  Starts or stops the capture of the output for an offline render.  While
+ *  capturing, play_event() appends each channel message to the given vector,
+ *  stamped with the tick set by capture_tick(), instead of sending it to its
+ *  buss.  SysEx and clock messages are not captured.
+ *
+ * \threadsafe
+ *
+ * \param messages
+ *      The vector to capture the messages into, or a null pointer to resume
+ *      normal output.  It must exist until the capture is stopped.
+ */
+
+void
+mastermidibase::capture_output (std::vector<render_message> * messages)
+{
+    automutex locker(m_mutex);
+    play_batch();                       /* do not capture earlier events    */
+    m_render = messages;
+    m_render_tick = 0;
+}
+
 /**
  *  Handle the sending of SYSEX events.  The event is sent to all MIDI output
  *  busses.  Then flush() is called.
@@ -268,7 +308,9 @@ mastermidibase::sysex (event * ev)
 
 /**
  *  Handle the playing of MIDI events on the MIDI buss given by the
- *  parameter, as long as it is a legal buss number.
+ *  parameter, as long as it is a legal buss number.  Any events waiting in
+ *  the output batch are played first, so that, for example, a Note Off sent
+ *  by the user interface cannot overtake the Note On it ends.
  *
  *  There's currently no implementation-specific API function here.
  *
@@ -284,13 +326,181 @@ mastermidibase::sysex (event * ev)
  *
  * \param channel
  *      The channel on which to play the event.
+ *
+ * \param late
+ *      How many ticks the event is behind its due time, as known by the
+ *      caller.  Used only in the scheduled-output mode, where the event is
+ *      scheduled to go out m_lookahead_ms after its due time, and where
+ *      events played outside of sequence::play() (late = 0) go through the
+ *      same queue so that they cannot overtake the scheduled ones.
  */
 
 void
-mastermidibase::play (bussbyte bus, event * e24, midibyte channel)
+mastermidibase::play
+(
+    bussbyte bus, event * e24, midibyte channel, midipulse late
+)
 {
     automutex locker(m_mutex);
-    m_outbus_array.play(bus, e24, channel);
+    play_batch();                       /* do not overtake batched events   */
+    play_event(bus, e24, channel, late);
+}
+
+/**
+ *  The body of play(), without the locking.  During an offline render the
+ *  event is captured instead; see capture_output().
+ *
+ * \threadunsafe
+ *      The caller holds m_mutex.
+ *
+ * \param bus
+ *      The buss to start play on.
+ *
+ * \param e24
+ *      The seq24 event to play on the buss.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param late
+ *      How many ticks the event is behind its due time.
+ */
+
+void
+mastermidibase::play_event
+(
+    bussbyte bus, event * e24, midibyte channel, midipulse late
+)
+{
+    if (not_nullptr(m_render))
+    {
+        render_message rm;
+        midipulse tick = m_render_tick - late;
+        rm.rm_tick = tick > 0 ? tick : 0 ;
+        rm.rm_bus = bus;
+        rm.rm_status = e24->get_status() + (channel & 0x0F);
+        e24->get_data(rm.rm_d0, rm.rm_d1);
+        rm.rm_size = e24->is_two_bytes() ? 3 : 2 ;
+        m_render->push_back(rm);
+    }
+    else if (m_scheduled_output)
+    {
+        m_events_sent.fetch_add(1, std::memory_order_relaxed);
+        midipulse ahead = lookahead_ticks();
+        midipulse delay = ahead > late ? ahead - late : 0 ;
+        m_outbus_array.play(bus, e24, channel, delay);
+    }
+    else
+    {
+        m_events_sent.fetch_add(1, std::memory_order_relaxed);
+        m_outbus_array.play(bus, e24, channel);
+    }
+}
+
+/**
+ *  Converts the lookahead of the scheduled-output mode to ticks at the
+ *  current tempo.
+ *
+ * \return
+ *      Returns m_lookahead_ms in ticks.
+ */
+
+midipulse
+mastermidibase::lookahead_ticks () const
+{
+    return midipulse
+    (
+        double(m_lookahead_ms) * m_beats_per_minute * m_ppqn / 60000.0
+    );
+}
+
+/**
+ *  Provides the time from the playing of an event to its being heard, in
+ *  ticks at the current tempo:  the lookahead of the scheduled-output mode,
+ *  if it is on, plus the delay that the MIDI API adds to every message (one
+ *  process period for JACK).  Used by perform::input_tick() to record an
+ *  event at the tick the player was hearing.
+ *
+ * \threadsafe
+ *      Only reads settings that change while stopped, and the tempo.
+ *
+ * \return
+ *      Returns the output latency in ticks.
+ */
+
+midipulse
+mastermidibase::output_latency_ticks () const
+{
+    midipulse result = m_scheduled_output ? lookahead_ticks() : 0 ;
+    double us = double(api_output_latency_us());
+    result += midipulse(us * m_beats_per_minute * m_ppqn / 60000000.0);
+    return result;
+}
+
+/**
+ *  Plays, in order, all of the channel messages waiting in the output batch.
+ *  See post().
+ *
+ * \threadunsafe
+ *      The caller holds m_mutex, which serializes the consumers of the
+ *      batch.
+ */
+
+void
+mastermidibase::play_batch ()
+{
+    if (! m_output_batch.empty())
+    {
+        event e;
+        do
+        {
+            const batch_message & bm = m_output_batch.front();
+            e.set_status(bm.bm_status);
+            e.set_data(bm.bm_d0, bm.bm_d1);
+            play_event(bm.bm_bus, &e, bm.bm_channel, bm.bm_late);
+            m_output_batch.pop();
+
+        } while (! m_output_batch.empty());
+    }
+}
+
+/**
+ *  Adds a channel message to the output batch, to be played by the next
+ *  flush().  Unlike play(), this function does not lock; it is meant only
+ *  for the output thread, via sequence::play(), which is the only producer
+ *  of the batch.  If the batch is full, it is flushed first.
+ *
+ * \param bus
+ *      The buss on which to play the event.  Checked when flushed.
+ *
+ * \param ev
+ *      The event to play.  Only its status and data bytes are copied, so it
+ *      must not be a SysEx or Meta event.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param late
+ *      How many ticks the event is behind its due time.  See play().
+ */
+
+void
+mastermidibase::post
+(
+    bussbyte bus, const event & ev, midibyte channel, midipulse late
+)
+{
+    batch_message bm;
+    bm.bm_bus = bus;
+    bm.bm_status = ev.get_status();
+    bm.bm_channel = channel;
+    ev.get_data(bm.bm_d0, bm.bm_d1);
+    bm.bm_late = late;
+    if (! m_output_batch.push(bm))
+    {
+        flush();                                /* batch is full            */
+        (void) m_output_batch.push(bm);
+    }
 }
 
 /**
@@ -555,6 +765,10 @@ mastermidibase::print () const
  *
  *  Do we need to use a mutex lock?  NO!  It causes a deadlock!!!
  *
+ *  If input is found and the implementation signalled m_input_wakeup for
+ *  it, the time of the signal is kept, so that input_handled() can measure
+ *  the input latency.
+ *
  * \return
  *      Returns the result of the poll, or 0 if the API is not supported.
  */
@@ -562,7 +776,35 @@ mastermidibase::print () const
 int
 mastermidibase::poll_for_midi ()
 {
-    return api_poll_for_midi();
+    int result = api_poll_for_midi();
+    if (result > 0)
+    {
+        std::int64_t signalled = m_input_wakeup.take_signal_time();
+        if (m_input_arrival_us == 0)
+            m_input_arrival_us = signalled;
+    }
+    return result;
+}
+
+/**
+ *  Called by the input thread when it has handled all of the pending
+ *  input.  Adds the time from the signalling of that input to now to the
+ *  input latency statistics.  Does nothing if the input was not signalled
+ *  (e.g. with ALSA).
+ */
+
+void
+mastermidibase::input_handled ()
+{
+    if (m_input_arrival_us != 0)
+    {
+        std::int64_t latency = wakeup_event::now_us() - m_input_arrival_us;
+        m_input_arrival_us = 0;
+        m_input_batches.fetch_add(1, std::memory_order_relaxed);
+        m_input_total_us.fetch_add(latency, std::memory_order_relaxed);
+        if (latency > m_input_max_us.load(std::memory_order_relaxed))
+            m_input_max_us.store(latency, std::memory_order_relaxed);
+    }
 }
 
 /**
@@ -642,6 +884,11 @@ mastermidibase::port_exit (int client, int port)
 /**
  *  Grab a MIDI event via the currently-selected MIDI API.
  *
+ *  Until the caller converts it to a tick (see perform::input_tick()), the
+ *  timestamp of the event is its arrival time, in wakeup_event::now_us()
+ *  microseconds.  JACK provides the time of the event's frame; ALSA, the
+ *  time the event was read.
+ *
  * \param ev
  *      The event to be set based on the found input event.
  */
@@ -46,6 +46,40 @@
 namespace seq64
 {
 
+/**
+ *  Default constructor.  Sets 4/4 time at 120 BPM.
+ */
+
+track_timing::track_timing ()
+ :
+    tt_beats_per_bar        (SEQ64_DEFAULT_BEATS_PER_MEASURE),
+    tt_beat_width           (SEQ64_DEFAULT_BEAT_WIDTH),
+    tt_clocks_per_metronome (24),
+    tt_32nds_per_quarter    (8),
+    tt_us_per_quarter_note  (tempo_us_from_bpm(SEQ64_DEFAULT_BPM))
+{
+    // Empty body
+}
+
+/**
+ *  Copies the timing values of a performance.  Must be called by a thread
+ *  that may read the performance.
+ *
+ * \param p
+ *      The performance whose values are copied.
+ */
+
+track_timing::track_timing (const perform & p)
+ :
+    tt_beats_per_bar        (p.get_beats_per_bar()),
+    tt_beat_width           (p.get_beat_width()),
+    tt_clocks_per_metronome (p.clocks_per_metronome()),
+    tt_32nds_per_quarter    (p.get_32nds_per_quarter()),
+    tt_us_per_quarter_note  (p.us_per_quarter_note())
+{
+    // Empty body
+}
+
 /**
  *  Fills in the few members of this class.
  *
@@ -276,16 +310,16 @@ midi_container::fill_meta_track_end (midipulse deltatime)
 void
 midi_container::fill_time_sig_and_tempo
 (
-    const perform & p,
+    const track_timing & tt,
     bool has_time_sig,
     bool has_tempo
 )
 {
     if (! has_tempo)
-        fill_tempo(p);
+        fill_tempo(tt);
 
     if (! has_time_sig)
-        fill_time_sig(p);
+        fill_time_sig(tt);
 }
 
 
@@ -297,18 +331,17 @@ midi_container::fill_time_sig_and_tempo
  *  usage in this particular track.  For export, we cannot guarantee that the
  *  first (0th) track/sequence is exportable.
  *
- * \param p
- *      Provides the performance object from which we get some global MIDI
- *      parameters.
+ * \param tt
+ *      Provides the global MIDI parameters, copied from the performance.
  */
 
 void
-midi_container::fill_time_sig (const perform & p)
+midi_container::fill_time_sig (const track_timing & tt)
 {
-    int beatwidth = p.get_beat_width();
-    int bpb = p.get_beats_per_bar();;
-    int cpm = p.clocks_per_metronome();
-    int get32pq = p.get_32nds_per_quarter();
+    int beatwidth = tt.tt_beat_width;
+    int bpb = tt.tt_beats_per_bar;
+    int cpm = tt.tt_clocks_per_metronome;
+    int get32pq = tt.tt_32nds_per_quarter;
     int bw = log2_time_sig_value(beatwidth);
     add_variable(0);                            /* delta time       */
     put(0xFF);                                  /* meta event       */
@@ -333,16 +366,15 @@ midi_container::fill_time_sig (const perform & p)
  *      Accidentally committed along with fruity changes, sigh, so go back a
  *      couple of commits to see the changes.
  *
- * \param p
- *      Provides the performance object from which we get some global MIDI
- *      parameters.
+ * \param tt
+ *      Provides the global MIDI parameters, copied from the performance.
  */
 
 void
-midi_container::fill_tempo (const perform & p)
+midi_container::fill_tempo (const track_timing & tt)
 {
     midibyte t[4];                              /* hold tempo bytes */
-    int usperqn = p.us_per_quarter_note();
+    int usperqn = tt.tt_us_per_quarter_note;
     tempo_us_to_bytes(t, usperqn);
     add_variable(0);                            /* delta time       */
     put(0xFF);                                  /* meta event       */
@@ -668,6 +700,27 @@ midi_container::song_fill_seq_trigger
 
 void
 midi_container::fill (int track, const perform & p)
+{
+    fill(track, track_timing(p));
+}
+
+/**
+ *  Fills the track as fill(int, const perform &) does, using timing values
+ *  copied from the performance earlier, so that the performance itself is
+ *  not read.  midifile::write_snapshot() uses it on the autosave thread.
+ *
+ * 	hreadunsafe
+ *      As for the other overload.
+ *
+ * \param track
+ *      Provides the track number, re 0.
+ *
+ * \param tt
+ *      The tempo and time signature to write to the first track.
+ */
+
+void
+midi_container::fill (int track, const track_timing & tt)
 {
     event_list evl = m_sequence.events();           /* used below */
     fill_seq_number(track);
@@ -683,7 +736,7 @@ midi_container::fill (int track, const perform & p)
 
     if (track == 0 && ! rc().legacy_format())
     {
-        fill_time_sig_and_tempo(p, evl.has_time_signature(), evl.has_tempo());
+        fill_time_sig_and_tempo(tt, evl.has_time_signature(), evl.has_tempo());
     }
 
     midipulse timestamp = 0;
@@ -552,13 +552,21 @@ midibase::print ()
  *
  * \param channel
  *      The channel of the playback.
+ *
+ * \param delay
+ *      If SEQ64_NULL_MIDIPULSE (the default), the event is sent immediately.
+ *      Otherwise it is scheduled to be sent this many ticks from now; see
+ *      the scheduled-output mode of mastermidibase::play().
  */
 
 void
-midibase::play (event * e24, midibyte channel)
+midibase::play (event * e24, midibyte channel, midipulse delay)
 {
     automutex locker(m_mutex);
-    api_play(e24, channel);
+    if (is_null_midipulse(delay))
+        api_play(e24, channel);
+    else
+        api_play_scheduled(e24, channel, delay);
 }
 
 /**
@@ -725,10 +733,17 @@ midibase::stop ()
  *
  * \param tick
  *      Provides the starting tick.
+ *
+ * \param ahead
+ *      If SEQ64_NULL_MIDIPULSE (the default), the clocks are sent
+ *      immediately.  Otherwise, this is the lookahead of the scheduled-output
+ *      mode, in ticks; each clock is scheduled to go out that long after its
+ *      own tick, which is earlier than \a tick when the output thread is
+ *      late, just as the notes are in mastermidibase::play().
  */
 
 void
-midibase::clock (midipulse tick)
+midibase::clock (midipulse tick, midipulse ahead)
 {
     automutex locker(m_mutex);
     if (m_clock_type != e_clock_off)
@@ -740,7 +755,18 @@ midibase::clock (midipulse tick)
             ++m_lasttick;
             done = m_lasttick >= tick;
             if ((m_lasttick % ct) == 0)                 /* tick time?           */
-                api_clock(tick);
+            {
+                if (is_null_midipulse(ahead))
+                {
+                    api_clock(tick);
+                }
+                else
+                {
+                    midipulse late = tick - m_lasttick;
+                    midipulse delay = ahead > late ? ahead - late : 0 ;
+                    api_clock_scheduled(tick, delay);
+                }
+            }
         }
         api_flush();            /* and send out */
     }
@@ -52,28 +52,34 @@
  *          -   Sequence events.
  */
 
+#include <algorithm>                    /* std::stable_sort()               */
+#include <atomic>                       /* std::atomic<int> track counter   */
+#include <chrono>                       /* std::chrono::steady_clock        */
 #include <fstream>
+#include <map>                          /* std::map of rendered tracks      */
 
 #include "app_limits.h"                 /* SEQ64_USE_MIDI_VECTOR            */
+#include "autosave.hpp"                 /* seq64::song_snapshot             */
 #include "calculations.hpp"             /* bpm_from_tempo_us()              */
 #include "perform.hpp"                  /* must precede midifile.hpp !      */
 #include "midifile.hpp"                 /* seq64::midifile                  */
 #include "sequence.hpp"                 /* seq64::sequence                  */
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
 
+#ifdef PLATFORM_POSIX_API
+#include <errno.h>                      /* errno, EINTR                     */
+#include <fcntl.h>                      /* open()                           */
+#include <sys/mman.h>                   /* mmap(), munmap(), madvise()      */
+#include <sys/stat.h>                   /* fstat()                          */
+#include <unistd.h>                     /* close(), fsync(), write()        */
+#endif
+
 #ifdef SEQ64_USE_MIDI_VECTOR
 #include "midi_vector.hpp"              /* seq64::midi_vector container     */
 #else
 #include "midi_list.hpp"                /* seq64::midi_list container       */
 #endif
 
-/**
- *  A manifest constant for controlling the length of a line-reading
- *  array in a configuration file.
- */
-
-#define SEQ64_MIDI_LINE_MAX         1024
-
 /**
  *  The maximum length of a Seq24 track name.  This is a bit excessive.
  */
@@ -87,6 +93,20 @@
 
 #define SEQ64_VARLENGTH_MAX         0x0FFFFFFF
 
+/**
+ *  The largest number of threads, counting the calling thread, that fill
+ *  the track containers when a file is written.
+ */
+
+#define SEQ64_FILL_THREADS_MAX      8
+
+/**
+ *  The number of tracks that justify one more filling thread.  Below this
+ *  number, the calling thread fills all of the tracks itself.
+ */
+
+#define SEQ64_FILL_TRACKS_PER_THREAD 32
+
 /**
  *  Highlights the MIDI file header value, "MThd".
  */
@@ -188,8 +208,10 @@ midifile::midifile
     m_disable_reported          (false),
     m_pos                       (0),
     m_name                      (name),
-    m_data                      (),
-    m_char_list                 (),
+    m_data                      (nullptr),
+    m_file_data                 (),
+    m_mapping                   (nullptr),
+    m_char_vector               (),
     m_new_format                (! oldformat),
     m_global_bgsequence         (globalbgs),
     m_ppqn                      (0),
@@ -205,7 +227,7 @@ midifile::midifile
 
 midifile::~midifile ()
 {
-    // empty body
+    close_data();
 }
 
 /**
@@ -358,6 +380,9 @@ midifile::read_varinum ()
  *      tune, and locate it in a specific screen-set.  If this parameter is
  *      non-zero, then we will assume that the perform data is dirty.
  *
+ *  With the --stats option, the size of the file and the time it took to
+ *  load it are shown on the console.
+ *
  * \return
  *      Returns true if the parsing succeeded.  Note that the error status is
  *      saved in m_error_is_fatal, and a message (to display later) is saved
@@ -367,12 +392,151 @@ midifile::read_varinum ()
 bool
 midifile::parse (perform & p, int screenset)
 {
-    bool result = true;
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    m_error_is_fatal = false;
+    bool result = open_data();
+    if (! result)
+        return false;
+
+    m_error_message.clear();
+    m_disable_reported = false;
+    m_smf0_splitter.initialize();                   /* SMF 0 support        */
+
+    midilong ID = read_long();                      /* read hdr chunk info  */
+    midilong hdrlength = read_long();               /* stock MThd length    */
+    if (ID != SEQ64_MTHD_TAG && hdrlength != 6)     /* magic number 'MThd'  */
+    {
+        m_error_is_fatal = true;
+        errdump("Invalid MIDI header chunk detected", ID);
+        result = false;
+    }
+    else
+    {
+        midishort Format = read_short();            /* 0, 1, or 2           */
+        if (Format == 0)
+        {
+            result = parse_smf_0(p, screenset);
+        }
+        else if (Format == 1)
+        {
+            result = parse_smf_1(p, screenset);
+        }
+        else
+        {
+            m_error_is_fatal = true;
+            errdump("Unsupported MIDI format number", midilong(Format));
+            result = false;
+        }
+    }
+    if (result)
+    {
+        if (m_file_size > m_pos)                    /* any more data left?  */
+            result = parse_proprietary_track(p, m_file_size);
+
+        if (result && screenset != 0)
+             p.modify();                            /* modification flag    */
+    }
+
+    bool mapped = not_nullptr(m_mapping);
+    close_data();
+    if (rc().stats())
+    {
+        long us = long
+        (
+            std::chrono::duration_cast<std::chrono::microseconds>
+            (
+                std::chrono::steady_clock::now() - start
+            ).count()
+        );
+        printf
+        (
+            "[Loaded '%s': %d bytes, %s, in %ld us]\n",
+            m_name.c_str(), m_file_size, mapped ? "mapped" : "read", us
+        );
+    }
+    return result;
+}
+
+/**
+ *  Makes the MIDI file available for parsing, setting m_data and
+ *  m_file_size.  On POSIX systems, the file is mapped into memory read-only,
+ *  so that the parser reads the bytes straight from the page cache, without
+ *  copying the whole file into a buffer first.  If the mapping fails, or on
+ *  other systems, the file is read with read_data().
+ *
+ * \return
+ *      Returns true if the data is available.  Otherwise, the error message
+ *      and the fatal-error flag are set.
+ */
+
+bool
+midifile::open_data ()
+{
+    close_data();
+
+#ifdef PLATFORM_POSIX_API
+
+    int fd = open(m_name.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        m_error_is_fatal = true;
+        m_error_message = "Error opening MIDI file '";
+        m_error_message += m_name;
+        m_error_message += "'";
+        errprint(m_error_message.c_str());
+        return false;
+    }
+
+    struct stat sb;
+    bool ok = fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode);
+    if (! ok || size_t(sb.st_size) <= sizeof(long))
+    {
+        close(fd);
+        m_error_is_fatal = true;
+        m_error_message = "Invalid file size... trying to read a directory?";
+        errprint(m_error_message.c_str());
+        return false;
+    }
+
+    void * mapping = mmap
+    (
+        nullptr, size_t(sb.st_size), PROT_READ, MAP_PRIVATE, fd, 0
+    );
+    close(fd);                                      /* mapping stays valid  */
+    if (mapping != MAP_FAILED)
+    {
+#ifdef MADV_SEQUENTIAL
+        (void) madvise(mapping, size_t(sb.st_size), MADV_SEQUENTIAL);
+#endif
+        m_mapping = mapping;
+        m_data = static_cast<const midibyte *>(mapping);
+        m_file_size = int(sb.st_size);
+        return true;
+    }
+
+#endif  // PLATFORM_POSIX_API
+
+    return read_data();
+}
+
+/**
+ *  Reads the whole MIDI file into the m_file_data buffer, and points m_data
+ *  to it.  This is the fallback for open_data().
+ *
+ * \return
+ *      Returns true if the file was read.  Otherwise, the error message and
+ *      the fatal-error flag are set.
+ */
+
+bool
+midifile::read_data ()
+{
     std::ifstream file
     (
         m_name.c_str(), std::ios::in | std::ios::binary | std::ios::ate
     );
-    m_error_is_fatal = false;
     if (! file.is_open())
     {
         m_error_is_fatal = true;
@@ -394,7 +558,7 @@ midifile::parse (perform & p, int screenset)
     file.seekg(0, std::ios::beg);                   /* seek to start        */
     try
     {
-        m_data.resize(file_size);                   /* allocate more data   */
+        m_file_data.resize(file_size);              /* allocate more data   */
         m_file_size = file_size;                    /* save for checking    */
     }
     catch (const std::bad_alloc & ex)
@@ -404,45 +568,28 @@ midifile::parse (perform & p, int screenset)
         errprint(m_error_message.c_str());
         return false;
     }
-    file.read((char *)(&m_data[0]), file_size);     /* vector == array :-)  */
+    file.read((char *)(&m_file_data[0]), file_size); /* vector == array :-) */
     file.close();
-    m_error_message.clear();
-    m_disable_reported = false;
-    m_smf0_splitter.initialize();                   /* SMF 0 support        */
-
-    midilong ID = read_long();                      /* read hdr chunk info  */
-    midilong hdrlength = read_long();               /* stock MThd length    */
-    if (ID != SEQ64_MTHD_TAG && hdrlength != 6)     /* magic number 'MThd'  */
-    {
-        m_error_is_fatal = true;
-        errdump("Invalid MIDI header chunk detected", ID);
-        return false;
-    }
+    m_data = &m_file_data[0];
+    return true;
+}
 
-    midishort Format = read_short();                /* 0, 1, or 2           */
-    if (Format == 0)
-    {
-        result = parse_smf_0(p, screenset);
-    }
-    else if (Format == 1)
-    {
-        result = parse_smf_1(p, screenset);
-    }
-    else
-    {
-        m_error_is_fatal = true;
-        errdump("Unsupported MIDI format number", midilong(Format));
-        result = false;
-    }
-    if (result)
-    {
-        if (file_size > m_pos)                      /* any more data left?  */
-            result = parse_proprietary_track(p, file_size);
+/**
+ *  Releases the MIDI data obtained by open_data(), unmapping the file or
+ *  freeing the buffer.  The file size is kept for reporting.
+ */
 
-        if (result && screenset != 0)
-             p.modify();                            /* modification flag    */
-    }
-    return result;
+void
+midifile::close_data ()
+{
+#ifdef PLATFORM_POSIX_API
+    if (not_nullptr(m_mapping))
+        (void) munmap(m_mapping, size_t(m_file_size));
+#endif
+    m_mapping = nullptr;
+    m_data = nullptr;
+    std::vector<midibyte>().swap(m_file_data);      /* release the memory   */
+    m_pos = 0;
 }
 
 /**
@@ -628,11 +775,34 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
             }
             sequence & seq = *s;                /* references are nicer     */
             seq.set_master_midi_bus(&p.master_bus());   /* set master buss  */
+
+            /*
+             * Pre-size the event storage from the track length.  With
+             * running status, a channel event takes 3 bytes or so.  A
+             * track length that runs past the end of the file is reported,
+             * and parsing goes on, up to the End-of-Track or the end of the
+             * file, as before.
+             */
+
+            midilong remaining = midilong(m_file_size - m_pos);
+            if (TrackLength > remaining)
+            {
+                errdump("Track length exceeds the file size", TrackLength);
+                seq.reserve_events(int(remaining / 3));
+            }
+            else
+                seq.reserve_events(int(TrackLength / 3));
+
             RunningTime = 0;                    /* reset time               */
             while (! done)                      /* get each event in track  */
             {
                 event e;                        /* safer here, if "slower"  */
                 Delta = read_varinum();         /* get time delta           */
+                if (m_pos >= m_file_size)       /* do not read past the end */
+                {
+                    errdump("Unexpected end of file in track");
+                    return false;
+                }
                 laststatus = status;
                 status = m_data[m_pos];         /* get next status byte     */
                 if ((status & 0x80) == 0x00)    /* is it a status bit ?     */
@@ -982,7 +1152,7 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
                             m_pos += len;               /* skip the rest    */
 #else
                             m_pos += len;               /* skip it          */
-                            if (m_data[m_pos-1] != 0xF7)
+                            if (m_pos > m_file_size || m_data[m_pos-1] != 0xF7)
                                 errdump("SysEx terminator byte F7 not found");
 #endif
                         }
@@ -1294,6 +1464,7 @@ midifile::parse_proprietary_track (perform & p, int file_size)
                 read_byte_array(a, 6);
                 p.midi_control_off(i).set(a);
             }
+            p.midi_controls_changed();
         }
         seqspec = parse_prop_header(file_size);
         if (seqspec == c_midiclocks)
@@ -1781,15 +1952,16 @@ midifile::write_prop_header
     write_long(control_tag);                /* use legacy output call       */
 }
 
+/**
+ *  Writes a track chunk:  the "MTrk" tag, the size of the track, and the
+ *  bytes of a filled container.
+ *
+ * \param lst
+ *      The container holding the track data.
+ */
+
 void
-midifile::write_track
-(
-#if defined SEQ64_USE_MIDI_VECTOR
-    const midi_vector & lst
-#else
-    const midi_list & lst
-#endif
-)
+midifile::write_track (const midi_container & lst)
 {
     midilong tracksize = midilong(lst.size());
     write_long(SEQ64_MTRK_TAG);             /* magic number 'MTrk'          */
@@ -1798,6 +1970,223 @@ midifile::write_track
         write_byte(lst.get());
 }
 
+/**
+ *  The shared state of the threads filling the track containers for
+ *  midifile::write().  Each thread claims the next container through the
+ *  atomic counter, so no two threads fill the same one.
+ */
+
+struct track_fill_job
+{
+    const perform * tfj_perform;                /**< The song being saved.  */
+    std::vector<midi_container *> * tfj_tracks; /**< Containers to fill.    */
+    const std::vector<int> * tfj_numbers;       /**< Their track numbers.   */
+    std::atomic<int> tfj_next;                  /**< Next one to claim.     */
+};
+
+/**
+ *  Fills track containers until none is left to claim.  Called by each
+ *  filling thread, including the calling thread of fill_tracks().
+ *
+ * \param job
+ *      The shared state of the filling threads.
+ */
+
+static void
+fill_claimed_tracks (track_fill_job & job)
+{
+    int count = int(job.tfj_tracks->size());
+    for (;;)
+    {
+        int t = job.tfj_next.fetch_add(1);
+        if (t >= count)
+            break;
+
+        (*job.tfj_tracks)[t]->fill((*job.tfj_numbers)[t], *job.tfj_perform);
+    }
+}
+
+/**
+ *  The function run by the extra filling threads.
+ *
+ * \param myjob
+ *      Provides the track_fill_job to work on.
+ *
+ * \return
+ *      Always returns a null pointer.
+ */
+
+static void *
+fill_thread_func (void * myjob)
+{
+    fill_claimed_tracks(*static_cast<track_fill_job *>(myjob));
+    return nullptr;
+}
+
+/**
+ *  Fills the track containers of midifile::write().  Each container is
+ *  filled from its own sequence, and midi_container::fill() only reads the
+ *  sequence and the performance, so the containers can be filled at the
+ *  same time.  One thread is used per SEQ64_FILL_TRACKS_PER_THREAD tracks,
+ *  up to the number of processors and SEQ64_FILL_THREADS_MAX.  The calling
+ *  thread is one of them, and it waits for the others before returning, so
+ *  that the caller can then write the containers out in track order.
+ *
+ * \param p
+ *      The performance being saved.
+ *
+ * \param tracks
+ *      The containers to fill.
+ *
+ * \param numbers
+ *      The track number of each container.
+ *
+ * \return
+ *      Returns the number of threads that did the filling.
+ */
+
+static int
+fill_tracks
+(
+    const perform & p,
+    std::vector<midi_container *> & tracks,
+    const std::vector<int> & numbers
+)
+{
+    track_fill_job job;
+    job.tfj_perform = &p;
+    job.tfj_tracks = &tracks;
+    job.tfj_numbers = &numbers;
+    job.tfj_next = 0;
+
+    int threads = int(tracks.size()) / SEQ64_FILL_TRACKS_PER_THREAD;
+#ifdef PLATFORM_POSIX_API
+    int cpus = int(sysconf(_SC_NPROCESSORS_ONLN));
+    if (threads > cpus)
+        threads = cpus;
+#endif
+    if (threads > SEQ64_FILL_THREADS_MAX)
+        threads = SEQ64_FILL_THREADS_MAX;
+
+    std::vector<pthread_t> helpers;
+    for (int h = 1; h < threads; ++h)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, fill_thread_func, &job) == 0)
+            helpers.push_back(thread);
+    }
+    fill_claimed_tracks(job);
+    for (std::size_t h = 0; h < helpers.size(); ++h)
+        pthread_join(helpers[h], NULL);
+
+    return int(helpers.size()) + 1;
+}
+
+/**
+ *  Writes the bytes accumulated in m_char_vector to the file, in a single
+ *  call, and then empties the buffer.
+ *
+ * \param action
+ *      Names what is being done, such as "writing", for the error message.
+ *
+ * \return
+ *      Returns true if the file could be opened and all of the bytes were
+ *      written.
+ */
+
+bool
+midifile::write_file (const std::string & action)
+{
+    bool result = false;
+    std::ofstream file
+    (
+        m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    if (file.is_open())
+    {
+        if (! m_char_vector.empty())
+        {
+            file.write
+            (
+                reinterpret_cast<const char *>(&m_char_vector[0]),
+                std::streamsize(m_char_vector.size())
+            );
+        }
+        file.close();
+        result = ! file.fail();
+        if (! result)
+            m_error_message = "Error " + action + " MIDI file";
+    }
+    else
+        m_error_message = "Error opening MIDI file for " + action;
+
+    std::vector<midibyte>().swap(m_char_vector);    /* release the memory   */
+    return result;
+}
+
+/**
+ *  Writes the bytes accumulated in m_char_vector to a temporary file next
+ *  to the MIDI file, syncs it to the disk, and renames it over the MIDI
+ *  file, so that the MIDI file is always either the old one or the new
+ *  one, even if the application or the system crashes.  Then the buffer is
+ *  emptied.  Without the POSIX API, this is the same as write_file().
+ *
+ * \param action
+ *      Names what is being done, such as "autosaving", for the error
+ *      message.
+ *
+ * \return
+ *      Returns true if all of the bytes were written, synced, and renamed.
+ */
+
+bool
+midifile::write_file_synced (const std::string & action)
+{
+#ifdef PLATFORM_POSIX_API
+    std::string tempname = m_name + ".tmp";
+    int fd = open(tempname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        m_error_message = "Error opening MIDI file for " + action;
+        m_char_vector.clear();
+        return false;
+    }
+
+    std::size_t remaining = m_char_vector.size();
+    const midibyte * data = remaining > 0 ? &m_char_vector[0] : nullptr ;
+    while (remaining > 0)
+    {
+        ssize_t count = ::write(fd, data, remaining);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+        data += count;
+        remaining -= std::size_t(count);
+    }
+
+    bool result = remaining == 0 && fsync(fd) == 0;
+    if (close(fd) != 0)
+        result = false;
+
+    if (result)
+        result = rename(tempname.c_str(), m_name.c_str()) == 0;
+
+    if (! result)
+    {
+        (void) unlink(tempname.c_str());
+        m_error_message = "Error " + action + " MIDI file";
+    }
+    std::vector<midibyte>().swap(m_char_vector);    /* release the memory   */
+    return result;
+#else
+    return write_file(action);
+#endif
+}
+
 /**
  *  Calculates the size of a proprietary item, as written by the
  *  write_prop_header() function, plus whatever is called to write the data.
@@ -1836,6 +2225,12 @@ midifile::prop_item_size (long data_length) const
  *  Seq24 reverses the order of some events, due to popping from its
  *  container.  Not an issue here.
  *
+ *  The tracks are filled by fill_tracks(), on several threads when there
+ *  are many of them, and are then appended in track order to the output
+ *  buffer, which is written to the file in a single call.  With the --stats
+ *  option, the size of the file and the time it took to save it are shown
+ *  on the console.
+ *
  * \param p
  *      Provides the object that will contain and manage the entire
  *      performance.
@@ -1848,81 +2243,88 @@ bool
 midifile::write (perform & p)
 {
     automutex locker(m_mutex);          /* new ca 2016-08-01 */
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
     bool result = true;
-    int numtracks = 0;
     m_error_message.clear();
+    m_char_vector.clear();
     if (m_ppqn < SEQ64_MINIMUM_PPQN || m_ppqn > SEQ64_MAXIMUM_PPQN)
     {
         m_error_message = "Error, invalid PPQN for MIDI file to write";
         return false;
     }
     printf("[Writing MIDI file, %d ppqn]\n", m_ppqn);
-    for (int i = 0; i < c_max_sequence; ++i) /* get number of active tracks */
+
+    std::vector<int> numbers;               /* the active track numbers     */
+    for (int i = 0; i < c_max_sequence; ++i)
     {
         if (p.is_active(i))
-            ++numtracks;
+            numbers.push_back(i);
     }
+    int numtracks = int(numbers.size());
     if (! write_header(numtracks))
         return false;
 
     /*
-     * Write out the active tracks.  The value of c_max_sequence is 1024.
-     * Note that we don't need to check the sequence pointer.
+     * Fill a container for each active track.  The value of c_max_sequence
+     * is 1024.  Note that we don't need to check the sequence pointer.
+     * midi_container::fill() also handles the time-signature and tempo meta
+     * events, if they are not part of the file's MIDI data.  All the events
+     * are put into the containers, possibly by several threads, and then the
+     * containers' bytes are written out below, in track order.
      */
 
-    for (int track = 0; track < c_max_sequence; ++track)
+    std::vector<midi_container *> tracks;
+    tracks.reserve(numbers.size());
+    for (int t = 0; t < numtracks; ++t)
     {
-        if (p.is_active(track))
-        {
-            sequence & seq = *p.get_sequence(track);
+        sequence & seq = *p.get_sequence(numbers[t]);
 
 #if defined SEQ64_USE_MIDI_VECTOR
-            midi_vector lst(seq);
+        tracks.push_back(new midi_vector(seq));
 #else
-            midi_list lst(seq);
+        tracks.push_back(new midi_list(seq));
 #endif
+    }
 
-            /*
-             * midi_container::fill() also handles the time-signature and
-             * tempo meta events, if they are not part of the file's MIDI
-             * data.  All the events are put into the container, and then the
-             * container's bytes are written out below.
-             */
+    int threads = fill_tracks(p, tracks, numbers);
+    std::size_t total = m_char_vector.size();
+    for (int t = 0; t < numtracks; ++t)
+        total += 8 + tracks[t]->size();     /* "MTrk", size, and the data   */
 
-            lst.fill(track, p);
-            write_track(lst);
-        }
+    m_char_vector.reserve(total);
+    for (int t = 0; t < numtracks; ++t)
+    {
+        write_track(*tracks[t]);
+        delete tracks[t];
     }
     if (result)
         result = write_proprietary_track(p);
 
+    long filesize = long(m_char_vector.size());
+    if (result)
+        result = write_file("writing");
+
     if (result)
     {
-        std::ofstream file
-        (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
-        );
-        if (file.is_open())
-        {
-            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-            std::list<midibyte>::iterator it;
-            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
-            {
-                char c = *it;
-                file.write(&c, 1);
-            }
-            m_char_list.clear();
-        }
-        else
+        p.is_modified(false);      /* it worked, tell perform about it */
+        if (rc().stats())
         {
-            m_error_message = "Error opening MIDI file for writing";
-            result = false;
+            long us = long
+            (
+                std::chrono::duration_cast<std::chrono::microseconds>
+                (
+                    std::chrono::steady_clock::now() - start
+                ).count()
+            );
+            printf
+            (
+                "[Saved '%s': %ld bytes, %d tracks, %d threads, in %ld us]\n",
+                m_name.c_str(), filesize, numtracks, threads, us
+            );
         }
     }
-    if (result)
-        p.is_modified(false);      /* it worked, tell perform about it */
-
     return result;
 }
 
@@ -1989,6 +2391,7 @@ midifile::write_song (perform & p)
     automutex locker(m_mutex);                  /* new ca 2016-08-01 */
     int numtracks = 0;
     m_error_message.clear();
+    m_char_vector.clear();
     printf("[Exporting MIDI file, %d ppqn]\n", m_ppqn);
     for (int i = 0; i < c_max_sequence; ++i)    /* count exportable tracks  */
     {
@@ -2037,7 +2440,7 @@ midifile::write_song (perform & p)
                 {
                     lst.fill_time_sig_and_tempo
                     (
-                        p, seq.events().has_time_signature(),
+                        track_timing(p), seq.events().has_time_signature(),
                         seq.events().has_tempo()
                     );
                 }
@@ -2075,30 +2478,7 @@ midifile::write_song (perform & p)
         }
     }
     if (result)
-    {
-        std::ofstream file
-        (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
-        );
-        if (file.is_open())
-        {
-            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-
-            std::list<midibyte>::const_iterator it;
-            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
-            {
-                const char c = *it;
-                file.write(&c, 1);
-            }
-            m_char_list.clear();
-        }
-        else
-        {
-            m_error_message = "Error opening MIDI file for exporting";
-            result = false;
-        }
-    }
+        result = write_file("exporting");
 
     /*
      * Does not apply to exporting.
@@ -2112,6 +2492,223 @@ midifile::write_song (perform & p)
 
 #endif  // SEQ64_STAZED_EXPORT_SONG
 
+/**
+ *  Orders captured messages by tick, for std::stable_sort().
+ *
+ * \param a
+ *      The first message to compare.
+ *
+ * \param b
+ *      The second message to compare.
+ *
+ * \return
+ *      Returns true if \a a is due before \a b.
+ */
+
+static bool
+render_earlier (const render_message * a, const render_message * b)
+{
+    return a->rm_tick < b->rm_tick;
+}
+
+/**
+ *  Writes the output captured by perform::render_song() to a standard
+ *  Format 1 MIDI file.  The first track holds the tempo and the time
+ *  signature of the song.  Each of the other tracks holds the messages
+ *  played on one channel of one buss, in the order of the busses and the
+ *  channels.  Messages due at the same tick keep the order in which they
+ *  were played.  No Sequencer64 SeqSpec data is written.
+ *
+ * \param p
+ *      Provides the performance that was rendered, for its tempo and time
+ *      signature.
+ *
+ * \param messages
+ *      The captured messages.
+ *
+ * \return
+ *      Returns true if the write operations succeeded.  Returns false if
+ *      there are no messages, or the file cannot be written.
+ */
+
+bool
+midifile::write_render
+(
+    perform & p, const std::vector<render_message> & messages
+)
+{
+    automutex locker(m_mutex);
+    m_error_message.clear();
+    m_char_vector.clear();
+    printf("[Rendering MIDI file, %d ppqn]\n", m_ppqn);
+
+    typedef std::vector<const render_message *> Track;
+    std::map<int, Track> tracks;                /* key: buss * 16 + channel */
+    for (std::size_t i = 0; i < messages.size(); ++i)
+    {
+        const render_message & rm = messages[i];
+        tracks[rm.rm_bus * 16 + (rm.rm_status & 0x0F)].push_back(&rm);
+    }
+
+    bool result = ! tracks.empty();
+    if (result)
+        result = write_header(int(tracks.size()) + 1);
+    else
+        m_error_message = "The song rendered no MIDI events.";
+
+    if (result)
+    {
+        write_long(0x4D54726B);                 /* conductor track, "MTrk"  */
+        write_long(7 + 8 + 4);                  /* tempo, time sig, the end */
+        write_start_tempo(p.get_beats_per_minute());
+        write_time_sig(p.get_beats_per_bar(), p.get_beat_width());
+        write_byte(0x00);                       /* delta time of the end    */
+        write_track_end();
+
+        std::map<int, Track>::iterator t;
+        for (t = tracks.begin(); t != tracks.end(); ++t)
+        {
+            Track & track = t->second;
+            std::stable_sort(track.begin(), track.end(), render_earlier);
+
+            char name[32];
+            snprintf
+            (
+                name, sizeof name, "Buss %d Channel %d",
+                t->first / 16, t->first % 16 + 1
+            );
+
+            std::string trackname = name;
+            long tracksize = track_name_size(trackname) + 4;
+            midipulse previous = 0;
+            Track::const_iterator m;
+            for (m = track.begin(); m != track.end(); ++m)
+            {
+                long delta = long((*m)->rm_tick - previous);
+                tracksize += varinum_size(delta) + (*m)->rm_size;
+                previous = (*m)->rm_tick;
+            }
+            write_long(0x4D54726B);             /* "MTrk"                   */
+            write_long(midilong(tracksize));
+            write_track_name(trackname);
+            previous = 0;
+            for (m = track.begin(); m != track.end(); ++m)
+            {
+                write_varinum(midilong((*m)->rm_tick - previous));
+                write_byte((*m)->rm_status);
+                write_byte((*m)->rm_d0);
+                if ((*m)->rm_size == 3)
+                    write_byte((*m)->rm_d1);
+
+                previous = (*m)->rm_tick;
+            }
+            write_byte(0x00);                   /* delta time of the end    */
+            write_track_end();
+        }
+    }
+    if (result)
+        result = write_file("rendering");
+    return result;
+}
+
+/**
+ *  Takes a snapshot of what write() saves, for write_snapshot() to write
+ *  later, on another thread.  Each active sequence is copied, without its
+ *  events, by sequence::copy_for_save(), which returns a snapshot of the
+ *  events instead.  The proprietary track is small, and it reads the
+ *  performance, so it is built right away, and its bytes are kept.  The
+ *  tempo and time signature that the first track gets are copied as well.
+ *  This function must be called by the thread that owns the performance,
+ *  like write().
+ *
+ * \param p
+ *      The performance to copy.
+ *
+ * \param [out] ss
+ *      The destination of the copy.  This midifile should have been
+ *      created with the PPQN of the performance.
+ */
+
+void
+midifile::take_snapshot (perform & p, song_snapshot & ss)
+{
+    automutex locker(m_mutex);
+    for (int track = 0; track < c_max_sequence; ++track)
+    {
+        if (p.is_active(track))
+        {
+            sequence * copy = new sequence(m_ppqn);
+            saved_track st;
+            st.st_number = track;
+            st.st_sequence = copy;
+            st.st_events = copy->copy_for_save(*p.get_sequence(track));
+            ss.ss_tracks.push_back(st);
+        }
+    }
+    ss.ss_timing = track_timing(p);
+    m_char_vector.clear();
+    (void) write_proprietary_track(p);
+    ss.ss_proprietary.swap(m_char_vector);
+    m_char_vector.clear();
+}
+
+/**
+ *  Writes a snapshot taken by take_snapshot() to the MIDI file.  The file
+ *  has the same contents that write() would have given it when the
+ *  snapshot was taken.  The events of each sequence are loaded into its
+ *  detached copy, so that the copy can be filled into a container as
+ *  write() does.  The file is written by write_file_synced(), and the
+ *  "is modified" flag of the performance is left alone, since the song
+ *  itself is not saved.  The performance is not read at all, so this
+ *  function can run on any thread.
+ *
+ * \param ss
+ *      The snapshot to write.
+ *
+ * \return
+ *      Returns true if the write operations succeeded.
+ */
+
+bool
+midifile::write_snapshot (song_snapshot & ss)
+{
+    automutex locker(m_mutex);
+    m_error_message.clear();
+    m_char_vector.clear();
+    if (m_ppqn < SEQ64_MINIMUM_PPQN || m_ppqn > SEQ64_MAXIMUM_PPQN)
+    {
+        m_error_message = "Error, invalid PPQN for MIDI file to write";
+        return false;
+    }
+
+    int numtracks = int(ss.ss_tracks.size());
+    if (! write_header(numtracks))
+    {
+        m_error_message = "The song has no patterns to save";
+        return false;
+    }
+    for (int t = 0; t < numtracks; ++t)
+    {
+        saved_track & st = ss.ss_tracks[t];
+        sequence & seq = *st.st_sequence;
+        seq.load_event_snapshot(*st.st_events);
+
+#if defined SEQ64_USE_MIDI_VECTOR
+        midi_vector lst(seq);
+#else
+        midi_list lst(seq);
+#endif
+
+        lst.fill(st.st_number, ss.ss_timing);
+        write_track(lst);
+    }
+    m_char_vector.insert
+    (
+        m_char_vector.end(), ss.ss_proprietary.begin(), ss.ss_proprietary.end()
+    );
+    return write_file_synced("autosaving");
+}
+
 /**
  *  Writes out the final proprietary/SeqSpec section, using the new format if
  *  the legacy format is not in force.
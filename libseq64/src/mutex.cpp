@@ -29,7 +29,18 @@
  *
  */
 
+#include <chrono>                       /* std::chrono::steady_clock    */
+
 #include "mutex.hpp"
+#include "platform_macros.h"            /* PLATFORM_LINUX               */
+
+#ifdef PLATFORM_LINUX
+#include <poll.h>                       /* ::poll()                     */
+#include <sys/eventfd.h>                /* ::eventfd(), eventfd_read()  */
+#include <unistd.h>                     /* ::close()                    */
+#else
+#include <time.h>                       /* ::nanosleep()                */
+#endif
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -112,6 +123,16 @@ condition_var::signal ()
     pthread_cond_signal(&m_cond);
 }
 
+/**
+ *  Signals the condition variable to all of the threads waiting on it.
+ */
+
+void
+condition_var::broadcast ()
+{
+    pthread_cond_broadcast(&m_cond);
+}
+
 /**
  *  Waits for the condition variable.
  */
@@ -122,6 +143,124 @@ condition_var::wait ()
     pthread_cond_wait(&m_cond, &m_mutex_lock);
 }
 
+/**
+ *  Creates the eventfd, if available.
+ */
+
+wakeup_event::wakeup_event ()
+ :
+#ifdef PLATFORM_LINUX
+    m_fd        (eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+#else
+    m_fd        (-1),
+#endif
+    m_signal_us (0)
+{
+    // Empty body
+}
+
+/**
+ *  Closes the eventfd.
+ */
+
+wakeup_event::~wakeup_event ()
+{
+#ifdef PLATFORM_LINUX
+    if (m_fd >= 0)
+        (void) close(m_fd);
+#endif
+}
+
+/**
+ *  Wakes the waiting thread, if any, or makes its next wait() return at
+ *  once.  Neither allocates nor locks, and so can be called from the JACK
+ *  process callback.
+ */
+
+void
+wakeup_event::signal ()
+{
+    std::int64_t expected = 0;
+    (void) m_signal_us.compare_exchange_strong(expected, now_us());
+
+#ifdef PLATFORM_LINUX
+    if (m_fd >= 0)
+        (void) eventfd_write(m_fd, 1);
+#endif
+}
+
+/**
+ *  Waits for a signal, and clears it.
+ *
+ * \param timeoutms
+ *      The longest time to wait, in milliseconds.
+ *
+ * \return
+ *      Returns true if a signal was received, and false on a timeout.
+ *      Without eventfd support, always returns true after a millisecond.
+ */
+
+bool
+wakeup_event::wait (int timeoutms)
+{
+#ifdef PLATFORM_LINUX
+    if (m_fd >= 0)
+    {
+        struct pollfd pfd;
+        pfd.fd = m_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        bool result = poll(&pfd, 1, timeoutms) > 0;
+        if (result)
+        {
+            eventfd_t count;
+            (void) eventfd_read(m_fd, &count);
+        }
+        return result;
+    }
+#endif
+
+    (void) timeoutms;
+    struct timespec ts;
+    ts.tv_sec = 0;
+    ts.tv_nsec = 1000000;
+    (void) nanosleep(&ts, NULL);
+    return true;
+}
+
+/**
+ *  Gets and clears the time of the earliest pending signal.
+ *
+ * \return
+ *      Returns the time, in microseconds of now_us(), or 0 if no signal
+ *      occurred since the last call.
+ */
+
+std::int64_t
+wakeup_event::take_signal_time ()
+{
+    return m_signal_us.exchange(0);
+}
+
+/**
+ * \return
+ *      Returns the current time of the monotonic clock, in microseconds.
+ *      The value is never 0.
+ */
+
+std::int64_t
+wakeup_event::now_us ()
+{
+    std::int64_t result = std::int64_t
+    (
+        std::chrono::duration_cast<std::chrono::microseconds>
+        (
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+    return result != 0 ? result : 1 ;
+}
+
 }           // namespace seq64
 
 /*
@@ -312,10 +312,14 @@ optionsfile::parse (perform & p)
             p.midi_control_off(i).set(c);
             ok = next_data_line(file);
             if (! ok && i < (sequences - 1))
+            {
+                p.midi_controls_changed();      /* index the ones we read   */
                 return error_message("midi-control", "not enough data");
+            }
             else
                 ok = true;
         }
+        p.midi_controls_changed();
     }
     else
     {
@@ -659,6 +663,49 @@ optionsfile::parse (perform & p)
         if (! rc().reveal_alsa_ports())
             rc().reveal_alsa_ports(bool(flag));
     }
+    if (line_after(file, "[alsa-scheduled-output]"))
+    {
+        sscanf(m_line, "%ld", &flag);
+        rc().alsa_scheduled_output(bool(flag));
+        if (next_data_line(file))
+        {
+            int ms = SEQ64_DEFAULT_LOOKAHEAD_MS;
+            sscanf(m_line, "%d", &ms);
+            rc().alsa_lookahead_ms(ms);
+        }
+    }
+    if (line_after(file, "[output-thread]"))
+    {
+        int value = 0;
+        sscanf(m_line, "%d", &value);
+        rc().output_priority(value);
+        if (next_data_line(file))
+        {
+            value = -1;
+            sscanf(m_line, "%d", &value);
+            rc().output_cpu(value);
+            if (next_data_line(file))
+            {
+                value = 0;
+                sscanf(m_line, "%d", &value);
+                rc().play_workers(value);
+            }
+        }
+    }
+    if (line_after(file, "[undo-memory]"))
+    {
+        int kb = SEQ64_DEFAULT_UNDO_MEMORY_KB;
+        sscanf(m_line, "%d", &kb);
+        rc().undo_memory_kb(kb);
+    }
+    if (line_after(file, "[autosave]"))
+    {
+        int seconds = 0;
+        sscanf(m_line, "%d", &seconds);
+        rc().autosave_interval(seconds);
+        if (next_data_line(file))
+            rc().autosave_filename(m_line);
+    }
 
     if (line_after(file, "[last-used-dir]"))
     {
@@ -1235,6 +1282,75 @@ optionsfile::write (const perform & p)
         << "   # flag for reveal ALSA ports\n"
         ;
 
+    /*
+     * ALSA scheduled output
+     */
+
+    file
+        << "\n[alsa-scheduled-output]\n\n"
+        << "# Set to 1 to have the ALSA output busses stamp each event with a\n"
+        << "# tick a little ahead of the current time, and let the ALSA queue\n"
+        << "# deliver it, instead of sending it directly.  This removes the\n"
+        << "# jitter of the output thread, at the cost of delaying all output\n"
+        << "# by the lookahead.  The second value is the lookahead in ms.\n"
+        << "# Ignored by the rtmidi and PortMidi builds.\n"
+        << "\n"
+        << (rc().alsa_scheduled_output() ? "1" : "0")
+        << "   # flag for ALSA scheduled output\n"
+        << rc().alsa_lookahead_ms()
+        << "   # lookahead in ms\n"
+        ;
+
+    /*
+     * Output thread
+     */
+
+    file
+        << "\n[output-thread]\n\n"
+        << "# The first value is the SCHED_FIFO priority (1 to 99) of the\n"
+        << "# output thread, or 0 to use the normal scheduler (the --priority\n"
+        << "# option then selects priority 1).  Needs the proper privileges.\n"
+        << "# The second value is the CPU to which the output thread is\n"
+        << "# pinned, or -1 to let it run on any CPU.\n"
+        << "# The third value is the number of worker threads (up to 16) that\n"
+        << "# help the output thread play the patterns of each frame, for\n"
+        << "# large sets of busy patterns on several cores.  The output is\n"
+        << "# the same as with 0, the default, where no workers are used.\n"
+        << "\n"
+        << rc().output_priority() << "   # output thread FIFO priority\n"
+        << rc().output_cpu() << "   # output thread CPU\n"
+        << rc().play_workers() << "   # pattern-playing worker threads\n"
+        ;
+
+    /*
+     * Undo memory
+     */
+
+    file
+        << "\n[undo-memory]\n\n"
+        << "# The maximum memory, in kilobytes, used by the undo history (and\n"
+        << "# again by the redo history) of each pattern.  The oldest undo\n"
+        << "# steps are dropped beyond it.  0 means no limit.\n"
+        << "\n"
+        << rc().undo_memory_kb() << "   # undo memory in kB\n"
+        ;
+
+    /*
+     * Autosave
+     */
+
+    file
+        << "\n[autosave]\n\n"
+        << "# The interval, in seconds, at which a song with unsaved changes\n"
+        << "# is saved in the background to the file given on the next line,\n"
+        << "# for recovery after a crash.  0, the default, disables it.  The\n"
+        << "# song file itself is not touched.  A file name without a\n"
+        << "# directory is put in the configuration directory.\n"
+        << "\n"
+        << rc().autosave_interval() << "   # autosave interval in seconds\n"
+        << rc().autosave_filename() << "\n"
+        ;
+
     /*
      * Interaction-method
      */
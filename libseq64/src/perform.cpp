@@ -62,14 +62,11 @@
  *      -   m_seqs_active[c_max_sequence] (seq24).
  *          Indicates if a pattern has any data in it, i.e. it is not empty,
  *          whether it is muted or not.
- *      -   m_was_active_main[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_main().
- *      -   m_was_active_edit[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_edit().
- *      -   m_was_active_perf[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_perf().
- *      -   m_was_active_names[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_names().
+ *      -   m_dirty_seqs[DIRTY_KINDS][SEQ64_DIRTY_WORDS].
+ *          Atomic changed-sequences bitsets, replacing seq24's
+ *          m_was_active_main/edit/perf/names arrays.  Used in
+ *          perform::is_dirty_main(), is_dirty_edit(), is_dirty_perf(), and
+ *          is_dirty_names().
  *      -   m_sequence_state[c_max_sequence] (seq24).
  *          Used in unsetting the snapshot status (c_status_snapshot).
  *          perform::save_playing_state() uses this to preserve the playing
@@ -126,6 +123,7 @@
 #include <sched.h>
 #include <stdio.h>
 #include <string.h>                     /* memset()                         */
+#include <time.h>                       /* time(), clock_nanosleep()        */
 
 #include "calculations.hpp"
 #include "cmdlineopts.hpp"              /* seq64::parse_mute_groups()       */
@@ -136,7 +134,8 @@
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
 
 #if ! defined PLATFORM_WINDOWS
-#include <time.h>                       /* struct timespec                  */
+#include <errno.h>                      /* EINTR                            */
+#include <unistd.h>                     /* sysconf()                        */
 #endif
 
 /**
@@ -286,10 +285,8 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_midi_mute_group_present   (false),
     m_seqs                      (),         // pointer array [c_max_sequence]
     m_seqs_active               (),         // boolean array [c_max_sequence]
-    m_was_active_main           (),         // boolean array [c_max_sequence]
-    m_was_active_edit           (),         // boolean array [c_max_sequence]
-    m_was_active_perf           (),         // boolean array [c_max_sequence]
-    m_was_active_names          (),         // boolean array [c_max_sequence]
+    m_dirty_seqs                (),         // atomic bitsets, see below
+    m_dirty_generation          (0),
     m_sequence_state            (),         // boolean array [c_max_sequence]
     m_screenset_state           (m_seqs_in_set, false),    // boolean vector
     m_queued_replace_slot       (SEQ64_NO_QUEUED_SOLO),
@@ -300,6 +297,15 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_in_thread                 (),
     m_out_thread_launched       (false),
     m_in_thread_launched        (false),
+    m_play_threads              (),
+    m_play_start                (),
+    m_play_done                 (),
+    m_play_frame                (0),
+    m_play_exit                 (false),
+    m_play_pending              (0),
+    m_play_next                 (0),
+    m_play_tick                 (0),
+    m_play_song_mode            (false),
     m_running                   (false),
     m_is_pattern_playing        (false),
     m_inputing                  (true),
@@ -321,6 +327,9 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_right_tick                (m_one_measure * 4),    /* m_ppqn * 16      */
     m_starting_tick             (0),
     m_tick                      (0),
+    m_play_stamp_seq            (0),
+    m_play_stamp_tick           (0),
+    m_play_stamp_us             (0),
     m_jack_tick                 (0),
     m_usemidiclock              (false),
     m_midiclockrunning          (false),
@@ -331,6 +340,9 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_midi_cc_toggle            (),         // midi_control []
     m_midi_cc_on                (),         // midi_control []
     m_midi_cc_off               (),         // midi_control []
+    m_midi_control_index        (),         // unsigned short []
+    m_midi_control_entries      (),         // unsigned short []
+    m_midi_control_stale        (true),
     m_control_status            (0),
     m_screenset                 (0),        // vice m_playscreen
     m_screenset_offset          (0),
@@ -348,6 +360,8 @@ perform::perform (gui_assistant & mygui, int ppqn)
 #endif
     m_is_modified               (false),
     m_condition_var             (),
+    m_output_stats              (),
+    m_autosave                  (*this),
 #ifdef SEQ64_JACK_SUPPORT
     m_jack_asst
     (
@@ -370,9 +384,12 @@ perform::perform (gui_assistant & mygui, int ppqn)
     {
         m_seqs[i] = nullptr;
         m_seqs_active[i] =                      /* seq24 0.9.3 addition     */
-            m_sequence_state[i] =               /* ca 2016-11-27            */
-            m_was_active_main[i] = m_was_active_edit[i] =
-            m_was_active_perf[i] = m_was_active_names[i] = false;
+            m_sequence_state[i] = false;        /* ca 2016-11-27            */
+    }
+    for (int k = 0; k < DIRTY_KINDS; ++k)
+    {
+        for (int w = 0; w < SEQ64_DIRTY_WORDS; ++w)
+            m_dirty_seqs[k][w].store(0);
     }
     for (int i = 0; i < c_max_sequence; ++i)    /* not c_gmute_tracks now   */
     {
@@ -407,11 +424,15 @@ perform::perform (gui_assistant & mygui, int ppqn)
 
 perform::~perform ()
 {
+    m_autosave.stop();                              /* before any deletion  */
     m_inputing = m_outputing = m_running = false;
     m_condition_var.signal();                       /* signal end of play   */
+    if (not_nullptr(m_master_bus))
+        m_master_bus->wake_input();                 /* end a blocking wait  */
     if (m_out_thread_launched)
         pthread_join(m_out_thread, NULL);
 
+    stop_play_workers();
     if (m_in_thread_launched)
         pthread_join(m_in_thread, NULL);
 
@@ -443,8 +464,12 @@ perform::~perform ()
  *  different from what was saved in the "rc" file after the last run of
  *  Sequencer64.
  *
+ *  Public so that the tests can create the buss, which sequences and
+ *  midifile need, without the ports and threads that launch() starts.
+ *
  * \return
- *      Returns true if the creation succeeded.
+ *      Returns true if the creation succeeded.  The MIDI API may also throw
+ *      an exception if it cannot be opened.
  */
 
 bool
@@ -498,6 +523,7 @@ perform::launch (int ppqn)
         {
             launch_input_thread();
             launch_output_thread();
+            launch_play_workers();
         }
     }
 }
@@ -1377,6 +1403,9 @@ perform::install_sequence (sequence * seq, int seqnum)
     {
         set_active(seqnum, true);
         seq->set_parent(this);
+        if (! m_play_threads.empty())
+            seq->reserve_deferred();
+
         ++m_sequence_count;
         if (seqnum >= m_sequence_high)
             m_sequence_high = seqnum + 1;
@@ -1551,13 +1580,20 @@ perform::set_active (int seq, bool active)
             m_seqs[seq]->number(seq);
             if (m_seqs[seq]->name().empty())
                 m_seqs[seq]->set_name(std::string("Untitled"));
+
+            mark_dirty(seq, SEQ64_DIRTY_ALL);
         }
     }
 }
 
 /**
- *  Sets was-active flags:  main, edit, perf, and names.
- *  Why do we need this routine?
+ *  Marks a pattern that was just deactivated as dirty for every kind of
+ *  view, by setting its bit in all four changed-sequences bitsets,
+ *  m_dirty_seqs, with mark_dirty().  The pattern's slot must be redrawn in
+ *  every view, now that the pattern is gone.  This replaces the seq24
+ *  "was-active" boolean flags of main, edit, perf, and names.
+ *
+ * \threadsafe
  *
  * \param seq
  *      The pattern number.  It is checked for validity.
@@ -1566,134 +1602,134 @@ perform::set_active (int seq, bool active)
 void
 perform::set_was_active (int seq)
 {
-    if (is_seq_valid(seq))
+    mark_dirty(seq, SEQ64_DIRTY_ALL);
+}
+
+/**
+ *  Records that a pattern changed, for the given kinds of views, by setting
+ *  its bit in the changed-sequences bitsets, and bumps the dirty
+ *  generation.  Called by sequence::mark_dirty(), from any thread.
+ *
+ * \threadsafe
+ *
+ * \param seq
+ *      The pattern number.  It is checked for validity.
+ *
+ * \param kinds
+ *      The SEQ64_DIRTY_* bits of the kinds of views that need a redraw.
+ */
+
+void
+perform::mark_dirty (int seq, unsigned kinds)
+{
+    if (is_mseq_valid(seq))
     {
-        m_was_active_main[seq] =
-            m_was_active_edit[seq] =
-            m_was_active_perf[seq] =
-            m_was_active_names[seq] = true;
+        unsigned bit = 1u << (seq % 32);
+        for (int k = 0; k < DIRTY_KINDS; ++k)
+        {
+            if ((kinds & (1u << k)) != 0)
+                m_dirty_seqs[k][seq / 32].fetch_or(bit);
+        }
+        m_dirty_generation.fetch_add(1, std::memory_order_release);
     }
 }
 
 /**
- *  Checks the pattern/sequence for main-dirtiness.  See the
- *  sequence::is_dirty_main() function.
+ *  Tests and clears the bit of a pattern in one changed-sequences bitset.
+ *
+ * \threadsafe
  *
  * \param seq
  *      The pattern number.  It is checked for validity.
  *
+ * \param kind
+ *      The kind of dirtiness, which is the index of the bitset.
+ *
  * \return
- *      Returns the was-active-main flag value, before setting it to
- *      false.  Returns false if the pattern was invalid.
+ *      Returns true if the pattern was marked dirty for that kind of view
+ *      since the last call.
  */
 
 bool
-perform::is_dirty_main (int seq)
+perform::take_dirty (int seq, dirty_kind_t kind)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
+    bool result = false;
+    if (is_mseq_valid(seq))
     {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_main();
-        }
-        else
-        {
-            was_active = m_was_active_main[seq];
-            m_was_active_main[seq] = false;
-        }
+        unsigned bit = 1u << (seq % 32);
+        result = (m_dirty_seqs[kind][seq / 32].fetch_and(~bit) & bit) != 0;
     }
-    return was_active;
+    return result;
+}
+
+/**
+ *  Checks the pattern/sequence for main-dirtiness, and clears it.  It is set
+ *  by sequence::set_dirty_mp() and sequence::set_dirty(), and when the
+ *  pattern is activated or deactivated.  Lock-free.
+ *
+ * \param seq
+ *      The pattern number.  It is checked for validity.
+ *
+ * \return
+ *      Returns the main-dirty bit of the pattern, before clearing it.
+ *      Returns false if the pattern was invalid.
+ */
+
+bool
+perform::is_dirty_main (int seq)
+{
+    return take_dirty(seq, DIRTY_MAIN);
 }
 
 /**
- *  Checks the pattern/sequence for edit-dirtiness.
+ *  Checks the pattern/sequence for edit-dirtiness, and clears it.
  *
  * \param seq
  *      The pattern number.  It is checked for validity.
  *
  * \return
- *      Returns the was-active-edit flag value, before setting it to
- *      false. Returns false if the pattern was invalid.
+ *      Returns the edit-dirty bit of the pattern, before clearing it.
+ *      Returns false if the pattern was invalid.
  */
 
 bool
 perform::is_dirty_edit (int seq)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
-    {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_edit();
-        }
-        else
-        {
-            was_active = m_was_active_edit[seq];
-            m_was_active_edit[seq] = false;
-        }
-    }
-    return was_active;
+    return take_dirty(seq, DIRTY_EDIT);
 }
 
 /**
- *  Checks the pattern/sequence for perf-dirtiness.
+ *  Checks the pattern/sequence for perf-dirtiness, and clears it.
  *
  * \param seq
  *      The pattern number.  It is checked for validity.
  *
  * \return
- *      Returns the was-active-perf flag value, before setting it to
- *      false.  Returns false if the pattern/sequence number was invalid.
+ *      Returns the perf-dirty bit of the pattern, before clearing it.
+ *      Returns false if the pattern/sequence number was invalid.
  */
 
 bool
 perform::is_dirty_perf (int seq)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
-    {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_perf();
-        }
-        else
-        {
-            was_active = m_was_active_perf[seq];
-            m_was_active_perf[seq] = false;
-        }
-    }
-    return was_active;
+    return take_dirty(seq, DIRTY_PERF);
 }
 
 /**
- *  Checks the pattern/sequence for names-dirtiness.
+ *  Checks the pattern/sequence for names-dirtiness, and clears it.
  *
  * \param seq
  *      The pattern number.  It is checked for validity.
  *
  * \return
- *      Returns the was-active-names flag value, before setting it to
- *      false.  Returns false if the pattern/sequence number was invalid.
+ *      Returns the names-dirty bit of the pattern, before clearing it.
+ *      Returns false if the pattern/sequence number was invalid.
  */
 
 bool
 perform::is_dirty_names (int seq)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
-    {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_names();
-        }
-        else
-        {
-            was_active = m_was_active_names[seq];
-            m_was_active_names[seq] = false;
-        }
-    }
-    return was_active;
+    return take_dirty(seq, DIRTY_NAMES);
 }
 
 /**
@@ -2274,6 +2310,11 @@ perform::set_playing_screenset ()
  *  Finally, we stop the looping at m_sequence_high rather than
  *  m_sequence_max, to save a little time.
  *
+ *  The tick and the current time are also recorded, for input_tick().
+ *
+ *  If worker threads were launched, the sequences are played by
+ *  play_in_parallel() instead.
+ *
  * \param tick
  *      Provides the tick at which to start playing.  This value is also
  *      copied to m_tick.
@@ -2283,15 +2324,120 @@ void
 perform::play (midipulse tick)
 {
     m_tick = tick;
-    for (int s = 0; s < m_sequence_high; ++s)       /* modest speed up  */
+    unsigned seq = m_play_stamp_seq.load(std::memory_order_relaxed);
+    m_play_stamp_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_play_stamp_tick.store(tick, std::memory_order_relaxed);
+    m_play_stamp_us.store(wakeup_event::now_us(), std::memory_order_relaxed);
+    m_play_stamp_seq.store(seq + 2, std::memory_order_release);
+    if (m_play_threads.empty())
     {
-        if (is_active(s))
-            m_seqs[s]->play_queue(tick, m_playback_mode);
+        for (int s = 0; s < m_sequence_high; ++s)   /* modest speed up  */
+        {
+            if (is_active(s))
+                m_seqs[s]->play_queue(tick, m_playback_mode);
+        }
     }
+    else
+        play_in_parallel(tick);
+
     if (not_nullptr(m_master_bus))
         m_master_bus->flush();                       /* flush MIDI buss  */
 }
 
+/**
+ *  Plays the sequences of a frame with the help of the worker threads.
+ *  The workers are woken, and the calling thread (normally the output
+ *  thread) joins them in claiming the sequences one at a time, each
+ *  played by sequence::play_deferred().  Once all of the workers are done,
+ *  the output held back by each sequence is sent, in the order of the
+ *  sequence numbers.  Therefore the output, including its timing, is the
+ *  same as that of the serial loop of play(), whatever thread played
+ *  which sequence.
+ *
+ * \param tick
+ *      Provides the tick at which to start playing.
+ */
+
+void
+perform::play_in_parallel (midipulse tick)
+{
+    m_play_tick = tick;
+    m_play_song_mode = m_playback_mode;
+    m_play_next.store(0, std::memory_order_relaxed);
+    m_play_done.lock();
+    m_play_pending = int(m_play_threads.size());
+    m_play_done.unlock();
+    m_play_start.lock();
+    ++m_play_frame;
+    m_play_start.broadcast();
+    m_play_start.unlock();
+    play_claimed_sequences();
+
+    m_play_done.lock();
+    while (m_play_pending > 0)
+        m_play_done.wait();
+
+    m_play_done.unlock();
+    for (int s = 0; s < m_sequence_high; ++s)
+    {
+        if (is_active(s))
+            m_seqs[s]->replay_output();
+    }
+}
+
+/**
+ *  Claims the sequences of the current frame one at a time, and plays
+ *  each, until none is left.  Called by the worker threads and by
+ *  play_in_parallel().
+ */
+
+void
+perform::play_claimed_sequences ()
+{
+    int high = m_sequence_high;
+    for (;;)
+    {
+        int s = m_play_next.fetch_add(1, std::memory_order_relaxed);
+        if (s >= high)
+            break;
+
+        if (is_active(s))
+            m_seqs[s]->play_deferred(m_play_tick, m_play_song_mode);
+    }
+}
+
+/**
+ *  The loop of a worker thread.  It waits for play_in_parallel() to hand
+ *  it a frame, helps play the sequences, and tells play_in_parallel() when
+ *  it is done, until stop_play_workers() tells it to exit.
+ */
+
+void
+perform::play_worker_func ()
+{
+    unsigned frame = 0;
+    for (;;)
+    {
+        m_play_start.lock();
+        while (m_play_frame == frame && ! m_play_exit)
+            m_play_start.wait();
+
+        frame = m_play_frame;
+        bool exiting = m_play_exit;
+        m_play_start.unlock();
+        if (exiting)
+            break;
+
+        play_claimed_sequences();
+        m_play_done.lock();
+        if (--m_play_pending == 0)
+            m_play_done.signal();
+
+        m_play_done.unlock();
+    }
+}
+
 /**
  *  For every pattern/sequence that is active, sets the "original tick"
  *  value for the pattern.  This is really the "last tick" value, so we
@@ -2969,6 +3115,80 @@ perform::launch_input_thread ()
         m_in_thread_launched = true;
 }
 
+/**
+ *  Creates the worker threads that help the output thread play the
+ *  sequences, as many as the [output-thread] settings ask for.  If a
+ *  thread cannot be created, the ones created so far are used.
+ *
+ *  If the output thread is pinned to a CPU, each worker is pinned to one
+ *  of the CPUs that follow it, wrapping around, so that the workers and
+ *  the output thread do not share a CPU until there are more threads than
+ *  CPUs.  Finally, the sequences already installed make room for the calls
+ *  they will hold back; install_sequence() does it for the later ones.
+ */
+
+void
+perform::launch_play_workers ()
+{
+    int count = rc().play_workers();
+    for (int w = 0; w < count; ++w)
+    {
+        pthread_t thread;
+        int err = pthread_create(&thread, NULL, play_worker_thread_func, this);
+        if (err != 0)
+        {
+            errprintf("couldn't create play worker thread %d\n", w);
+            break;
+        }
+        m_play_threads.push_back(thread);
+
+#ifdef PLATFORM_LINUX
+        int ncpus = int(sysconf(_SC_NPROCESSORS_ONLN));
+        if (rc().output_cpu() >= 0 && ncpus > 0)
+        {
+            int cpu = (rc().output_cpu() + 1 + w) % ncpus;
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            if (pthread_setaffinity_np(thread, sizeof cpus, &cpus) != 0)
+            {
+                errprintf("couldn't pin play worker to CPU %d\n", cpu);
+            }
+        }
+#endif
+    }
+    if (! m_play_threads.empty())
+    {
+        infoprintf("[%d play worker threads]\n", int(m_play_threads.size()));
+        for (int s = 0; s < m_sequence_high; ++s)
+        {
+            if (is_active(s))
+                m_seqs[s]->reserve_deferred();
+        }
+    }
+}
+
+/**
+ *  Tells the worker threads to exit, and waits for them.  The output thread
+ *  must not be playing a frame.
+ */
+
+void
+perform::stop_play_workers ()
+{
+    if (! m_play_threads.empty())
+    {
+        m_play_start.lock();
+        m_play_exit = true;
+        m_play_start.broadcast();
+        m_play_start.unlock();
+        for (std::size_t w = 0; w < m_play_threads.size(); ++w)
+            pthread_join(m_play_threads[w], NULL);
+
+        m_play_threads.clear();
+    }
+}
+
 /**
  *  Convenience function for perfroll's split-trigger functionality.
  *
@@ -3016,6 +3236,64 @@ perform::get_max_trigger ()
     return result;
 }
 
+/**
+ *  Renders the song offline, as fast as possible.  Song-mode playback is
+ *  driven by a virtual clock, calling play() for each frame from tick 0 to
+ *  the end of the last trigger, while the master buss captures the output
+ *  instead of sending it.  The triggers, the song mutes, and the
+ *  transposition apply just as in a real-time playback.  At the end, the
+ *  sequences are stopped, which captures the Note Offs of the notes still
+ *  sounding.
+ *
+ *  Playback must not be running.  The playback mode and the tempo, which
+ *  tempo events in the patterns can change, are restored afterward.
+ *
+ * \param [out] messages
+ *      The vector to which the captured channel messages are appended, in
+ *      the order they are played.  Since a frame plays each pattern in
+ *      turn, their ticks are in order only within each pattern.
+ *
+ * \return
+ *      Returns true if the song was rendered.  Returns false if playback is
+ *      running, or if there is no trigger to play.
+ */
+
+bool
+perform::render_song (std::vector<render_message> & messages)
+{
+    midipulse endtick = get_max_trigger();
+    bool result = not_nullptr(m_master_bus) && ! is_running() && endtick > 0;
+    if (result)
+    {
+        bool playbackmode = m_playback_mode;
+        midibpm bpm = get_beats_per_minute();
+        midipulse frame = m_master_bus->get_ppqn();
+        frame /= SEQ64_RENDER_FRAMES_PER_BEAT;
+        if (frame < 1)
+            frame = 1;
+
+        set_playback_mode(true);
+        off_sequences();
+        set_orig_ticks(0);
+        m_master_bus->capture_output(&messages);
+        for (midipulse tick = 0; ; tick += frame)
+        {
+            if (tick > endtick)
+                tick = endtick;
+
+            m_master_bus->capture_tick(tick);
+            play(tick);
+            if (tick == endtick)
+                break;
+        }
+        reset_sequences();                      /* captures the Note Offs   */
+        m_master_bus->capture_output(nullptr);
+        set_playback_mode(playbackmode);
+        set_beats_per_minute(bpm);
+    }
+    return result;
+}
+
 /**
  *  Set up the performance, set the process to realtime privileges, and then
  *  start the output function.
@@ -3039,11 +3317,15 @@ output_thread_func (void * myperf)
     p->output_func();
     timeEndPeriod(1);
 #else
-    if (rc().priority())                        /* Not in MinGW RCB */
+    int priority = rc().output_priority();      /* [output-thread] setting  */
+    if (priority == 0 && rc().priority())       /* Not in MinGW RCB         */
+        priority = 1;
+
+    if (priority > 0)
     {
         struct sched_param schp;
         memset(&schp, 0, sizeof(sched_param));
-        schp.sched_priority = 1;
+        schp.sched_priority = priority;
         if (sched_setscheduler(0, SCHED_FIFO, &schp) != 0)
         {
             errprint
@@ -3055,9 +3337,28 @@ output_thread_func (void * myperf)
         }
         else
         {
-            infoprint("[Output priority set to 1]");
+            infoprintf("[Output priority set to %d]\n", priority);
+        }
+    }
+
+#ifdef PLATFORM_LINUX
+    int cpu = rc().output_cpu();
+    if (cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof cpus, &cpus) != 0)
+        {
+            errprintf("output_thread_func: couldn't pin to CPU %d\n", cpu);
+        }
+        else
+        {
+            infoprintf("[Output thread pinned to CPU %d]\n", cpu);
         }
     }
+#endif
+
     p->output_func();
 #endif
 
@@ -3099,19 +3400,12 @@ perform::output_func ()
 #ifdef PLATFORM_WINDOWS
         long last;                          // beginning time
         long current;                       // current time
-#ifdef SEQ64_STATISTICS_SUPPORT
-        long stats_loop_start = 0;
-        long stats_loop_finish = 0;
-#endif
         long delta;                         // difference between last & current
 #else                                       // not Windows
         struct timespec last;               // beginning time
         struct timespec current;            // current time
-#ifdef SEQ64_STATISTICS_SUPPORT
-        struct timespec stats_loop_start;
-        struct timespec stats_loop_finish;
-#endif
         struct timespec delta;              // difference between last & current
+        struct timespec deadline;           // absolute time of next wakeup
 #endif
 
         jack_scratchpad pad;
@@ -3144,30 +3438,13 @@ perform::output_func ()
         pad.js_delta_tick_frac = 0L;        // from seq24 0.9.3, long value
 
         /*
-         * Not sure that we really need this feature.  Will have to see if
-         * anyone wants it.  This is currently not a complete commenting out
-         * of the feature at this time.
+         * For the MIDI clock jitter of the output statistics:  the number of
+         * MIDI clocks emitted so far, or -1 until the first frame, and the
+         * time of the frame that emitted the last one.
          */
 
-#ifdef SEQ64_STATISTICS_SUPPORT
-        midipulse stats_total_tick = 0;
-        long stats_loop_index = 0;
-        long stats_min = 0x7FFFFFFF;
-        long stats_max = 0;
-        long stats_avg = 0;
-        long stats_last_clock_us = 0;
-        long stats_clock_width_us = 0;
-        long stats_all[100];                // why 100?
-        long stats_clock[100];
-        if (rc().stats())                   // \change ca 2016-01-24
-        {
-            for (int i = 0; i < 100; ++i)
-            {
-                stats_all[i] = 0;
-                stats_clock[i] = 0;
-            }
-        }
-#endif  // SEQ64_STATISTICS_SUPPORT
+        long clock_count = -1;
+        std::int64_t clock_last_us = 0;
 
         /*
          * If we are in the performance view (song editor), we care about
@@ -3194,28 +3471,13 @@ perform::output_func ()
 
         int ppqn = m_master_bus->get_ppqn();
 
-#ifdef SEQ64_STATISTICS_SUPPORT
-
-#ifdef PLATFORM_WINDOWS
-        last = timeGetTime();                   // get start time position
-        if (rc().stats())
-            stats_last_clock_us = last * 1000;
-#else
-        clock_gettime(CLOCK_REALTIME, &last);   // get start time position
-        if (rc().stats())
-            stats_last_clock_us = (last.tv_sec*1000000) + (last.tv_nsec/1000);
-#endif
-
-#else   // SEQ64_STATISTICS_SUPPORT
-
 #ifdef PLATFORM_WINDOWS
         last = timeGetTime();                   // get start time position
 #else
-        clock_gettime(CLOCK_REALTIME, &last);   // get start time position
+        clock_gettime(CLOCK_MONOTONIC, &last);  // get start time position
+        deadline = last;                        // first wakeup deadline
 #endif
 
-#endif  // SEQ64_STATISTICS_SUPPORT
-
         while (m_running)
         {
             /**
@@ -3226,16 +3488,8 @@ perform::output_func ()
              * -# Play from current tick to prebuffer.
              */
 
-#ifdef SEQ64_STATISTICS_SUPPORT
-            if (rc().stats())
-            {
-#ifdef PLATFORM_WINDOWS
-                stats_loop_start = timeGetTime();
-#else
-                clock_gettime(CLOCK_REALTIME, &stats_loop_start);
-#endif
-            }
-#endif  // SEQ64_STATISTICS_SUPPORT
+            std::int64_t frame_start_us = wakeup_event::now_us();
+            long frame_start_events = m_master_bus->events_sent();
 
             /*
              * Get the delta time.
@@ -3246,7 +3500,7 @@ perform::output_func ()
             delta = current - last;
             long delta_us = delta * 1000;
 #else
-            clock_gettime(CLOCK_REALTIME, &current);
+            clock_gettime(CLOCK_MONOTONIC, &current);
             delta.tv_sec  = current.tv_sec - last.tv_sec;       // delta!
             delta.tv_nsec = current.tv_nsec - last.tv_nsec;     // delta!
             long delta_us = (delta.tv_sec * 1000000) + (delta.tv_nsec / 1000);
@@ -3419,40 +3673,57 @@ perform::output_func ()
 
                 m_master_bus->emit_clock(midipulse(pad.js_clock_tick));
 
-#ifdef SEQ64_STATISTICS_SUPPORT
-                if (rc().stats())
+                /*
+                 * The MIDI clock jitter is the difference between the time
+                 * since the previous MIDI clock and the nominal clock
+                 * interval.  The clocks that fall in the same frame go out
+                 * together, so all but the first have an interval of 0.
+                 * After a jump in position, the count starts over.
+                 */
+
+                int ct = clock_ticks_from_ppqn(m_ppqn);
+                if (ct > 0)
                 {
-                    while (stats_total_tick <= pad.js_total_tick)
-                    {
-                        /*
-                         * Uses inline function for c_ppqn / 24.  Checks to see
-                         * if there was a tick.  What's up with the constants
-                         * 100 and 300?
-                         */
+                    long clocks = long(pad.js_clock_tick) / ct;
+                    long newclocks = clocks - clock_count;
+                    bool counted = clock_count >= 0 && newclocks > 0 &&
+                        newclocks <= SEQ64_MIDI_CLOCK_IN_PPQN;
 
-                        int ct = clock_ticks_from_ppqn(m_ppqn);
-                        if ((stats_total_tick % ct) == 0)
-                        {
-#ifdef PLATFORM_WINDOWS
-                            long current_us = current * 1000;
-#else
-                            long current_us = (current.tv_sec * 1000000) +
-                                (current.tv_nsec / 1000);
-#endif
-                            stats_clock_width_us = current_us-stats_last_clock_us;
-                            stats_last_clock_us = current_us;
+                    if (counted)
+                    {
+                        std::int64_t nominal_us =
+                            std::int64_t(pulse_length_us(bpm, m_ppqn) * ct);
 
-                            int index = stats_clock_width_us / 300;
-                            if (index >= 100)
-                                index = 99;
+                        std::int64_t interval_us =
+                            frame_start_us - clock_last_us;
 
-                            stats_clock[index]++;
+                        for (long c = 0; c < newclocks; ++c)
+                        {
+                            std::int64_t error_us = interval_us - nominal_us;
+                            m_output_stats.add
+                            (
+                                perfstats::CLOCK_JITTER,
+                                error_us < 0 ? -error_us : error_us
+                            );
+                            interval_us = 0;
                         }
-                        stats_total_tick++;
+                    }
+                    if (newclocks != 0)
+                    {
+                        clock_count = clocks;
+                        clock_last_us = frame_start_us;
                     }
                 }
-#endif  // SEQ64_STATISTICS_SUPPORT
             }
+            m_output_stats.add
+            (
+                perfstats::FRAME_TIME, wakeup_event::now_us() - frame_start_us
+            );
+            m_output_stats.add
+            (
+                perfstats::FRAME_EVENTS,
+                m_master_bus->events_sent() - frame_start_events
+            );
 
             /**
              *  Figure out how much time we need to sleep, and do it.
@@ -3464,12 +3735,6 @@ perform::output_func ()
             current = timeGetTime();
             delta = current - last;
             long elapsed_us = delta * 1000;
-#else
-            clock_gettime(CLOCK_REALTIME, &current);
-            delta.tv_sec  = current.tv_sec  - last.tv_sec;
-            delta.tv_nsec = current.tv_nsec - last.tv_nsec;
-            long elapsed_us = (delta.tv_sec * 1000000) + (delta.tv_nsec / 1000);
-#endif
 
             /**
              * Now we want to trigger every c_thread_trigger_width_us, and it
@@ -3477,11 +3742,25 @@ perform::output_func ()
              */
 
             delta_us = c_thread_trigger_width_us - elapsed_us;
+#else
+            clock_gettime(CLOCK_MONOTONIC, &current);
+
+            /**
+             * Now we want to trigger every c_thread_trigger_width_us.  This
+             * period is added to the absolute deadline of the previous
+             * wakeup, so that neither the time spent in play() nor any
+             * oversleeping accumulates as drift.
+             */
+
+            delta_us = c_thread_trigger_width_us;
+#endif
 
             /**
              * Check MIDI clock adjustment.  Note that we replaced
              * "60000000.0f / m_ppqn / bpm" with a call to a function.  We
-             * also removed the "f" specification from the constants.
+             * also removed the "f" specification from the constants.  The
+             * adjusted delay is a time from now, not a period, so its
+             * deadline is counted from the current time.
              */
 
             double dct = double_ticks_from_ppqn(m_ppqn);
@@ -3490,96 +3769,109 @@ perform::output_func ()
             double next_clock_delta_us =
                 next_clock_delta * pulse_length_us(bpm, m_ppqn);
 
-            if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
+            bool clock_adjusted =
+                next_clock_delta_us < (c_thread_trigger_width_us * 2.0);
+
+            if (clock_adjusted)
                 delta_us = long(next_clock_delta_us);
 
+#ifdef PLATFORM_WINDOWS
             if (delta_us > 0)
             {
-#ifdef PLATFORM_WINDOWS
                 delta = delta_us / 1000;
                 Sleep(delta);
+            }
+            else if (! clock_adjusted)
+                m_output_stats.underrun();
 #else
-                delta.tv_sec = delta_us / 1000000;
-                delta.tv_nsec = (delta_us % 1000000) * 1000;
-                nanosleep(&delta, NULL);    /* nanosleep() is Linux */
-#endif
+            if (delta_us < 0)
+                delta_us = 0;
+
+            if (clock_adjusted)
+                deadline = current;
+
+            deadline.tv_sec += delta_us / 1000000;
+            deadline.tv_nsec += (delta_us % 1000000) * 1000;
+            if (deadline.tv_nsec >= 1000000000)
+            {
+                deadline.tv_nsec -= 1000000000;
+                ++deadline.tv_sec;
+            }
+
+            /*
+             * If the deadline has already passed, we are behind by a whole
+             * period.  Do not try to catch up with a burst of short frames;
+             * start a new series of deadlines from now.
+             */
+
+            bool missed = ! clock_adjusted &&
+            (
+                current.tv_sec > deadline.tv_sec ||
+                (
+                    current.tv_sec == deadline.tv_sec &&
+                    current.tv_nsec >= deadline.tv_nsec
+                )
+            );
+            if (missed)
+            {
+                deadline = current;
+                m_output_stats.underrun();
             }
-#ifdef SEQ64_STATISTICS_SUPPORT
             else
             {
-                if (rc().stats())
+                struct timespec woke;
+                while
+                (
+                    clock_nanosleep
+                    (
+                        CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL
+                    ) == EINTR
+                )
                 {
-                    errprint("Underrun");
+                    // interrupted by a signal, sleep again until deadline
                 }
-            }
-#endif  // SEQ64_STATISTICS_SUPPORT
-
-#ifdef SEQ64_STATISTICS_SUPPORT
-            if (rc().stats())
-            {
-#ifdef PLATFORM_WINDOWS
-                stats_loop_finish = timeGetTime();
-                delta = stats_loop_finish - stats_loop_start;
-                long delta_us = delta * 1000;
-#else
-                clock_gettime(CLOCK_REALTIME, &stats_loop_finish);
-                delta.tv_sec  = stats_loop_finish.tv_sec-stats_loop_start.tv_sec;
-                delta.tv_nsec = stats_loop_finish.tv_nsec-stats_loop_start.tv_nsec;
-                long delta_us = (delta.tv_sec*1000000) + (delta.tv_nsec/1000);
-#endif
-                int index = delta_us / 100;         // why the 100?
-                if (index >= 100)
-                    index = 99;
-
-                stats_all[index]++;
-                if (delta_us > stats_max)
-                    stats_max = delta_us;
+                clock_gettime(CLOCK_MONOTONIC, &woke);
 
-                if (delta_us < stats_min)
-                    stats_min = delta_us;
+                long late_us = (woke.tv_sec - deadline.tv_sec) * 1000000 +
+                    (woke.tv_nsec - deadline.tv_nsec) / 1000;
 
-                stats_avg += delta_us;
-                stats_loop_index++;
-                if (stats_loop_index > 200)         // what is 200?
-                {
-                    stats_loop_index = 0;
-                    stats_avg /= 200;
-                    printf
-                    (
-                        "stats_avg[%ld]us stats_min[%ld]us stats_max[%ld]us\n",
-                        stats_avg, stats_min, stats_max
-                    );
-                    stats_min = 0x7FFFFFFF;
-                    stats_max = 0;
-                    stats_avg = 0;
-                }
+                m_output_stats.add(perfstats::LATENESS, late_us);
             }
-#endif  // SEQ64_STATISTICS_SUPPORT
+#endif  // PLATFORM_WINDOWS
 
             if (pad.js_jack_stopped)
                 inner_stop();
         }
-#ifdef SEQ64_STATISTICS_SUPPORT
+
+        /*
+         * Report how precisely the output thread met its wakeup deadlines,
+         * since the statistics were last reset.  The lateness is the time
+         * between the deadline and the actual wakeup; a missed wakeup is
+         * one whose deadline had already passed when play() finished.
+         */
+
         if (rc().stats())
         {
-            printf("\n\n-- trigger width --\n");
-            for (int i = 0; i < 100; ++i)
+            perfstats::snapshot snap;
+            m_output_stats.get(snap);
+
+            const stats_values & late = snap.ss_metrics[perfstats::LATENESS];
+            if (late.sv_count > 0 || snap.ss_underruns > 0)
             {
-                printf("[%3d][%8ld]\n", i * 100, stats_all[i]);
+                printf
+                (
+                    "output wakeups[%ld] missed[%ld] "
+                    "late avg[%ld]us max[%ld]us\n",
+                    late.sv_count, snap.ss_underruns,
+                    long(perfstats::average(late)), long(late.sv_max)
+                );
             }
-            printf("\n\n-- clock width --\n");
-
-            midibpm bpm  = m_master_bus->get_beats_per_minute();
             printf
             (
-                "optimal: [%d us]\n", int(clock_tick_duration_bogus(bpm, m_ppqn))
+                "output stats %s\n",
+                perfstats::to_json(snap, long(time(NULL))).c_str()
             );
-            for (int i = 0; i < 100; ++i)
-            {
-                printf("[%3d][%8ld]\n", i * 300, stats_clock[i]);
-            }
         }
-#endif  // SEQ64_STATISTICS_SUPPORT
 
         /*
          * Disabling this setting allows all of the progress bars (seqroll,
@@ -3682,6 +3974,52 @@ input_thread_func (void * myperf)
     return nullptr;
 }
 
+/**
+ *  Runs a worker thread of the perform object.  The thread gets the same
+ *  SCHED_FIFO priority as the output thread, which waits for it every
+ *  frame.  It is pinned by launch_play_workers(), to a CPU next to that of
+ *  the output thread, rather than to the same one, which would leave it
+ *  nothing to do in parallel.  Unlike the output thread, it keeps running
+ *  if the priority cannot be set, since the output thread would wait for
+ *  it forever.
+ *
+ * \param myperf
+ *      Provides the perform object instance that is to be used.  Its
+ *      play_worker_func() is called.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+play_worker_thread_func (void * myperf)
+{
+    perform * p = (perform *) myperf;
+
+#ifndef PLATFORM_WINDOWS
+    int priority = rc().output_priority();      /* [output-thread] setting  */
+    if (priority == 0 && rc().priority())
+        priority = 1;
+
+    if (priority > 0)
+    {
+        struct sched_param schp;
+        memset(&schp, 0, sizeof(sched_param));
+        schp.sched_priority = priority;
+        if (sched_setscheduler(0, SCHED_FIFO, &schp) != 0)
+        {
+            errprint
+            (
+                "play_worker_thread_func: couldn't sched_setscheduler(FIFO)"
+            );
+        }
+    }
+#endif
+
+    p->play_worker_func();
+    return nullptr;
+}
+
 /**
  *  Handle the MIDI Control values that provide some automation for the
  *  application.
@@ -3929,11 +4267,155 @@ perform::handle_midi_control_ex (int ctl, midi_control::action a, int v)
     return result;
 }
 
+/**
+ *  Rebuilds the MIDI control lookup table from the active toggle, on, and
+ *  off controls.  This is a counting sort of the entries by key:  the first
+ *  pass counts the entries of each key, the second turns the counts into
+ *  bucket ends, and the third, going backwards, drops each entry into its
+ *  bucket, which leaves the entries of each bucket in ascending order and
+ *  m_midi_control_index[key] at the start of the bucket.
+ *
+ *  A control whose status is not a status byte, or whose data is not a data
+ *  byte, can never match a MIDI message, and is left out.
+ */
+
+void
+perform::rebuild_midi_control_index ()
+{
+    const midi_control * controls[3] =
+    {
+        m_midi_cc_toggle, m_midi_cc_on, m_midi_cc_off
+    };
+    int keys[3 * c_midi_controls_extended];
+    int count = 0;
+    for (int key = 0; key <= SEQ64_MIDI_CONTROL_KEYS; ++key)
+        m_midi_control_index[key] = 0;
+
+    for (int ctl = 0; ctl < c_midi_controls_extended; ++ctl)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            const midi_control & mc = controls[a][ctl];
+            int entry = ctl * 3 + a;
+            keys[entry] = -1;
+            if (! mc.active())
+                continue;
+
+            if (mc.status() < 0x80 || mc.status() > 0xFF)
+                continue;
+
+            if (mc.data() < 0 || mc.data() > 0x7F)
+                continue;
+
+            keys[entry] = midi_control_key(mc.status(), mc.data());
+            ++m_midi_control_index[keys[entry]];
+            ++count;
+        }
+    }
+
+    int total = 0;
+    for (int key = 0; key < SEQ64_MIDI_CONTROL_KEYS; ++key)
+    {
+        total += m_midi_control_index[key];
+        m_midi_control_index[key] = (unsigned short)(total);
+    }
+    m_midi_control_index[SEQ64_MIDI_CONTROL_KEYS] = (unsigned short)(count);
+    for (int entry = 3 * c_midi_controls_extended - 1; entry >= 0; --entry)
+    {
+        int key = keys[entry];
+        if (key >= 0)
+        {
+            int slot = --m_midi_control_index[key];
+            m_midi_control_entries[slot] = (unsigned short)(entry);
+        }
+    }
+}
+
+/**
+ *  Performs the action of one MIDI control that matched an incoming event.
+ *  This is the body of the old control loop of midi_control_event().
+ *
+ * \param ctl
+ *      The number of the control.
+ *
+ * \param a
+ *      Indicates whether the toggle, on, or off setting of the control
+ *      matched.
+ *
+ * \param value
+ *      The second data byte of the event, checked against the range of the
+ *      control.
+ *
+ * \param offset
+ *      The sequence number the control applies to, if it is a sequence
+ *      control.
+ *
+ * \return
+ *      Returns true if an extended control was handled, in which case no
+ *      further controls are to be checked.
+ */
+
+bool
+perform::dispatch_midi_control
+(
+    int ctl, midi_control::action a, midibyte value, int offset
+)
+{
+    bool is_a_sequence = ctl < m_seqs_in_set;
+    bool is_extended = ctl >= c_midi_controls && ctl < c_midi_controls_extended;
+    if (a == midi_control::action_toggle)
+    {
+        if (m_midi_cc_toggle[ctl].in_range(value))
+        {
+            if (is_a_sequence)
+                sequence_playing_toggle(offset);
+            else if (is_extended)
+                return handle_midi_control_ex(ctl, a, value);
+        }
+        return false;
+    }
+
+    const midi_control & mc = a == midi_control::action_on ?
+        m_midi_cc_on[ctl] : m_midi_cc_off[ctl] ;
+
+    bool on = a == midi_control::action_on;
+    if (! mc.in_range(value))                   /* Issue #35 for "off"      */
+    {
+        if (! mc.inverse_active())
+            return false;
+
+        on = ! on;
+    }
+    if (is_a_sequence)
+    {
+        if (on)
+            sequence_playing_on(offset);
+        else
+            sequence_playing_off(offset);
+    }
+    else if (is_extended)
+    {
+        return handle_midi_control_ex
+        (
+            ctl, on ? midi_control::action_on : midi_control::action_off, value
+        );
+    }
+    else
+        handle_midi_control(ctl, on);
+
+    return false;
+}
+
 /**
  *  This function encapsulates code in input_func() to make it easier to read
  *  and understand.
  *
- *  Here is the processing involved in this function ....
+ *  Rather than checking the toggle, on, and off settings of every control
+ *  against the event, it looks up the controls that match the status and
+ *  first data byte of the event in the MIDI control lookup table, which is
+ *  rebuilt first if the controls have been changed.  The matching controls
+ *  are handled in the order of the old scan:  by control number, then
+ *  toggle, on, and off.
  *
  *  Incorporates pull request #24, arnaud-jacquemin, issue #23 "MIDI controller
  *  toggles wrong pattern".
@@ -3954,92 +4436,69 @@ perform::midi_control_event (const event & ev)
 {
     midibyte data[2] = { 0, 0 };
     midibyte status = ev.get_status();
-    int offset = m_screenset_offset;
     ev.get_data(data[0], data[1]);
-    for (int ctl = 0; ctl < g_midi_control_limit; ++ctl, ++offset)
+    if (status < 0x80 || data[0] > 0x7F)
+        return;
+
+    if (m_midi_control_stale.exchange(false))
+        rebuild_midi_control_index();
+
+    int key = midi_control_key(status, data[0]);
+    int offset = m_screenset_offset;
+    int first = m_midi_control_index[key];
+    int last = m_midi_control_index[key + 1];
+    for (int i = first; i < last; ++i)
     {
-        bool is_a_sequence = ctl < m_seqs_in_set;
-        bool is_extended = ctl >= c_midi_controls && ctl < c_midi_controls_extended;
-        if (midi_control_toggle(ctl).match(status, data[0]))
-        {
-            if (midi_control_toggle(ctl).in_range(data[1]))
-            {
-                if (is_a_sequence)
-                {
-                    sequence_playing_toggle(offset);
-                }
-                else if (is_extended)
-                {
-                    if (handle_midi_control_ex(ctl, midi_control::action_toggle, data[1]))
-                        break;
-                }
-            }
-        }
-        if (midi_control_on(ctl).match(status, data[0]))
-        {
-            if (midi_control_on(ctl).in_range(data[1]))
-            {
-                if (is_a_sequence)
-                {
-                    sequence_playing_on(offset);
-                }
-                else if (is_extended)
-                {
-                    if (handle_midi_control_ex(ctl, midi_control::action_on, data[1]))
-                        break;
-                }
-                else
-                    handle_midi_control(ctl, true);
-            }
-            else if (midi_control_on(ctl).inverse_active())
-            {
-                if (is_a_sequence)
-                {
-                    sequence_playing_off(offset);
-                }
-                else if (is_extended)
-                {
-                    if (handle_midi_control_ex(ctl, midi_control::action_off, data[1]))
-                        break;
-                }
-                else
-                    handle_midi_control(ctl, false);
-            }
-        }
-        if (midi_control_off(ctl).match(status, data[0]))
-        {
-            if (midi_control_off(ctl).in_range(data[1]))  /* Issue #35 */
-            {
-                if (is_a_sequence)
-                {
-                    sequence_playing_off(offset);
-                }
-                else if (is_extended)
-                {
-                    if (handle_midi_control_ex(ctl, midi_control::action_off, data[1]))
-                        break;
-                }
-                else
-                    handle_midi_control(ctl, false);
-            }
-            else if (midi_control_off(ctl).inverse_active())
-            {
-                if (is_a_sequence)
-                {
-                    sequence_playing_on(offset);
-                }
-                else if (is_extended)
-                {
-                    if (handle_midi_control_ex(ctl, midi_control::action_on, data[1]))
-                        break;
-                }
-                else
-                    handle_midi_control(ctl, true);
-            }
-        }
+        int ctl = m_midi_control_entries[i] / 3;
+        midi_control::action a =
+            midi_control::action(m_midi_control_entries[i] % 3);
+
+        if (ctl >= g_midi_control_limit)
+            break;
+
+        if (dispatch_midi_control(ctl, a, data[1], offset + ctl))
+            break;
     }
 }
 
+/**
+ *  Looks up the MIDI controls that an event with the given status and first
+ *  data byte would trigger, as midi_control_event() does, without taking
+ *  any action.  Used by the tests to check the lookup table.
+ *
+ * \param status
+ *      The status byte, which must be 0x80 or greater.
+ *
+ * \param data
+ *      The first data byte, which must be less than 0x80.
+ *
+ * \param [out] entries
+ *      The matching entries, in table order, each encoded as the control
+ *      number times 3 plus the midi_control::action.
+ *
+ * \return
+ *      Returns the number of matching entries.
+ */
+
+int
+perform::midi_control_matches
+(
+    midibyte status, midibyte data, std::vector<int> & entries
+)
+{
+    entries.clear();
+    if (m_midi_control_stale.exchange(false))
+        rebuild_midi_control_index();
+
+    int key = midi_control_key(status, data);
+    int first = m_midi_control_index[key];
+    int last = m_midi_control_index[key + 1];
+    for (int i = first; i < last; ++i)
+        entries.push_back(m_midi_control_entries[i]);
+
+    return int(entries.size());
+}
+
 /**
  *  This function is called by input_thread_func().
  *
@@ -4155,7 +4614,7 @@ perform::input_func ()
 
                         if (m_master_bus->is_dumping())
                         {
-                            ev.set_timestamp(m_tick);
+                            ev.set_timestamp(input_tick(ev.get_timestamp()));
 #ifdef USE_STAZED_MIDI_DUMP
                             m_master_bus->dump_midi_input(ev);
 #else
@@ -4177,11 +4636,96 @@ perform::input_func ()
                     }
                 }
             } while (m_master_bus->is_more_input());
+            m_master_bus->input_handled();
         }
     }
+
+    /*
+     * Report the time from the arrival of input (as signalled by the MIDI
+     * API, currently JACK only) to the end of its handling here.
+     */
+
+    long batches = m_master_bus->input_batches();
+    if (rc().stats() && batches > 0)
+    {
+        printf
+        (
+            "input batches[%ld] latency avg[%lld]us max[%lld]us\n",
+            batches, (long long) m_master_bus->input_latency_avg_us(),
+            (long long) m_master_bus->input_latency_max_us()
+        );
+    }
     pthread_exit(0);
 }
 
+/**
+ *  Converts the arrival time of an input event to the tick at which it
+ *  arrived.  The output thread advances m_tick only once per wakeup, so
+ *  using m_tick itself would quantize recorded events to the output
+ *  thread's period.  Instead, the time elapsed since the last play() is
+ *  converted to ticks at the current tempo, and added to the tick played.
+ *
+ *  The player hears the output some time after it is played:  the
+ *  lookahead of the scheduled-output mode, plus one process period with
+ *  JACK.  That latency, from mastermidibase::output_latency_ticks(), is
+ *  subtracted, so that the event is recorded at the tick the player was
+ *  hearing when playing it.
+ *
+ *  If the MIDI API did not stamp the event, if playback is not running, or
+ *  if the tempo follows an incoming MIDI clock, m_tick is returned, without
+ *  any latency correction.
+ *
+ *  Where a midipulse is narrower than 64 bits, the timestamp of the event
+ *  holds only the low bits of the arrival time, so only the low 32 bits of
+ *  the two times are subtracted.  That is exact as long as the event
+ *  arrived within half an hour of the last play().
+ *
+ * \param arrivalus
+ *      The arrival time of the event, in wakeup_event::now_us()
+ *      microseconds, as set in the event's timestamp by the MIDI API, or 0.
+ *
+ * \return
+ *      Returns the tick at which the event arrived, never negative.
+ */
+
+midipulse
+perform::input_tick (std::int64_t arrivalus)
+{
+    if (arrivalus == 0 || ! is_running() || m_usemidiclock)
+        return m_tick;
+
+    midipulse tick = 0;
+    std::int64_t stampus = 0;
+    bool consistent = false;
+    while (! consistent)                    /* retry if play() interfered   */
+    {
+        unsigned seq = m_play_stamp_seq.load(std::memory_order_acquire);
+        tick = m_play_stamp_tick.load(std::memory_order_relaxed);
+        stampus = m_play_stamp_us.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        consistent = (seq & 1) == 0 &&
+            seq == m_play_stamp_seq.load(std::memory_order_relaxed);
+    }
+
+    if (stampus == 0)
+        return m_tick;
+
+    std::int64_t elapsedus = arrivalus - stampus;
+    if (sizeof(midipulse) < sizeof(std::int64_t))       /* truncated stamp  */
+    {
+        elapsedus = std::int32_t
+        (
+            std::uint32_t(arrivalus) - std::uint32_t(stampus)
+        );
+    }
+
+    midibpm bpm = m_master_bus->get_beats_per_minute();
+    double delta = double(elapsedus) * bpm * m_ppqn / 60000000.0;
+    midipulse result = tick + midipulse(delta + (delta < 0.0 ? -0.5 : 0.5));
+    result -= m_master_bus->output_latency_ticks();
+    return result < 0 ? 0 : result ;
+}
+
 /**
  *  Combines bytes into an unsigned-short value.
  *
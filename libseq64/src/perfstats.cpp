@@ -0,0 +1,349 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          perfstats.cpp
+ *
+ *  This module defines a class for collecting timing statistics on the
+ *  output thread of a performance.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The dumps made by to_json() and to_csv() are single lines, so that a
+ *  monitoring tool can follow a file to which they are appended.
+ */
+
+#include <stdio.h>                      /* snprintf()                       */
+
+#include "mutex.hpp"                    /* seq64::wakeup_event::now_us()    */
+#include "perfstats.hpp"
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The names of the metrics, in the order of perfstats::metric_t, as used
+ *  in the dumps.  The suffix gives the unit.
+ */
+
+static const char * const s_metric_names[perfstats::METRICS] =
+{
+    "lateness_us",
+    "frame_time_us",
+    "frame_events",
+    "clock_jitter_us"
+};
+
+/**
+ *  Default constructor.  All of the statistics start at zero.
+ */
+
+perfstats::perfstats ()
+ :
+    m_metrics       (),
+    m_underruns     (0),
+    m_reset_us      (0)
+{
+    reset();
+}
+
+/**
+ *  Adds a value to a metric.  Called only by the output thread.  The value
+ *  lands in the bucket given by its number of significant bits.
+ *
+ * \param which
+ *      The metric to add the value to.
+ *
+ * \param value
+ *      The value to add.  Negative values are counted as zero.
+ */
+
+void
+perfstats::add (metric_t which, std::int64_t value)
+{
+    if (value < 0)
+        value = 0;
+
+    int bucket = 0;
+    std::int64_t v = value;
+    while (v > 0 && bucket < SEQ64_STATS_BUCKETS - 1)
+    {
+        v >>= 1;
+        ++bucket;
+    }
+
+    metric & m = m_metrics[which];
+    m.m_count.fetch_add(1, std::memory_order_relaxed);
+    m.m_total.fetch_add(value, std::memory_order_relaxed);
+    m.m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    std::int64_t oldmax = m.m_max.load(std::memory_order_relaxed);
+    while (value > oldmax && ! m.m_max.compare_exchange_weak(oldmax, value))
+    {
+        // oldmax has been reloaded; try again
+    }
+}
+
+/**
+ *  Sets all of the statistics back to zero, and restarts the elapsed time.
+ *  Can be called by any thread.
+ */
+
+void
+perfstats::reset ()
+{
+    for (int w = 0; w < METRICS; ++w)
+    {
+        metric & m = m_metrics[w];
+        m.m_count.store(0, std::memory_order_relaxed);
+        m.m_total.store(0, std::memory_order_relaxed);
+        m.m_max.store(0, std::memory_order_relaxed);
+        for (int b = 0; b < SEQ64_STATS_BUCKETS; ++b)
+            m.m_buckets[b].store(0, std::memory_order_relaxed);
+    }
+    m_underruns.store(0, std::memory_order_relaxed);
+    m_reset_us.store(wakeup_event::now_us(), std::memory_order_relaxed);
+}
+
+/**
+ *  Copies the statistics.  Can be called by any thread.
+ *
+ * \param [out] s
+ *      The destination of the copy.
+ */
+
+void
+perfstats::get (snapshot & s) const
+{
+    for (int w = 0; w < METRICS; ++w)
+    {
+        const metric & m = m_metrics[w];
+        stats_values & sv = s.ss_metrics[w];
+        sv.sv_count = m.m_count.load(std::memory_order_relaxed);
+        sv.sv_total = m.m_total.load(std::memory_order_relaxed);
+        sv.sv_max = m.m_max.load(std::memory_order_relaxed);
+        for (int b = 0; b < SEQ64_STATS_BUCKETS; ++b)
+            sv.sv_buckets[b] = m.m_buckets[b].load(std::memory_order_relaxed);
+    }
+    s.ss_underruns = m_underruns.load(std::memory_order_relaxed);
+    s.ss_elapsed_us =
+        wakeup_event::now_us() - m_reset_us.load(std::memory_order_relaxed);
+}
+
+/**
+ * \return
+ *      Returns the name of a metric, as used in the dumps.
+ */
+
+const char *
+perfstats::name (metric_t which)
+{
+    return s_metric_names[which];
+}
+
+/**
+ * \param bucket
+ *      The histogram bucket, from 0 to SEQ64_STATS_BUCKETS - 1.
+ *
+ * \return
+ *      Returns the largest value counted in the bucket, or, for the last
+ *      bucket, the smallest.
+ */
+
+std::int64_t
+perfstats::bucket_limit (int bucket)
+{
+    if (bucket <= 0)
+        return 0;
+    else if (bucket == SEQ64_STATS_BUCKETS - 1)
+        return std::int64_t(1) << (bucket - 1);
+    else
+        return (std::int64_t(1) << bucket) - 1;
+}
+
+/**
+ * \return
+ *      Returns the average of the values of a metric, or 0 if it has none.
+ */
+
+std::int64_t
+perfstats::average (const stats_values & sv)
+{
+    return sv.sv_count > 0 ? sv.sv_total / sv.sv_count : 0 ;
+}
+
+/**
+ *  Estimates a percentile of a metric from its histogram.  The estimate is
+ *  the upper limit of the bucket holding the percentile, but never more
+ *  than the maximum value.
+ *
+ * \param sv
+ *      The values of the metric.
+ *
+ * \param percent
+ *      The percentile wanted, from 0 to 100.
+ *
+ * \return
+ *      Returns the estimate, or 0 if the metric has no values.
+ */
+
+std::int64_t
+perfstats::percentile (const stats_values & sv, int percent)
+{
+    long wanted = (sv.sv_count * percent + 99) / 100;
+    long seen = 0;
+    for (int b = 0; b < SEQ64_STATS_BUCKETS - 1; ++b)
+    {
+        seen += sv.sv_buckets[b];
+        if (seen >= wanted && seen > 0)
+        {
+            std::int64_t limit = bucket_limit(b);
+            return limit < sv.sv_max ? limit : sv.sv_max ;
+        }
+    }
+    return sv.sv_max;
+}
+
+/**
+ *  Formats the statistics as a single-line JSON object.  Each metric is an
+ *  object with its count, average, maximum, 50th and 99th percentiles, and
+ *  histogram buckets.
+ *
+ * \param s
+ *      The statistics to format.
+ *
+ * \param timestamp
+ *      The time of the snapshot, normally in seconds since the epoch.
+ *
+ * \return
+ *      Returns the JSON text, without a trailing newline.
+ */
+
+std::string
+perfstats::to_json (const snapshot & s, long timestamp)
+{
+    char temp[128];
+    snprintf
+    (
+        temp, sizeof temp,
+        "{\"time\":%ld,\"elapsed_us\":%lld,\"underruns\":%ld",
+        timestamp, (long long) s.ss_elapsed_us, s.ss_underruns
+    );
+
+    std::string result = temp;
+    for (int w = 0; w < METRICS; ++w)
+    {
+        const stats_values & sv = s.ss_metrics[w];
+        snprintf
+        (
+            temp, sizeof temp,
+            ",\"%s\":{\"count\":%ld,\"avg\":%lld,\"max\":%lld,"
+            "\"p50\":%lld,\"p99\":%lld,\"buckets\":[",
+            s_metric_names[w], sv.sv_count, (long long) average(sv),
+            (long long) sv.sv_max, (long long) percentile(sv, 50),
+            (long long) percentile(sv, 99)
+        );
+        result += temp;
+        for (int b = 0; b < SEQ64_STATS_BUCKETS; ++b)
+        {
+            const char * format = b > 0 ? ",%ld" : "%ld" ;
+            snprintf(temp, sizeof temp, format, sv.sv_buckets[b]);
+            result += temp;
+        }
+        result += "]}";
+    }
+    result += "}";
+    return result;
+}
+
+/**
+ * \return
+ *      Returns the header line matching to_csv(), without a trailing
+ *      newline.
+ */
+
+std::string
+perfstats::csv_header ()
+{
+    std::string result = "time,elapsed_us,underruns";
+    for (int w = 0; w < METRICS; ++w)
+    {
+        std::string name = s_metric_names[w];
+        result += "," + name + "_count";
+        result += "," + name + "_avg";
+        result += "," + name + "_max";
+        result += "," + name + "_p50";
+        result += "," + name + "_p99";
+    }
+    return result;
+}
+
+/**
+ *  Formats the statistics as a CSV line.  The histograms are left out; see
+ *  csv_header() for the columns.
+ *
+ * \param s
+ *      The statistics to format.
+ *
+ * \param timestamp
+ *      The time of the snapshot, normally in seconds since the epoch.
+ *
+ * \return
+ *      Returns the CSV line, without a trailing newline.
+ */
+
+std::string
+perfstats::to_csv (const snapshot & s, long timestamp)
+{
+    char temp[128];
+    snprintf
+    (
+        temp, sizeof temp, "%ld,%lld,%ld",
+        timestamp, (long long) s.ss_elapsed_us, s.ss_underruns
+    );
+
+    std::string result = temp;
+    for (int w = 0; w < METRICS; ++w)
+    {
+        const stats_values & sv = s.ss_metrics[w];
+        snprintf
+        (
+            temp, sizeof temp, ",%ld,%lld,%lld,%lld,%lld",
+            sv.sv_count, (long long) average(sv), (long long) sv.sv_max,
+            (long long) percentile(sv, 50), (long long) percentile(sv, 99)
+        );
+        result += temp;
+    }
+    return result;
+}
+
+}           // namespace seq64
+
+/*
+ * perfstats.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
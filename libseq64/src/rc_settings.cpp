@@ -96,6 +96,13 @@ rc_settings::rc_settings ()
 #endif
     m_manual_alsa_ports         (false),
     m_reveal_alsa_ports         (false),
+    m_alsa_scheduled_output     (false),
+    m_alsa_lookahead_ms         (SEQ64_DEFAULT_LOOKAHEAD_MS),
+    m_output_priority           (0),
+    m_output_cpu                (-1),
+    m_play_workers              (0),
+    m_undo_memory_kb            (SEQ64_DEFAULT_UNDO_MEMORY_KB),
+    m_autosave_interval         (0),
     m_print_keys                (false),
     m_device_ignore             (false),
     m_device_ignore_num         (0),
@@ -104,6 +111,7 @@ rc_settings::rc_settings ()
     m_filename                  (),
     m_jack_session_uuid         (),
     m_last_used_dir             (),
+    m_autosave_filename         (SEQ64_DEFAULT_AUTOSAVE_FILE),
     m_config_directory          (),
     m_config_filename           (),
     m_user_filename             (),
@@ -141,6 +149,13 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_with_jack_midi            (rhs.m_with_jack_midi),
     m_manual_alsa_ports         (rhs.m_manual_alsa_ports),
     m_reveal_alsa_ports         (rhs.m_reveal_alsa_ports),
+    m_alsa_scheduled_output     (rhs.m_alsa_scheduled_output),
+    m_alsa_lookahead_ms         (rhs.m_alsa_lookahead_ms),
+    m_output_priority           (rhs.m_output_priority),
+    m_output_cpu                (rhs.m_output_cpu),
+    m_play_workers              (rhs.m_play_workers),
+    m_undo_memory_kb            (rhs.m_undo_memory_kb),
+    m_autosave_interval         (rhs.m_autosave_interval),
     m_print_keys                (rhs.m_print_keys),
     m_device_ignore             (rhs.m_device_ignore),
     m_device_ignore_num         (rhs.m_device_ignore_num),
@@ -149,6 +164,7 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_filename                  (rhs.m_filename),
     m_jack_session_uuid         (rhs.m_jack_session_uuid),
     m_last_used_dir             (rhs.m_last_used_dir),
+    m_autosave_filename         (rhs.m_autosave_filename),
     m_config_directory          (rhs.m_config_directory),
     m_config_filename           (rhs.m_config_filename),
     m_user_filename             (rhs.m_user_filename),
@@ -192,6 +208,13 @@ rc_settings::operator = (const rc_settings & rhs)
         m_with_jack_midi            = rhs.m_with_jack_midi;
         m_manual_alsa_ports         = rhs.m_manual_alsa_ports;
         m_reveal_alsa_ports         = rhs.m_reveal_alsa_ports;
+        m_alsa_scheduled_output     = rhs.m_alsa_scheduled_output;
+        m_alsa_lookahead_ms         = rhs.m_alsa_lookahead_ms;
+        m_output_priority           = rhs.m_output_priority;
+        m_output_cpu                = rhs.m_output_cpu;
+        m_play_workers              = rhs.m_play_workers;
+        m_undo_memory_kb            = rhs.m_undo_memory_kb;
+        m_autosave_interval         = rhs.m_autosave_interval;
         m_print_keys                = rhs.m_print_keys;
         m_device_ignore             = rhs.m_device_ignore;
         m_device_ignore_num         = rhs.m_device_ignore_num;
@@ -199,6 +222,7 @@ rc_settings::operator = (const rc_settings & rhs)
         m_filename                  = rhs.m_filename;
         m_jack_session_uuid         = rhs.m_jack_session_uuid;
         m_last_used_dir             = rhs.m_last_used_dir;
+        m_autosave_filename         = rhs.m_autosave_filename;
         m_config_directory          = rhs.m_config_directory;
         m_config_filename           = rhs.m_config_filename;
         m_user_filename             = rhs.m_user_filename;
@@ -242,6 +266,13 @@ rc_settings::set_defaults ()
     m_with_jack_master_cond     = false;
     m_manual_alsa_ports         = false;
     m_reveal_alsa_ports         = false;
+    m_alsa_scheduled_output     = false;
+    m_alsa_lookahead_ms         = SEQ64_DEFAULT_LOOKAHEAD_MS;
+    m_output_priority           = 0;
+    m_output_cpu                = -1;
+    m_play_workers              = 0;
+    m_undo_memory_kb            = SEQ64_DEFAULT_UNDO_MEMORY_KB;
+    m_autosave_interval         = 0;
     m_print_keys                = false;
     m_device_ignore             = false;
     m_device_ignore_num         = 0;
@@ -249,6 +280,7 @@ rc_settings::set_defaults ()
     m_filename.clear();
     m_jack_session_uuid.clear();
     m_last_used_dir             = "~/";
+    m_autosave_filename         = SEQ64_DEFAULT_AUTOSAVE_FILE;
     m_config_directory          = ".config/sequencer64";
     m_config_filename           = "sequencer64.rc";
     m_user_filename             = "sequencer64.usr";
@@ -355,6 +387,30 @@ rc_settings::user_filespec () const
     return result;
 }
 
+/**
+ *  Constructs the full path and file specification for the autosave file.
+ *
+ * \return
+ *      Returns m_autosave_filename if it includes a directory.  Otherwise,
+ *      it is appended to home_config_directory(), unless that is empty, in
+ *      which case an empty string is returned.
+ */
+
+std::string
+rc_settings::autosave_filespec () const
+{
+    std::string result = m_autosave_filename;
+    if (result.find_first_of(SLASH) == std::string::npos)
+    {
+        std::string directory = home_config_directory();
+        if (directory.empty())
+            result.clear();
+        else
+            result = directory + result;
+    }
+    return result;
+}
+
 /**
  * \setter m_device_ignore_num
  *      However, please note that this value, while set in the options
@@ -372,6 +428,79 @@ rc_settings::device_ignore_num (int value)
         m_device_ignore_num = value;
 }
 
+/**
+ * \setter m_alsa_lookahead_ms
+ *
+ * \param ms
+ *      The lookahead to use in the ALSA scheduled-output mode.  It is clamped
+ *      to the range SEQ64_MINIMUM_LOOKAHEAD_MS to SEQ64_MAXIMUM_LOOKAHEAD_MS.
+ */
+
+void
+rc_settings::alsa_lookahead_ms (int ms)
+{
+    if (ms < SEQ64_MINIMUM_LOOKAHEAD_MS)
+        ms = SEQ64_MINIMUM_LOOKAHEAD_MS;
+    else if (ms > SEQ64_MAXIMUM_LOOKAHEAD_MS)
+        ms = SEQ64_MAXIMUM_LOOKAHEAD_MS;
+
+    m_alsa_lookahead_ms = ms;
+}
+
+/**
+ * \setter m_output_priority
+ *
+ * \param priority
+ *      The SCHED_FIFO priority of the output thread, from 1 to 99, or 0 to
+ *      leave the thread with the normal scheduler.  Out-of-range values are
+ *      clamped.
+ */
+
+void
+rc_settings::output_priority (int priority)
+{
+    if (priority < 0)
+        priority = 0;
+    else if (priority > SEQ64_MAXIMUM_FIFO_PRIORITY)
+        priority = SEQ64_MAXIMUM_FIFO_PRIORITY;
+
+    m_output_priority = priority;
+}
+
+/**
+ * \setter m_output_cpu
+ *
+ * \param cpu
+ *      The CPU number to which the output thread is pinned, or -1 (or any
+ *      negative value) to let it run on any CPU.
+ */
+
+void
+rc_settings::output_cpu (int cpu)
+{
+    m_output_cpu = cpu < 0 ? -1 : cpu ;
+}
+
+/**
+ * \setter m_play_workers
+ *
+ * \param count
+ *      The number of worker threads that help the output thread play the
+ *      patterns, or 0 to have the output thread play them all by itself.
+ *      Out-of-range values are clamped.
+ */
+
+void
+rc_settings::play_workers (int count)
+{
+    if (count < 0)
+        count = 0;
+    else if (count > SEQ64_MAXIMUM_PLAY_WORKERS)
+        count = SEQ64_MAXIMUM_PLAY_WORKERS;
+
+    m_play_workers = count;
+}
+
 /**
  *  \setter m_tempo_track_number
  */
@@ -476,6 +605,23 @@ rc_settings::last_used_dir (const std::string & value)
         m_last_used_dir = value;
 }
 
+/**
+ * \setter m_autosave_filename
+ *
+ * \param value
+ *      The value to use to make the setting.  An empty value restores the
+ *      default name.
+ */
+
+void
+rc_settings::autosave_filename (const std::string & value)
+{
+    if (value.empty())
+        m_autosave_filename = SEQ64_DEFAULT_AUTOSAVE_FILE;
+    else
+        m_autosave_filename = value;
+}
+
 /**
  * \setter m_config_directory
  *
@@ -48,6 +48,7 @@
 #include "perform.hpp"
 #include "scales.h"
 #include "sequence.hpp"
+#include "sequence_edit.hpp"            /* seq64::sequence_edit             */
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
 
 #define LAYK_PULL_REQUEST_95
@@ -84,7 +85,13 @@ sequence::sequence (int ppqn)
     m_have_redo                 (false),        // stazed
     m_events_undo               (),
     m_events_redo               (),
-    m_iterator_draw             (m_events.begin()),
+    m_event_snapshot            (),
+    m_snapshot_serial           (0),
+    m_note_summary              (),
+    m_iterator_play             (m_events.begin()),
+    m_play_offset_base          (0),
+    m_play_next_tick            (SEQ64_NULL_MIDIPULSE),
+    m_play_revision             (0),
     m_channel_match             (false),        // a future stazed feature
     m_midi_channel              (0),
     m_bus                       (0),
@@ -94,6 +101,8 @@ sequence::sequence (int ppqn)
 #endif
     m_notes_on                  (0),
     m_masterbus                 (nullptr),
+    m_defer_output              (false),
+    m_deferred                  (),
     m_playing_notes             (),             // an array
     m_was_playing               (false),
     m_playing                   (false),
@@ -106,10 +115,8 @@ sequence::sequence (int ppqn)
     m_loop_reset                (false),
 #endif
     m_unit_measure              (0),
-    m_dirty_main                (true),
     m_dirty_edit                (true),
-    m_dirty_perf                (true),
-    m_dirty_names               (true),
+    m_generation                (0),
     m_editing                   (false),
     m_raise                     (false),
     m_name                      (),
@@ -142,6 +149,9 @@ sequence::sequence (int ppqn)
     m_triggers.set_length(m_length);
     for (int i = 0; i < c_midi_notes; ++i)      /* no notes are playing now */
         m_playing_notes[i] = 0;
+
+    m_events_undo.limit(rc().undo_memory_kb());
+    m_events_redo.limit(rc().undo_memory_kb());
 }
 
 /**
@@ -189,6 +199,7 @@ sequence::partial_assign (const sequence & rhs)
     if (this != &rhs)
     {
         automutex locker(m_mutex);
+        m_events.hold_links();                      /* linked once, below   */
         m_parent        = rhs.m_parent;             /* a pointer, careful!  */
         m_events        = rhs.m_events;
         m_triggers      = rhs.m_triggers;
@@ -209,6 +220,7 @@ sequence::partial_assign (const sequence & rhs)
 
         zero_markers();                             /* reset to tick 0      */
         verify_and_link();
+        m_events.release_links();
     }
 }
 
@@ -225,10 +237,7 @@ sequence::set_hold_undo (bool hold)
 {
     automutex locker(m_mutex);
     if (hold)
-    {
-        for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
-            m_events_undo_hold.add(DREF(i));
-    }
+        m_events_undo_hold = m_events;      /* already sorted, no add()     */
     else
        m_events_undo_hold.clear();
 }
@@ -293,9 +302,11 @@ sequence::pop_undo ()
     if (! m_events_undo.empty())                // stazed: m_list_undo
     {
         m_events_redo.push(m_events);           // move to triggers module?
+        m_events.hold_links();                  // link only once
         m_events = m_events_undo.top();
         m_events_undo.pop();
         verify_and_link();
+        m_events.release_links();
         unselect();
     }
     set_have_undo();                            // stazed
@@ -318,9 +329,11 @@ sequence::pop_redo ()
     if (! m_events_redo.empty())                // move to triggers module?
     {
         m_events_undo.push(m_events);
+        m_events.hold_links();                  // link only once
         m_events = m_events_redo.top();
         m_events_redo.pop();
         verify_and_link();
+        m_events.release_links();
         unselect();
     }
     set_have_undo();                            // stazed
@@ -476,6 +489,7 @@ sequence::select_even_or_odd_notes (int note_len, bool even)
 {
     int result = 0;
     automutex locker(m_mutex);
+    invalidate_snapshot();
     unselect();
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -559,6 +573,7 @@ sequence::select_note_events
 {
     int result = 0;
     automutex locker(m_mutex);
+    invalidate_snapshot();
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -647,7 +662,7 @@ sequence::select_note_events
                     {
                         remove(i);
                         remove(e);
-                        reset_draw_marker();
+                        invalidate_snapshot();
                         ++result;
                         break;
                     }
@@ -708,7 +723,7 @@ sequence::select_note_events
                     if (action == e_remove_one)
                     {
                         remove(i);
-                        reset_draw_marker();
+                        invalidate_snapshot();
                         ++result;
                         break;
                     }
@@ -748,6 +763,8 @@ sequence::select_event_handle
     midibyte status, midibyte cc, int dats
 )
 {
+    automutex locker(m_mutex);
+    invalidate_snapshot();
     int result = 0;
     bool have_selection = false;
     if (status == EVENT_NOTE_ON)                    // use a function!
@@ -1021,6 +1038,12 @@ sequence::on_queued ()
  *  function.  It's return value and side-effects tell if there's a change in
  *  playing based on triggers and tells the ticks that bracket it.
  *
+ *  Rather than scanning the event list from the beginning for every frame,
+ *  play() keeps a play cursor (m_iterator_play and m_play_offset_base) that
+ *  is left at the first event not yet due.  The cursor is repositioned by
+ *  seek_play_cursor() only if the event list changed or the frame does not
+ *  start where the previous one ended.
+ *
  * \param end_tick
  *      Provides the current end-tick value.  The tick comes in as a global
  *      tick.
@@ -1050,55 +1073,65 @@ sequence::play (midipulse end_tick, bool playback_mode)
         if (playback_mode)                  /* song mode: on/off triggers   */
             trigger_turning_off = m_triggers.play(start_tick, end_tick);
     }
-    if (m_playing)                          /* play notes in frame  */
+    if (m_playing && m_length > 0 && ! m_events.empty())
     {
         midipulse offset = m_length - m_trigger_offset;
         midipulse start_tick_offset = start_tick + offset;
         midipulse end_tick_offset = end_tick + offset;
-        midipulse times_played = m_last_tick / m_length;
-        midipulse offset_base = times_played * m_length;
 #ifdef SEQ64_STAZED_TRANSPOSE
         int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
 #endif
-        event_list::iterator e = m_events.begin();
-        while (e != m_events.end())
+        bool stale =
+            m_play_revision != m_events.revision() ||
+            m_play_next_tick != start_tick_offset;
+
+        if (stale)
+            seek_play_cursor(start_tick_offset);
+
+        event_list::iterator & e = m_iterator_play;
+        for (;;)
         {
             event & er = DREF(e);
-            midipulse stamp = er.get_timestamp() + offset_base;
-            if (stamp >= start_tick_offset && stamp <= end_tick_offset)
-            {
+            midipulse stamp = er.get_timestamp() + m_play_offset_base;
+            if (stamp > end_tick_offset)
+                break;                              /* frame is done        */
+
+            midipulse late = end_tick_offset - stamp;   /* for scheduling   */
+
 #ifdef SEQ64_STAZED_TRANSPOSE
-                if (transpose != 0 && er.is_note()) /* includes Aftertouch  */
+            if (transpose != 0 && er.is_note())     /* includes Aftertouch  */
+            {
+                event transposed_event = er;        /* assign ALL members   */
+                transposed_event.transpose_note(transpose);
+                post_event_on_bus(transposed_event, late);
+            }
+            else
+            {
+#endif
+                if (er.is_tempo())
                 {
-                    event transposed_event = er;    /* assign ALL members   */
-                    transposed_event.transpose_note(transpose);
-                    put_event_on_bus(transposed_event);
+                    if (m_defer_output)
+                        defer(DEFERRED_TEMPO, er, 0);
+                    else if (not_nullptr(m_parent))
+                        m_parent->set_beats_per_minute(er.tempo());
                 }
-                else
-                {
-#endif
-                    if (er.is_tempo())
-                    {
-                        if (not_nullptr(m_parent))
-                            m_parent->set_beats_per_minute(er.tempo());
-                    }
-                    else if (! er.is_ex_data())
-                        put_event_on_bus(er);       /* frame still going    */
+                else if (! er.is_ex_data())
+                    post_event_on_bus(er, late);    /* frame still going    */
 #ifdef SEQ64_STAZED_TRANSPOSE
-                }
-#endif
             }
-            else if (stamp > end_tick_offset)
-                break;                              /* frame is done        */
-
+#endif
             ++e;                                    /* go to next event     */
             if (e == m_events.end())                /* did we hit the end ? */
             {
                 e = m_events.begin();               /* yes, start over      */
-                offset_base += m_length;            /* for another go at it */
+                m_play_offset_base += m_length;     /* for another go at it */
             }
         }
+        m_play_next_tick = end_tick_offset + 1;
     }
+    else
+        reset_play_cursor();
+
     if (trigger_turning_off)                        /* triggers: "turn off" */
         set_playing(false);
 
@@ -1106,6 +1139,43 @@ sequence::play (midipulse end_tick, bool playback_mode)
     m_was_playing = m_playing;
 }
 
+/**
+ *  Positions the play cursor at the first event, taking the repetitions of
+ *  the pattern into account, that falls at or after the given tick.  As in
+ *  the original seq24 scan, the repetitions are counted from the start of
+ *  the pattern loop containing m_last_tick.  This is the only place where
+ *  play() has to walk the event list from its beginning; it is done only when
+ *  the event list has been modified, or the playback position has jumped.
+ *  Afterwards, each frame costs only the events that are actually due in
+ *  that frame.
+ *
+ * \threadunsafe
+ *      The caller, play(), holds the mutex.
+ *
+ * \param tick
+ *      Provides the tick, in the same offset global ticks used by play(), at
+ *      which the next frame starts.  The caller guarantees that m_length is
+ *      greater than zero and that the event list is not empty.
+ */
+
+void
+sequence::seek_play_cursor (midipulse tick)
+{
+    m_play_offset_base = (m_last_tick / m_length) * m_length;
+    m_iterator_play = m_events.begin();
+    while (DREF(m_iterator_play).get_timestamp() + m_play_offset_base < tick)
+    {
+        ++m_iterator_play;
+        if (m_iterator_play == m_events.end())
+        {
+            m_iterator_play = m_events.begin();
+            m_play_offset_base += m_length;
+        }
+    }
+    m_play_revision = m_events.revision();
+    m_play_next_tick = tick;
+}
+
 /**
  *  This function verifies state: all note-ons have a note-off, and it links
  *  note-offs with their note-ons.
@@ -1118,6 +1188,7 @@ sequence::verify_and_link ()
 {
     automutex locker(m_mutex);
     m_events.verify_and_link(m_length);
+    set_dirty();                        /* new generation for the viewers   */
 }
 
 /**
@@ -1223,7 +1294,7 @@ sequence::remove_marked ()
 #endif
 
     bool result = m_events.remove_marked();
-    reset_draw_marker();
+    invalidate_snapshot();
     return result;
 }
 
@@ -1241,7 +1312,7 @@ sequence::mark_selected ()
 {
     automutex locker(m_mutex);
     bool result = m_events.mark_selected();
-    reset_draw_marker();
+    invalidate_snapshot();
     return result;
 }
 
@@ -1262,7 +1333,7 @@ sequence::remove_selected ()
     {
         m_events_undo.push(m_events);           /* push_undo() without lock */
         (void) m_events.remove_marked();
-        reset_draw_marker();
+        invalidate_snapshot();
     }
 }
 
@@ -1469,6 +1540,7 @@ sequence::select_note_events
 {
     int result = 0;
     automutex locker(m_mutex);
+    invalidate_snapshot();
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -1537,9 +1609,15 @@ sequence::select_note_events
                     }
                     if (action == e_remove_one)
                     {
-                        remove(er);
+                        /*
+                         * The linked event always comes after er in the
+                         * container, so remove it first; with the event
+                         * vector, removing er would shift it.
+                         */
+
                         remove(*ev);
-                        reset_draw_marker();
+                        remove(er);
+                        invalidate_snapshot();
                         ++result;
                         break;
                     }
@@ -1586,7 +1664,7 @@ sequence::select_note_events
                     if (action == e_remove_one)
                     {
                         remove(er);
-                        reset_draw_marker();
+                        invalidate_snapshot();
                         ++result;
                         break;
                     }
@@ -1675,6 +1753,7 @@ sequence::select_events
 {
     int result = 0;
     automutex locker(m_mutex);
+    invalidate_snapshot();
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -1717,7 +1796,7 @@ sequence::select_events
                 if (action == e_remove_one)
                 {
                     remove(er);
-                    reset_draw_marker();
+                    invalidate_snapshot();
                     ++result;
                     break;
                 }
@@ -1737,6 +1816,7 @@ void
 sequence::select_all ()
 {
     automutex locker(m_mutex);
+    invalidate_snapshot();
     m_events.select_all();
 }
 
@@ -1750,6 +1830,7 @@ void
 sequence::unselect ()
 {
     automutex locker(m_mutex);
+    invalidate_snapshot();
     m_events.unselect_all();
 }
 
@@ -1802,15 +1883,13 @@ sequence::move_selected_notes (midipulse delta_tick, int delta_note)
 {
     if (mark_selected())                            /* locked recursively   */
     {
-        automutex locker(m_mutex);
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        sequence_edit edit(*this);                  /* locks, pushes undo   */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
             if (er.is_marked())                     /* is it being moved ?  */
             {
                 event e = er;                       /* copy event           */
-                e.unmark();                         /* unmark the new event */
                 int newnote = e.get_note() + delta_note;
                 if (newnote >= 0 && newnote < c_num_keys)
                 {
@@ -1821,13 +1900,13 @@ sequence::move_selected_notes (midipulse delta_tick, int delta_note)
 
                     e.set_timestamp(newts);
                     e.select();                     /* keep it selected     */
-                    add_event(e);
-                    modify();
+                    edit.add(e);                    /* added after the scan */
+                    edit.remove(er);
                 }
+                else
+                    er.unmark();                    /* leave it in place    */
             }
         }
-        if (remove_marked())
-            verify_and_link();
     }
 }
 
@@ -1958,7 +2037,6 @@ sequence::stretch_selected (midipulse delta_tick)
         automutex locker(m_mutex);
         unsigned first_ev = 0x7fffffff;             /* timestamp lower limit */
         unsigned last_ev = 0x00000000;              /* timestamp upper limit */
-        m_events_undo.push(m_events);               /* push_undo(), no lock  */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
@@ -1977,6 +2055,7 @@ sequence::stretch_selected (midipulse delta_tick)
         if (new_len > 1)
         {
             float ratio = float(new_len) / float(old_len);
+            sequence_edit edit(*this);              /* pushes the undo      */
             mark_selected();                        /* locked recursively   */
             for
             (
@@ -1990,12 +2069,10 @@ sequence::stretch_selected (midipulse delta_tick)
                     event n = er;                   /* copy the event       */
                     midipulse t = er.get_timestamp();
                     n.set_timestamp(midipulse(ratio * (t - first_ev)) + first_ev);
-                    n.unmark();
-                    add_event(n);
+                    edit.add(n);                    /* added after the scan */
+                    edit.remove(er);
                 }
             }
-            if (remove_marked())
-                verify_and_link();
         }
     }
 }
@@ -2046,8 +2123,7 @@ sequence::grow_selected (midipulse delta)
 {
     if (mark_selected())                            /* locked recursively   */
     {
-        automutex locker(m_mutex);                  /* lock it again, dude  */
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        sequence_edit edit(*this);                  /* lock it again, dude  */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
@@ -2066,13 +2142,13 @@ sequence::grow_selected (midipulse delta)
 
                     midipulse newtime = trim_timestamp(offtime + delta);
 
-                    off->mark();                    /* kill old off event   */
+                    edit.remove(*off);              /* kill old off event   */
                     er.unmark();                    /* keep old on event    */
-                    e.unmark();                     /* keep new off event   */
                     e.set_timestamp(newtime);       /* new off-time         */
-                    add_event(e);                   /* add fixed off event  */
-                    modify();
+                    edit.add(e);                    /* add fixed off event  */
                 }
+                else if (er.is_marked())
+                    edit.remove(er);                /* dropped, as before   */
             }
             else if (er.is_marked())                /* non-Note event?      */
             {
@@ -2081,15 +2157,13 @@ sequence::grow_selected (midipulse delta)
                 midipulse ontime = er.get_timestamp();
                 midipulse newtime = clip_timestamp(ontime, ontime + delta);
                 e.set_timestamp(newtime);           /* adjust time-stamp    */
-                add_event(e);                       /* add adjusted event   */
-                modify();
+                edit.add(e);                        /* add adjusted event   */
+                edit.remove(er);                    /* drop the original    */
 #else
                 er.unmark();                        /* unmark old version   */
 #endif
             }
         }
-        if (remove_marked())
-            verify_and_link();
     }
 }
 
@@ -2105,8 +2179,7 @@ sequence::randomize_selected
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo(), no lock  */
+    sequence_edit edit(*this);                  /* locks, pushes undo   */
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -2139,6 +2212,7 @@ sequence::randomize_selected
 
             data[datidx] = datitem;
             e.set_data(data[0], data[1]);
+            edit.modified();
         }
     }
 }
@@ -2150,6 +2224,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
     midibyte datitem;
     int datidx = 0;
     automutex locker(m_mutex);
+    invalidate_snapshot();
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -2206,6 +2281,7 @@ void
 sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 {
     automutex locker(m_mutex);
+    invalidate_snapshot();
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -2249,6 +2325,7 @@ void
 sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 {
     automutex locker(m_mutex);
+    invalidate_snapshot();
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -2299,10 +2376,11 @@ sequence::copy_selected ()
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         if (DREF(i).is_selected())
-            clipbd.add(DREF(i));
+            (void) clipbd.append(DREF(i));  /* sorted once, below       */
     }
     if (! clipbd.empty())
     {
+        clipbd.sort();
         midipulse first_tick = DREF(clipbd.begin()).get_timestamp();
         if (first_tick >= 0)
         {
@@ -2415,9 +2493,8 @@ sequence::paste_selected (midipulse tick, int note)
 {
     if (! m_events_clipboard.empty())
     {
-        automutex locker(m_mutex);
+        sequence_edit edit(*this);                  /* locks, pushes undo   */
         event_list clipbd = m_events_clipboard;     /* copy the clipboard   */
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
         {
             event & e = DREF(i);
@@ -2446,31 +2523,8 @@ sequence::paste_selected (midipulse tick, int note)
                 midibyte n = e.get_note();
                 e.set_note(n + note_delta);
             }
+            edit.add(e);                            /* sorted at commit     */
         }
-
-#ifdef SEQ64_USE_EVENT_MAP
-
-        /*
-         * \change 0rel 2016-06-12 fix, see the banner notes.
-         */
-
-        event_list clipbd_updated;
-        for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
-            clipbd_updated.add(DREF(i));
-
-        clipbd = clipbd_updated;
-        m_events.merge(clipbd);
-
-#else
-
-        m_events.merge(clipbd, false);          /* don't presort clipboard  */
-        m_events.sort();                        /* does nothing in map      */
-
-#endif      // SEQ64_USE_EVENT_MAP
-
-        verify_and_link();
-        reset_draw_marker();
-        modify();
     }
 }
 
@@ -2530,6 +2584,7 @@ sequence::change_event_data_range
 )
 {
     automutex locker(m_mutex);
+    invalidate_snapshot();
     bool result = false;
     bool have_selection = get_num_selected_events(status, cc) > 0;
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
@@ -2649,7 +2704,7 @@ sequence::change_event_data_lfo
     wave_type_t wave, midibyte status, midibyte cc
 )
 {
-    automutex locker(m_mutex);
+    sequence_edit edit(*this, false);       /* the "hold" does the undo     */
     double dlength = double(m_length);
     double dbw = double(m_time_beat_width);
     bool have_selection = false;            /* change only selected if true */
@@ -2695,6 +2750,7 @@ sequence::change_event_data_lfo
                 d0 = newdata;
 
             e.set_data(d0, d1);
+            edit.modified();
         }
     }
 }
@@ -2769,6 +2825,8 @@ sequence::add_note
     if (tick >= 0 && note >= 0 && note < c_num_keys)
     {
         automutex locker(m_mutex);
+        invalidate_snapshot();
+        m_events.hold_links();                  /* link once, at the end    */
         bool hardwire = velocity == SEQ64_PRESERVE_VELOCITY;
         bool ignore = false;
         if (paint)                        /* see the banner above */
@@ -2819,6 +2877,8 @@ sequence::add_note
         }
         if (result)
             verify_and_link();
+
+        m_events.release_links();
     }
     return result;
 }
@@ -2922,7 +2982,7 @@ sequence::add_event (const event & er)
     bool result = m_events.add(er);     /* post/auto-sorts by time & rank   */
     if (result)
     {
-        reset_draw_marker();
+        invalidate_snapshot();
         set_dirty();
     }
     else
@@ -2987,6 +3047,7 @@ sequence::add_event
 {
     automutex locker(m_mutex);
     bool result = false;
+    m_events.hold_links();                      /* link once, at the end    */
     if (tick >= 0)
     {
         if (paint)
@@ -3018,6 +3079,7 @@ sequence::add_event
     if (result)
         verify_and_link();
 
+    m_events.release_links();
     return result;
 }
 
@@ -3068,6 +3130,7 @@ sequence::stream_event (event & ev)
     bool result = channel_match(ev);            /* set if channel matches   */
     if (result)
     {
+        bool linked = false;                    /* added by add_linked()?   */
 #ifdef SEQ64_STAZED_EXPAND_RECORD
         /*
          * If in overwrite record more, any events after reset should clear
@@ -3089,7 +3152,8 @@ sequence::stream_event (event & ev)
                 if (ev.is_note_on() && m_rec_vol > SEQ64_PRESERVE_VELOCITY)
                     ev.set_note_velocity(m_rec_vol);    /* modify incoming  */
 
-                add_event(ev);                          /* more locking     */
+                linked = m_events.add_linked(ev);       /* sort + link it   */
+                invalidate_snapshot();
                 set_dirty();
             }
             else
@@ -3131,7 +3195,9 @@ sequence::stream_event (event & ev)
         if (m_thru)
             put_event_on_bus(ev);                       /* more locking     */
 
-        link_new();                                     /* more locking     */
+        if (! linked)
+            link_new();                                 /* more locking     */
+
         if (m_quantized_rec && m_parent->is_pattern_playing())
         {
             if (ev.is_note_off())
@@ -3151,21 +3217,21 @@ sequence::stream_event (event & ev)
  *  meant for causing user-interface refreshes, not for performance
  *  modification.
  *
- *  m_dirty_names is set to false in is_dirty_names(); m_dirty_names is set to
- *  false in is_dirty_main(); m_dirty_names is set to false in
- *  is_dirty_perf().
+ *  The names, main, and performance bits are cleared by
+ *  perform::is_dirty_names(), perform::is_dirty_main(), and
+ *  perform::is_dirty_perf(), respectively.
  *
- * \threadunsafe
+ * \threadsafe
  */
 
 void
 sequence::set_dirty_mp ()
 {
-    m_dirty_names = m_dirty_main = m_dirty_perf = true;
+    mark_dirty(SEQ64_DIRTY_MAIN | SEQ64_DIRTY_PERF | SEQ64_DIRTY_NAMES);
 }
 
 /**
- *  Call set_dirty_mp() and then sets the dirty flag for editing.
+ *  Sets the dirty flags of set_dirty_mp(), and the dirty flag for editing.
  *
  * \threadsafe
  */
@@ -3173,72 +3239,36 @@ sequence::set_dirty_mp ()
 void
 sequence::set_dirty ()
 {
-    set_dirty_mp();
-    m_dirty_edit = true;
+    mark_dirty(SEQ64_DIRTY_ALL);
 }
 
 /**
- *  Returns the value of the dirty names (heh heh) flag, and sets that
- *  flag to false.  Not sure that we need to lock a boolean on modern
- *  processors.
+ *  Sets the edit flag, bumps the change generation, and tells the parent
+ *  perform object which sequence changed, so that the user interface can
+ *  redraw only the sequences that changed.  Lock-free, so that the output
+ *  thread never waits on a viewer, and vice versa.
  *
  * \threadsafe
  *
- * \return
- *      Returns the dirty status.
- */
-
-bool
-sequence::is_dirty_names ()
-{
-    automutex locker(m_mutex);
-    bool result = m_dirty_names;
-    m_dirty_names = false;
-    return result;
-}
-
-/**
- *  Returns the value of the dirty main flag, and sets that flag to false
- *  (i.e. resets it).  This flag signals that a redraw is needed from
- *  recording.
- *
- * \threadsafe
- *
- * \return
- *      Returns the dirty status.
+ * \param kinds
+ *      The SEQ64_DIRTY_* bits to set.
  */
 
-bool
-sequence::is_dirty_main ()
+void
+sequence::mark_dirty (unsigned kinds)
 {
-    automutex locker(m_mutex);
-    bool result = m_dirty_main;
-    m_dirty_main = false;
-    return result;
-}
-
-/**
- *  Returns the value of the dirty performance flag, and sets that
- *  flag to false.
- *
- * \threadsafe
- *
- * \return
- *      Returns the dirty status.
- */
+    if ((kinds & SEQ64_DIRTY_EDIT) != 0)
+        m_dirty_edit.store(true, std::memory_order_release);
 
-bool
-sequence::is_dirty_perf ()
-{
-    automutex locker(m_mutex);
-    bool result = m_dirty_perf;
-    m_dirty_perf = false;
-    return result;
+    m_generation.fetch_add(1, std::memory_order_release);
+    if (not_nullptr(m_parent) && m_seq_number >= 0)
+        m_parent->mark_dirty(m_seq_number, kinds);
 }
 
 /**
  *  Returns the value of the dirty edit flag, and sets that flag to false.
- *  The m_dirty_edit flag is set by the function set_dirty().
+ *  The edit flag is set by the function set_dirty().  The flag is atomic,
+ *  so no lock is needed.
  *
  * \threadsafe
  *
@@ -3249,10 +3279,7 @@ sequence::is_dirty_perf ()
 bool
 sequence::is_dirty_edit ()
 {
-    automutex locker(m_mutex);
-    bool result = m_dirty_edit;
-    m_dirty_edit = false;
-    return result;
+    return m_dirty_edit.exchange(false);
 }
 
 /**
@@ -3910,41 +3937,6 @@ sequence::pause (bool song_mode)
         set_playing(state);
 }
 
-/**
- *  This refreshes the draw marker to the first event. It resets the draw marker
- *  so that calls to get_next_note_event() will start from the first event.
- *
- * \warning
- *      This iterator is shared by about four GUI object, and they might
- *      interfere with each other!
- *
- * \threadsafe
- */
-
-void
-sequence::reset_draw_marker ()
-{
-    automutex locker(m_mutex);
-    m_iterator_draw = m_events.begin();
-}
-
-/**
- *  This increments the draw marker.
- *
- * \warning
- *      This iterator is shared by about four GUI object, and they might
- *      interfere with each other!
- *
- * \threadsafe
- */
-
-void
-sequence::inc_draw_marker ()
-{
-    automutex locker(m_mutex);
-    ++m_iterator_draw;
-}
-
 /**
  *  Sets the draw-trigger iterator to the beginning of the trigger list.
  *
@@ -3960,11 +3952,8 @@ sequence::reset_draw_trigger_marker ()
 
 /**
  *  A new function provided so that we can find the minimum and maximum notes
- *  with only one (not two) traversal of the event list.
- *
- * \todo
- *      For efficency, we should calculate this only when the event set
- *      changes, and save the results and return them if good.
+ *  without traversing the event list.  The range now comes from the cached
+ *  note summary, so it is calculated only when the event set changes.
  *
  * \threadsafe
  *
@@ -3975,7 +3964,7 @@ sequence::reset_draw_trigger_marker ()
  *
  * \param highest
  *      A reference parameter to return the note with the highest value.
- *      if there are no notes, then it is set to 0, and false is returned.
+ *      if there are no notes, then it is set to -1, and false is returned.
  *
  * \return
  *      If there are no notes or tempo events in the list, then false is
@@ -3986,264 +3975,229 @@ sequence::reset_draw_trigger_marker ()
 bool
 sequence::get_minmax_note_events (int & lowest, int & highest)
 {
-    automutex locker(m_mutex);
-    bool result = false;
-    int low = SEQ64_MAX_DATA_VALUE;
-    int high = -1;
-    for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
-    {
-        event & er = DREF(i);
-        if (er.is_note_on() || er.is_note_off())
-        {
-            if (er.get_note() < low)
-            {
-                low = er.get_note();
-                result = true;
-            }
-            else if (er.get_note() > high)
-            {
-                high = er.get_note();
-                result = true;
-            }
-        }
-        else if (er.is_tempo())
-        {
-            midibyte notebyte = tempo_to_note_value(er.tempo());
-            if (notebyte < low)
-                low = notebyte;
-            else if (notebyte > high)
-                high = notebyte;
-
-            result = true;
-        }
-    }
-    lowest = low;
-    highest = high;
-    return result;
+    note_summary_ptr ns = get_note_summary();
+    lowest = ns->ns_low_note;
+    highest = ns->ns_high_note;
+    return ns->ns_have_notes;
 }
 
 /**
- *  Each call to seqdata() fills the passed references with a events
- *  elements, and returns true.  When it has no more events, returns a
- *  false.
- *
- *  Note that, before the first call to draw a sequence, the
- *  reset_draw_marker() function must be called, to reset m_iterator_draw.
- *
- * \param [out] tick_s
- *      Provides a pointer destination for the start time.
+ *  Gets a read-only snapshot of the events, for drawing.  The views iterate
+ *  over the snapshot without holding any lock, so they never block play()
+ *  and are never disturbed by recording or editing.  The same snapshot is
+ *  handed out until the change generation, the event-list revision, the
+ *  in-place change count, or the length changes; only then are the events
+ *  copied again, while the lock is held.
  *
- * \param [out] tick_f
- *      Provides a pointer destination for the finish time.
- *
- * \param [out] note
- *      Provides a pointer destination for the note pitch value
- *      Probably should be a midibyte value.  If the event is the special case
- *      of a tempo event, then this value is the tempo value scaled to 0 to
- *      127 for display purposes.
- *
- * \param [out] selected
- *      Provides a pointer destination for the selection status of the note.
- *
- * \param [out] velocity
- *      Provides a pointer destination for the note velocity.
- *      Probably should be a midibyte value.
+ * \threadsafe
  *
  * \return
- *      Returns a draw_type_t value:  DRAW_NORMAL_LINKED, DRAW_NOTE_ON,
- *      DRAW_NOTE_OFF, or DRAW_FIN.  Note that the new value DRAW_TEMPO could
- *      be returned, as well.
+ *      Returns a pointer to the snapshot.  It is never null, and the
+ *      snapshot it points to is never changed.
  */
 
-draw_type_t
-sequence::get_next_note_event
-(
-    midipulse & tick_s, midipulse & tick_f,
-    int & note, bool & selected, int & velocity
-)
+event_snapshot_ptr
+sequence::get_event_snapshot ()
 {
-    // automutex locker(m_mutex);               // WILL IT HELP???? No.
-    tick_f = 0;
-    while (m_iterator_draw != m_events.end())   /* NOT THREADSAFE!!!!!      */
+    automutex locker(m_mutex);
+    unsigned long gen = generation();
+    if
+    (
+        ! m_event_snapshot ||
+        ! m_event_snapshot->matches
+        (
+            gen, m_events.revision(), m_snapshot_serial, m_length
+        )
+    )
     {
-        event & drawevent = DREF(m_iterator_draw);
-        bool isnoteon = drawevent.is_note_on();
-        bool islinked = drawevent.is_linked();  /* not get_linked(), idiot! */
-        tick_s   = drawevent.get_timestamp();
-        note     = drawevent.get_note();
-        selected = drawevent.is_selected();
-        velocity = drawevent.get_note_velocity();
-        inc_draw_marker();                      /* go until null or Note-On */
-        if (isnoteon && islinked)
-        {
-            tick_f = drawevent.get_linked()->get_timestamp();
-            return DRAW_NORMAL_LINKED;
-        }
-        else if (isnoteon && ! islinked)
-        {
-            return DRAW_NOTE_ON;
-        }
-        else if (drawevent.is_note_off() && ! islinked)
-        {
-            return DRAW_NOTE_OFF;
-        }
-        else if (drawevent.is_tempo())
-        {
-            midibpm bpm = drawevent.tempo();
-            midibyte notebyte = tempo_to_note_value(bpm);
-            note = int(notebyte);
-            if (islinked)
-                tick_f = drawevent.get_linked()->get_timestamp();
-            else
-                tick_f = get_length();
-
-            /*
-             * Tempo needs to be attained.  This is good only for drawing a
-             * horizontal tempo line; we need a way to return both a starting
-             * tempo and ending tempo.  Return the latter in velocity?
-             */
-
-            return DRAW_TEMPO;
-        }
+        m_event_snapshot = std::make_shared<event_snapshot>
+        (
+            m_events, m_length, gen, m_snapshot_serial
+        );
     }
-    return DRAW_FIN;
+    return m_event_snapshot;
 }
 
 /**
- *  Get the next event in the event list.  Then set the status and control
- *  character parameters using that event.  This overload is used only in
- *  seqedit::popup_event_menu().
- *
- * \param status
- *      Provides a pointer to the MIDI status byte to be set, as a way to
- *      retrieve the event.
+ *  Copies into this sequence, which must not be part of a performance, what
+ *  midi_container::fill() saves from another sequence, except its events:
+ *  the settings, the name, the length, and the triggers.  The events are
+ *  returned as a snapshot instead, taken while the same lock is held, so
+ *  that the copy is consistent.  This is cheap enough to do for all of the
+ *  sequences of a song while it plays; the events can be loaded later, on
+ *  another thread, by load_event_snapshot().
  *
- * \param cc
- *      The return pointer for the control value.
+ * \param rhs
+ *      The sequence to copy.
  *
  * \return
- *      Returns true if the data is useable, and false if there are no more
- *      events.
+ *      Returns the snapshot of the events of \a rhs.
  */
 
-bool
-sequence::get_next_event (midibyte & status, midibyte & cc)
+event_snapshot_ptr
+sequence::copy_for_save (sequence & rhs)
 {
-    // automutex locker(m_mutex);                   // WILL IT HELP?? No.
-    while (m_iterator_draw != m_events.end())       /* NOT THREADSAFE!!!    */
-    {
-        midibyte j;
-        event & drawevent = DREF(m_iterator_draw);
-        status = drawevent.get_status();
-        drawevent.get_data(cc, j);
-        inc_draw_marker();
-        return true;                /* we have a good one; update and return */
-    }
-    return false;
+    automutex rhslocker(rhs.m_mutex);
+    automutex locker(m_mutex);
+    m_triggers.triggerlist() = rhs.m_triggers.triggerlist(); /* no undo  */
+    m_midi_channel          = rhs.m_midi_channel;
+#ifdef SEQ64_STAZED_TRANSPOSE
+    m_transposable          = rhs.m_transposable;
+#endif
+    m_bus                   = rhs.m_bus;
+    m_name                  = rhs.m_name;
+    m_ppqn                  = rhs.m_ppqn;
+    m_length                = rhs.m_length;
+    m_time_beats_per_measure = rhs.m_time_beats_per_measure;
+    m_time_beat_width       = rhs.m_time_beat_width;
+    m_musical_key           = rhs.m_musical_key;
+    m_musical_scale         = rhs.m_musical_scale;
+    m_background_sequence   = rhs.m_background_sequence;
+    return rhs.get_event_snapshot();
 }
 
 /**
- *  Reset the caller's iterator.
+ *  Replaces the events of this sequence with those of a snapshot.  Used to
+ *  complete the copy made by copy_for_save().
+ *
+ * \param es
+ *      The snapshot holding the events.
  */
 
 void
-sequence::reset_ex_iterator (event_list::const_iterator & evi)
+sequence::load_event_snapshot (const event_snapshot & es)
 {
-    evi = m_events.begin();
+    automutex locker(m_mutex);
+    m_events.clear();
+    m_events.reserve(es.count());
+    for (int i = 0; i < es.count(); ++i)
+        m_events.append(es.get_event(i));
+
+    m_events.sort();
+    set_dirty();
 }
 
 /**
- *  New version in progress.  This version makes the caller responsible for
- *  providing and maintaining the iterator, so that there are no conflicting
- *  operations on m_draw_iterator from seqdata, seqevent, seqroll, and
- *  perfroll.
- *
- *  This rational version of get_next_event() returns the whole event, rather
- *  than filling in a bunch of parameters.  In addition, it always allows
- *  Tempo events to be found.  Gets the next event in the event list that
- *  matches the given status and control character.  Then set the rest of the
- *  parameters parameters using that event.  If the status is the new value
- *  EVENT_ANY, then any event will be obtained.
- *
- *  Note the usage of event::is_desired_cc_or_not_cc(status, cc, *d0); Either
- *  we have a control change with the right CC or it's a different type of
- *  event.
- *
- * \param status
- *      The type of event to be obtained.  The special value EVENT_ANY can be
- *      provided so that no event statuses are filtered.
+ *  Gets the note summary of the sequence, which holds what the pattern slots
+ *  and the song editor draw:  the note range, and the note and tempo lines
+ *  that event_snapshot::next_note_event() would return.  The summary is
+ *  rebuilt only when the event-list revision, the in-place change count
+ *  (see invalidate_snapshot()), or the length has changed since the last
+ *  call, so drawing many repetitions of a sequence no longer scans its
+ *  events each time.  The change generation is not used, since muting or
+ *  queuing the sequence bumps it too.
  *
- * \param cc
- *      The continuous controller value that might be desired.
- *
- * \param [out] ev
- *      An iterator return value for the next event found.  The caller might
- *      want to check if it is a Tempo event.  Do not use this iterator if
- *      false is returned!
+ *  To bound the drawing work for dense sequences, lines of the same kind
+ *  and pitch that are less than 1/SEQ64_SUMMARY_COLUMNS of the length apart
+ *  are merged into one line, which keeps the loudest velocity.  Notes that
+ *  wrap around the end of the pattern, and tempo lines, are never merged.
  *
- * \param evtype
- *      A stazed parameter for picking either all event or unselected events.
- *      Defaults to EVENTS_ALL.  Not used unless the macro
- *      USE_STAZED_SELECTION_EXTENSIONS is defined.
+ * \threadsafe
  *
  * \return
- *      Returns true if the current event was one of the desired ones, or was
- *      a Tempo event.  In this case, the caller <i> must </i> increment the
- *      iterator.
+ *      Returns a pointer to the summary.  It is never null, and the summary
+ *      it points to is never changed.
  */
 
-bool
-sequence::get_next_event_ex
-(
-    midibyte status, midibyte cc,
-    event_list::const_iterator & evi,
-    int evtype
-)
+note_summary_ptr
+sequence::get_note_summary ()
 {
-    while (evi != m_events.end())
+    automutex locker(m_mutex);
+    unsigned rev = m_events.revision();
+    if
+    (
+        ! m_note_summary || m_note_summary->ns_serial != m_snapshot_serial ||
+        m_note_summary->ns_revision != rev ||
+        m_note_summary->ns_length != m_length
+    )
     {
-        const event & drawevent = DREF(evi);
-        bool istempo = drawevent.is_tempo();
-        bool ok = drawevent.get_status() == status || istempo;
-        if (! ok)
-            ok = status == EVENT_ANY;
-
-#ifdef USE_STAZED_SELECTION_EXTENSIONS          // LATER
-        if (ok)
+        std::shared_ptr<note_summary> ns = std::make_shared<note_summary>();
+        ns->ns_serial = m_snapshot_serial;
+        ns->ns_revision = rev;
+        ns->ns_length = m_length;
+        ns->ns_have_notes = false;
+        ns->ns_low_note = SEQ64_MAX_DATA_VALUE;
+        ns->ns_high_note = -1;
+
+        midipulse resolution = m_length / SEQ64_SUMMARY_COLUMNS;
+        int lastline[SEQ64_MIDI_COUNT_MAX];         /* last line per pitch  */
+        for (int n = 0; n < SEQ64_MIDI_COUNT_MAX; ++n)
+            lastline[n] = -1;
+
+        event_list::iterator i;
+        for (i = m_events.begin(); i != m_events.end(); ++i)
         {
-            if (evtype == EVENTS_UNSELECTED && drawevent.is_selected())
+            event & er = DREF(i);
+            bool islinked = er.is_linked();
+            note_summary_item item;
+            item.nsi_tick_start = er.get_timestamp();
+            item.nsi_tick_finish = item.nsi_tick_start;
+            item.nsi_note = er.get_note();
+            item.nsi_velocity = er.get_note_velocity();
+            if (er.is_tempo())
             {
-                ++evi;
-                continue;           /* keep trying to find one              */
+                item.nsi_type = DRAW_TEMPO;
+                item.nsi_note = int(tempo_to_note_value(er.tempo()));
+                item.nsi_tick_finish = islinked ?
+                    er.get_linked()->get_timestamp() : m_length ;
             }
-            if (evtype > EVENTS_UNSELECTED && ! drawevent.is_selected())
+            else if (er.is_note_on())
             {
-                ++evi;
-                continue;           /* keep trying to find one              */
+                item.nsi_type = islinked ? DRAW_NORMAL_LINKED : DRAW_NOTE_ON ;
+                if (islinked)
+                    item.nsi_tick_finish = er.get_linked()->get_timestamp();
             }
-        }
-#endif  // USE_STAZED_SELECTION_EXTENSIONS
+            else if (er.is_note_off())
+            {
+                item.nsi_type = DRAW_NOTE_OFF;
+            }
+            else
+                continue;
 
-        if (ok)
-        {
-            midibyte d0;
-            drawevent.get_data(d0);
-            ok = istempo || event::is_desired_cc_or_not_cc(status, cc, d0);
-            if (ok)
+            if (item.nsi_note < ns->ns_low_note)
+                ns->ns_low_note = item.nsi_note;
+
+            if (item.nsi_note > ns->ns_high_note)
+                ns->ns_high_note = item.nsi_note;
+
+            ns->ns_have_notes = true;
+            if (item.nsi_type == DRAW_NOTE_OFF && islinked)
+                continue;                       /* drawn with its Note On   */
+
+            int & last = lastline[item.nsi_note % SEQ64_MIDI_COUNT_MAX];
+            bool merged = false;
+            if (last >= 0 && item.nsi_type != DRAW_TEMPO)
             {
-                /*
-                 * The caller needs to use this iterator, and so must perform
-                 * the increment afterwards itself.
-                 *
-                 * ++evi;
-                 */
+                note_summary_item & prev = ns->ns_items[last];
+                bool forward = item.nsi_tick_finish >= item.nsi_tick_start &&
+                    prev.nsi_tick_finish >= prev.nsi_tick_start;
 
-                return true;
+                if
+                (
+                    forward && prev.nsi_type == item.nsi_type &&
+                    item.nsi_tick_start <= prev.nsi_tick_finish + resolution
+                )
+                {
+                    if (item.nsi_tick_finish > prev.nsi_tick_finish)
+                        prev.nsi_tick_finish = item.nsi_tick_finish;
+
+                    if (item.nsi_velocity > prev.nsi_velocity)
+                        prev.nsi_velocity = item.nsi_velocity;
+
+                    merged = true;
+                }
+            }
+            if (! merged)
+            {
+                if (item.nsi_type != DRAW_TEMPO)
+                    last = int(ns->ns_items.size());
+
+                ns->ns_items.push_back(item);
             }
         }
-        ++evi;                              /* keep going                   */
+        m_note_summary = ns;
     }
-    return false;
+    return m_note_summary;
 }
 
 /**
@@ -4272,6 +4226,7 @@ sequence::remove_all ()
     automutex locker(m_mutex);
     m_events.clear();
     m_events.unmodify();
+    set_dirty();
 }
 
 /**
@@ -4287,6 +4242,7 @@ sequence::set_last_tick (midipulse tick)
 {
     automutex locker(m_mutex);
     m_last_tick = tick;
+    reset_play_cursor();
 }
 
 /**
@@ -4406,6 +4362,8 @@ sequence::set_length (midipulse len, bool adjust_triggers, bool verify)
     else
         len = m_length;
 
+    reset_play_cursor();
+
     /*
      * We should set the measures count here.
      */
@@ -4417,7 +4375,7 @@ sequence::set_length (midipulse len, bool adjust_triggers, bool verify)
     if (verify)
     {
         verify_and_link();
-        reset_draw_marker();
+        invalidate_snapshot();
     }
     if (was_playing)                    /* start up and refresh             */
         set_playing(true);
@@ -4566,6 +4524,8 @@ sequence::set_loop_reset (bool reset)
 {
     automutex locker(m_mutex);
     m_loop_reset = reset;
+    if (reset)
+        reset_play_cursor();
 }
 
 #endif  // SEQ64_STAZED_EXPAND_RECORD
@@ -4707,36 +4667,125 @@ sequence::print_triggers () const
  * \param ev
  *      The event to put on the buss.
  *
+ * \param late
+ *      The number of ticks by which the event is behind its due time.  Used
+ *      by the scheduled-output mode of the master buss to deliver the event
+ *      at a fixed lookahead after its due time.  Defaults to 0.
+ *
  * \threadsafe
  */
 
 void
-sequence::put_event_on_bus (event & ev)
+sequence::put_event_on_bus (event & ev, midipulse late)
 {
     automutex locker(m_mutex);
+    if (count_playing_note(ev))
+    {
+        /*
+         * \change ca 2016-03-19
+         *      Move the flush call into this condition; why flush() unless
+         *      actually playing an event?
+         */
+
+        m_masterbus->play(m_bus, &ev, m_midi_channel, late);
+        m_masterbus->flush();
+    }
+}
+
+/**
+ *  The version of put_event_on_bus() used by play().  The event is added to
+ *  the output batch of the master buss, which perform::play() flushes once
+ *  all of the sequences have played their frame, rather than played and
+ *  flushed on its own.
+ *
+ * \threadunsafe
+ *      The caller, play(), holds the mutex, and runs in the output thread,
+ *      which is the only thread allowed to post to the master buss.
+ *
+ * \param ev
+ *      The event to put on the buss.
+ *
+ * \param late
+ *      The number of ticks by which the event is behind its due time.
+ */
+
+void
+sequence::post_event_on_bus (const event & ev, midipulse late)
+{
+    if (count_playing_note(ev))
+    {
+        if (m_defer_output)
+            defer(DEFERRED_POST, ev, late);
+        else
+            m_masterbus->post(m_bus, ev, m_midi_channel, late);
+    }
+}
+
+/**
+ *  Holds back a call on the master buss, or a tempo change, while
+ *  play_deferred() runs.  The buss and channel are recorded now, so that
+ *  replay_output() plays the message where it would have been played.
+ *
+ * \threadunsafe
+ *      The caller holds the mutex.
+ *
+ * \param kind
+ *      The call to be made by replay_output().
+ *
+ * \param ev
+ *      The event to post or to play, or the tempo event.  Ignored for
+ *      DEFERRED_FLUSH.
+ *
+ * \param late
+ *      The number of ticks by which the event is behind its due time.
+ *
+ *  The push_back() does not allocate until more than SEQ64_DEFERRED_RESERVE
+ *  calls are held back in one frame.  See reserve_deferred().
+ */
+
+void
+sequence::defer (deferred_t kind, const event & ev, midipulse late)
+{
+    deferred_output d;
+    d.do_kind = kind;
+    d.do_message.bm_bus = m_bus;
+    d.do_message.bm_status = ev.get_status();
+    d.do_message.bm_channel = m_midi_channel;
+    ev.get_data(d.do_message.bm_d0, d.do_message.bm_d1);
+    d.do_message.bm_late = late;
+    d.do_bpm = kind == DEFERRED_TEMPO ? ev.tempo() : 0.0 ;
+    m_deferred.push_back(d);
+}
+
+/**
+ *  Keeps track of the notes that are sounding, so that off_playing_notes()
+ *  can silence them.  A Note Off for a note that is not sounding is not to
+ *  be sent.
+ *
+ * \threadunsafe
+ *
+ * \param ev
+ *      The event about to be sent.
+ *
+ * \return
+ *      Returns false if the event is to be skipped.
+ */
+
+bool
+sequence::count_playing_note (const event & ev)
+{
     midibyte note = ev.get_note();
-    bool skip = false;
     if (ev.is_note_on())
         m_playing_notes[note]++;
 
     if (ev.is_note_off())
     {
         if (m_playing_notes[note] <= 0)
-            skip = true;
+            return false;
         else
             m_playing_notes[note]--;
     }
-    if (! skip)
-    {
-        /*
-         * \change ca 2016-03-19
-         *      Move the flush call into this condition; why flush() unless
-         *      actually playing an event?
-         */
-
-        m_masterbus->play(m_bus, &ev, m_midi_channel);
-        m_masterbus->flush();
-    }
+    return true;
 }
 
 /**
@@ -4757,11 +4806,18 @@ sequence::off_playing_notes ()
         {
             e.set_status(EVENT_NOTE_OFF);
             e.set_data(x, 0);
-            m_masterbus->play(m_bus, &e, m_midi_channel);
+            if (m_defer_output)
+                defer(DEFERRED_PLAY, e, 0);
+            else
+                m_masterbus->play(m_bus, &e, m_midi_channel);
+
             m_playing_notes[x]--;
         }
     }
-    m_masterbus->flush();
+    if (m_defer_output)
+        defer(DEFERRED_FLUSH, e, 0);
+    else
+        m_masterbus->flush();
 }
 
 /**
@@ -4795,6 +4851,7 @@ sequence::select_events
 )
 {
     automutex locker(m_mutex);
+    invalidate_snapshot();
     midibyte d0, d1;
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -4851,10 +4908,8 @@ sequence::transpose_notes (int steps, int scale)
 {
     if (mark_selected())                            /* mark original notes  */
     {
-        automutex locker(m_mutex);
-        event_list transposed_events;
+        sequence_edit edit(*this);                  /* locks, pushes undo    */
         const int * transpose_table;
-        m_events_undo.push(m_events);               /* push_undo(), no lock  */
         if (steps < 0)
         {
             transpose_table = &c_scales_transpose_dn[scale][0];     /* down */
@@ -4869,7 +4924,6 @@ sequence::transpose_notes (int steps, int scale)
             if (er.is_marked() && er.is_note())     /* transposable event?  */
             {
                 event e = er;
-                e.unmark();
                 int note = e.get_note();
                 bool off_scale = false;
                 if (transpose_table[note % SEQ64_OCTAVE_SIZE] == 0)
@@ -4884,14 +4938,12 @@ sequence::transpose_notes (int steps, int scale)
                     note += 1;
 
                 e.set_note(note);
-                transposed_events.add(e);   // , false);    sort afterward
+                edit.add(e);                        /* sorted at commit      */
+                edit.remove(er);                    /* remove original note  */
             }
             else
                 er.unmark();                        /* ignore, no transpose */
         }
-        (void) remove_marked();                     /* remove original notes */
-        m_events.merge(transposed_events);          /* events get presorted  */
-        verify_and_link();
     }
 }
 
@@ -4902,17 +4954,13 @@ sequence::shift_notes (midipulse ticks)
 {
     if (mark_selected())
     {
-        automutex locker(m_mutex);
-        event_list shifted_events;
-        m_events_undo.push(m_events);               /* push_undo(), no lock  */
+        sequence_edit edit(*this);                  /* locks, pushes undo    */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
             if (er.is_marked() && er.is_note())     /* shiftable event?  */
             {
                 event e = er;
-                e.unmark();
-
                 midipulse timestamp = e.get_timestamp() + ticks;
                 if (timestamp < 0L)                     /* wraparound */
                     timestamp = m_length - ((-timestamp) % m_length);
@@ -4920,17 +4968,10 @@ sequence::shift_notes (midipulse ticks)
                     timestamp %= m_length;
 
                 e.set_timestamp(timestamp);
-                shifted_events.add(e);
+                edit.add(e);
+                edit.remove(er);
             }
         }
-        (void) remove_marked();
-
-#if ! defined SEQ64_USE_EVENT_MAP
-        shifted_events.sort();
-        m_events.merge(shifted_events);
-#endif
-
-        verify_and_link();
     }
 }
 
@@ -4957,6 +4998,7 @@ sequence::apply_song_transpose ()
             if (er.is_note())                       /* also aftertouch      */
                 er.transpose_note(transpose);
         }
+        invalidate_snapshot();
         set_dirty();
     }
 }
@@ -5024,7 +5066,7 @@ sequence::quantize_events
          *      push_quantize() function!
          */
 
-        event_list quantized_events;
+        sequence_edit edit(*this, false);
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
@@ -5044,7 +5086,7 @@ sequence::quantize_events
             {
                 event e = er;                   /* copy the event             */
                 er.select();                    /* selected original event    */
-                e.unmark();                     /* unmark copy of the event   */
+                edit.remove(er);                /* replaced by its copy       */
 
                 midipulse t = e.get_timestamp();
                 midipulse t_remainder = t % snap_tick;
@@ -5058,7 +5100,7 @@ sequence::quantize_events
                     t_delta = -e.get_timestamp();
 
                 e.set_timestamp(e.get_timestamp() + t_delta);
-                quantized_events.add(e);
+                edit.add(e);
 
                 /*
                  * The only events linked are notes; the status of all notes
@@ -5069,7 +5111,6 @@ sequence::quantize_events
                 {
                     event f = *er.get_linked();
                     midipulse ft = f.get_timestamp() + t_delta; /* seq32 */
-                    f.unmark();
                     er.get_linked()->select();
 
                     /*
@@ -5093,13 +5134,12 @@ sequence::quantize_events
                         ft -= m_length;
 
                     f.set_timestamp(ft);
-                    quantized_events.add(f);
+                    edit.add(f);
                 }
             }
+            else if (er.is_marked())
+                edit.remove(er);                /* dropped, as before         */
         }
-        (void) remove_marked();
-        m_events.merge(quantized_events);       /* presort quantized events */
-        verify_and_link();
     }
 }
 
@@ -5146,8 +5186,7 @@ sequence::push_quantize
 void
 sequence::multiply_pattern (double multiplier)
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo(), no lock */
+    sequence_edit edit(*this);                  /* locks, pushes undo   */
     midipulse orig_length = get_length();
     midipulse new_length = midipulse(orig_length * multiplier);
     if (new_length > orig_length)
@@ -5166,8 +5205,9 @@ sequence::multiply_pattern (double multiplier)
 
         timestamp %= m_length;
         er.set_timestamp(timestamp);
+        edit.modified(true);                    /* wrapped events move  */
     }
-    verify_and_link();
+    edit.commit();                              /* before any shrinking */
     if (new_length < orig_length)
         set_length(new_length);
 }
@@ -5235,7 +5275,7 @@ sequence::copy_events (const event_list & newevents)
         // WTF?
     }
 
-    m_iterator_draw = m_events.begin();     /* same as in reset_draw_marker */
+    invalidate_snapshot();
     if (! m_events.empty())                 /* need at least 1 (2?) events  */
     {
         /*
@@ -5297,6 +5337,99 @@ sequence::play_queue (midipulse tick, bool playbackmode)
     play(tick, playbackmode);
 }
 
+/**
+ *  The version of play_queue() used by the worker threads of the perform
+ *  object.  The frame is played as usual, but the calls that would go to
+ *  the master buss, and the tempo changes, are held back, so that several
+ *  sequences can play their frames at the same time.  The output thread
+ *  then calls replay_output() for each sequence, in order, so that the
+ *  output is exactly that of play_queue().
+ *
+ *  The mutex is held for the whole frame, so that the calls made by other
+ *  threads, such as set_playing() from the user interface, are not held
+ *  back.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      Provides the tick/pulse from which to start playing.
+ *
+ * \param playbackmode
+ *      Indicates if the playback is in live mode (false) or song mode (true).
+ */
+
+void
+sequence::play_deferred (midipulse tick, bool playbackmode)
+{
+    automutex locker(m_mutex);
+    m_defer_output = true;
+    play_queue(tick, playbackmode);
+    m_defer_output = false;
+}
+
+/**
+ *  Makes the calls held back by play_deferred(), in order, and forgets
+ *  them.  Called by the output thread.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::replay_output ()
+{
+    automutex locker(m_mutex);
+    if (! m_deferred.empty())
+    {
+        event e;
+        std::vector<deferred_output>::const_iterator d;
+        for (d = m_deferred.begin(); d != m_deferred.end(); ++d)
+        {
+            const batch_message & bm = d->do_message;
+            switch (d->do_kind)
+            {
+            case DEFERRED_POST:
+            case DEFERRED_PLAY:
+
+                e.set_status(bm.bm_status);
+                e.set_data(bm.bm_d0, bm.bm_d1);
+                if (d->do_kind == DEFERRED_POST)
+                    m_masterbus->post(bm.bm_bus, e, bm.bm_channel, bm.bm_late);
+                else
+                    m_masterbus->play(bm.bm_bus, &e, bm.bm_channel);
+                break;
+
+            case DEFERRED_FLUSH:
+
+                m_masterbus->flush();
+                break;
+
+            case DEFERRED_TEMPO:
+
+                if (not_nullptr(m_parent))
+                    m_parent->set_beats_per_minute(d->do_bpm);
+                break;
+            }
+        }
+        m_deferred.clear();                 /* keeps the capacity       */
+    }
+}
+
+/**
+ *  Makes room for the calls held back by play_deferred(), so that defer()
+ *  does not allocate memory on the output path.  Called by the perform
+ *  object when it launches its worker threads, and when it installs a
+ *  sequence while they run.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::reserve_deferred ()
+{
+    automutex locker(m_mutex);
+    m_deferred.reserve(SEQ64_DEFERRED_RESERVE);
+}
+
 /**
  *  Actually, useful mainly for the user-interface, this function calculates
  *  the size of the left and right handles of a note.  The s_handlesize value
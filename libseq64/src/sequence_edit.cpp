@@ -0,0 +1,163 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          sequence_edit.cpp
+ *
+ *  This module defines a transaction for changing many events of a
+ *  sequence at once.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The events of the sequence must not be added or erased by the caller
+ *  while the edit is open, so that iterators over them stay valid; that is
+ *  what add() and remove() are for.
+ */
+
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "sequence_edit.hpp"
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.  Locks the sequence, and pushes the current
+ *  events onto its undo stack if asked to.
+ *
+ * \param s
+ *      The sequence to edit.
+ *
+ * \param undo
+ *      If true (the default), the edit can be undone as one step.  Set it
+ *      to false when the caller handles undo itself, as push_quantize() and
+ *      the "hold" undo of the LFO window do.
+ */
+
+sequence_edit::sequence_edit (sequence & s, bool undo)
+ :
+    m_seq           (s),
+    m_locker        (s.m_mutex),
+    m_added         (),
+    m_changed       (false),
+    m_retimed       (false),
+    m_removing      (false),
+    m_committed     (false)
+{
+    if (undo)
+        m_seq.push_undo();
+}
+
+/**
+ *  Commits the changes that are not committed yet, and unlocks the
+ *  sequence.
+ */
+
+sequence_edit::~sequence_edit ()
+{
+    commit();
+}
+
+/**
+ *  Adds a new event to the sequence.  The event is copied, unmarked, and
+ *  held back until commit().
+ *
+ * \param e
+ *      The event to add.
+ */
+
+void
+sequence_edit::add (const event & e)
+{
+    event added = e;
+    added.unmark();
+    (void) m_added.append(added);
+    m_changed = true;
+}
+
+/**
+ *  Removes an event of the sequence.  The event is only marked; commit()
+ *  removes all of the marked events of the sequence at once, including
+ *  those marked before the edit by sequence::mark_selected().
+ *
+ * \param e
+ *      The event to remove.  It must belong to the sequence.
+ */
+
+void
+sequence_edit::remove (event & e)
+{
+    e.mark();
+    m_removing = true;
+    m_changed = true;
+}
+
+/**
+ *  Applies the changes:  removes the marked events, sorts the events again
+ *  if time-stamps changed in place, merges in the new events (sorting only
+ *  them), relinks the notes and prunes the events past the end of the
+ *  pattern, and then tells the views and the performance that the sequence
+ *  changed.  Does nothing if nothing changed, or if already committed.
+ */
+
+void
+sequence_edit::commit ()
+{
+    if (m_committed)
+        return;
+
+    m_committed = true;
+    if (! m_changed)
+        return;
+
+    event_list & events = m_seq.m_events;
+    events.hold_links();                /* link once, not after each step */
+    bool relink = m_retimed || ! m_added.empty();
+    if (m_removing && m_seq.remove_marked())
+        relink = true;
+
+    if (m_retimed)
+        events.sort();
+
+    if (! m_added.empty())
+        events.merge(m_added);          /* sorts the new events, then merges */
+
+    if (relink)
+        events.verify_and_link(m_seq.m_length);
+
+    events.release_links();
+
+    m_seq.invalidate_snapshot();
+    m_seq.set_dirty();
+    m_seq.modify();
+}
+
+}           // namespace seq64
+
+/*
+ * sequence_edit.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -59,6 +59,7 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>                    /* std::lower_bound(), etc.     */
 
 #include "sequence.hpp"                 /* the "parent" of the triggers */
 #include "settings.hpp"                 /* seq64::rc() settings access  */
@@ -71,6 +72,63 @@
 namespace seq64
 {
 
+/**
+ *  Compares the end of a trigger with a tick, for std::lower_bound().
+ *
+ * \param t
+ *      The trigger to check.
+ *
+ * \param tick
+ *      The tick to check against.
+ *
+ * \return
+ *      Returns true if the trigger ends before the tick.
+ */
+
+static bool
+ends_before (const trigger & t, midipulse tick)
+{
+    return t.tick_end() < tick;
+}
+
+/**
+ *  Compares a tick with the end of a trigger, for std::upper_bound().
+ *
+ * \param tick
+ *      The tick to check.
+ *
+ * \param t
+ *      The trigger to check against.
+ *
+ * \return
+ *      Returns true if the trigger ends after the tick.
+ */
+
+static bool
+ends_after (midipulse tick, const trigger & t)
+{
+    return tick < t.tick_end();
+}
+
+/**
+ *  Compares the start of a trigger with a tick, for std::lower_bound().
+ *
+ * \param t
+ *      The trigger to check.
+ *
+ * \param tick
+ *      The tick to check against.
+ *
+ * \return
+ *      Returns true if the trigger starts before the tick.
+ */
+
+static bool
+starts_before (const trigger & t, midipulse tick)
+{
+    return t.tick_start() < tick;
+}
+
 /**
  *  Principal constructor.
  *
@@ -86,8 +144,8 @@ triggers::triggers (sequence & parent)
     m_clipboard                 (),
     m_undo_stack                (),
     m_redo_stack                (),
-    m_iterator_play_trigger     (),
-    m_iterator_draw_trigger     (),
+    m_play_index                (0),
+    m_draw_index                (0),
     m_trigger_copied            (false),
     m_paste_tick                (SEQ64_NO_PASTE_TRIGGER),   // stazed
     m_ppqn                      (0),
@@ -134,8 +192,8 @@ triggers::operator = (const triggers & rhs)
         m_clipboard = rhs.m_clipboard;
         m_undo_stack = rhs.m_undo_stack;
         m_redo_stack = rhs.m_redo_stack;
-        m_iterator_play_trigger = rhs.m_iterator_play_trigger;
-        m_iterator_draw_trigger = rhs.m_iterator_draw_trigger;
+        m_play_index = rhs.m_play_index;
+        m_draw_index = rhs.m_draw_index;
         m_trigger_copied = rhs.m_trigger_copied;
         
         /*
@@ -206,12 +264,14 @@ triggers::pop_redo ()
  *  and on/off triggers, this function handles that kind of playback.
  *  This is a new function for sequence::play() to call.
  *
- *  The for-loop goes through all the triggers, determining if there is are
- *  trigger start/end values before the \a end_tick.  If so, then the trigger
- *  state is set to true (start only within the tick range) or false (end is
- *  within the tick range), and the trigger tick is set to start or end.
- *  The first start or end trigger that is past the end tick cause the search
- *  to end.
+ *  The old for-loop went through all the triggers, determining if there
+ *  were trigger start/end values before the \a end_tick.  If so, then the
+ *  trigger state was set to true (start only within the tick range) or false
+ *  (end is within the tick range), and the trigger tick was set to start or
+ *  end.  The first start or end trigger that was past the end tick caused
+ *  the search to end.  Since the triggers are sorted by end tick, that
+ *  trigger is found by play_index(), and only it and the trigger before it
+ *  need to be examined.
  *
  *  If the trigger state has changed, then the start/end ticks are passed back
  *  to the sequence, and the trigger offset is adjusted.
@@ -236,22 +296,21 @@ triggers::play (midipulse & start_tick, midipulse & end_tick)
     bool trigger_state = false;
     midipulse trigger_offset = 0;
     midipulse trigger_tick = 0;
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    std::size_t index = play_index(end_tick);
+    bool inside = index < m_triggers.size() &&
+        m_triggers[index].tick_start() <= end_tick;
+
+    if (inside)
     {
-        if (i->tick_start() <= end_tick)
-        {
-            trigger_state = true;
-            trigger_tick = i->tick_start();
-            trigger_offset = i->offset();
-        }
-        if (i->tick_end() <= end_tick)
-        {
-            trigger_state = false;
-            trigger_tick = i->tick_end();
-            trigger_offset = i->offset();
-        }
-        if (i->tick_start() > end_tick || i->tick_end() > end_tick)
-            break;
+        trigger_state = true;                   /* inside this trigger      */
+        trigger_tick = m_triggers[index].tick_start();
+        trigger_offset = m_triggers[index].offset();
+    }
+    else if (index > 0)
+    {
+        trigger_state = false;                  /* past the previous one    */
+        trigger_tick = m_triggers[index - 1].tick_end();
+        trigger_offset = m_triggers[index - 1].offset();
     }
 
     /*
@@ -282,6 +341,68 @@ triggers::play (midipulse & start_tick, midipulse & end_tick)
     return result;
 }
 
+/**
+ *  Finds the first trigger that ends after the given tick.  The result of
+ *  the previous call, and the trigger after it, are tried first; otherwise a
+ *  binary search is done.
+ *
+ * \param tick
+ *      The tick of interest, normally the end tick of an output frame.
+ *
+ * \return
+ *      Returns the index of the first trigger whose end tick is greater than
+ *      \a tick, or the number of triggers if there is none.
+ */
+
+std::size_t
+triggers::play_index (midipulse tick)
+{
+    std::size_t count = m_triggers.size();
+    for (std::size_t hint = m_play_index; hint <= m_play_index + 1; ++hint)
+    {
+        if (hint > count)
+            break;
+
+        bool after = hint == count || m_triggers[hint].tick_end() > tick;
+        bool before = hint == 0 || m_triggers[hint - 1].tick_end() <= tick;
+        if (after && before)
+        {
+            m_play_index = hint;
+            return hint;
+        }
+    }
+    List::iterator i = std::upper_bound
+    (
+        m_triggers.begin(), m_triggers.end(), tick, ends_after
+    );
+    m_play_index = std::size_t(i - m_triggers.begin());
+    return m_play_index;
+}
+
+/**
+ *  Finds the trigger that brackets the given tick, by a binary search.
+ *
+ * \param tick
+ *      The tick of interest.
+ *
+ * \return
+ *      Returns an iterator to the trigger whose start and end ticks contain
+ *      \a tick, or m_triggers.end() if there is none.
+ */
+
+triggers::List::iterator
+triggers::find (midipulse tick)
+{
+    List::iterator i = std::lower_bound
+    (
+        m_triggers.begin(), m_triggers.end(), tick, ends_before
+    );
+    if (i != m_triggers.end() && i->tick_start() <= tick)
+        return i;
+
+    return m_triggers.end();
+}
+
 /**
  *  Adjusts the given offset by mod'ing it with m_length and adding
  *  m_length if needed, and returning the result.
@@ -366,12 +487,21 @@ triggers::add
     );
 #endif
 
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    /*
+     * Only the triggers from the first one that does not end before the new
+     * one starts, up to the last one that starts before the new one ends,
+     * can overlap it.
+     */
+
+    List::iterator i = std::lower_bound
+    (
+        m_triggers.begin(), m_triggers.end(), t.tick_start(), ends_before
+    );
+    while (i != m_triggers.end() && i->tick_start() <= t.tick_end())
     {
         if (i->tick_start() >= t.tick_start() && i->tick_end() <= t.tick_end())
         {
-            m_triggers.erase(i);                /* inside the new one? erase  */
-            i = m_triggers.begin();             /* THERE IS A BETTER WAY      */
+            i = m_triggers.erase(i);            /* inside the new one? erase  */
             continue;
         }
         else if (i->tick_end() >= t.tick_end() && i->tick_start() <= t.tick_end())
@@ -385,9 +515,13 @@ triggers::add
         {
             i->tick_end(t.tick_start() - 1);    /* last start inside new end? */
         }
+        ++i;
     }
-    m_triggers.push_front(t);
-    m_triggers.sort();                          /* hmmm, another sort       */
+    i = std::lower_bound
+    (
+        m_triggers.begin(), m_triggers.end(), t.tick_start(), starts_before
+    );
+    m_triggers.insert(i, t);                    /* keeps the vector sorted  */
 }
 
 /**
@@ -416,14 +550,12 @@ triggers::add
 bool
 triggers::intersect (midipulse position, midipulse & start, midipulse & ender)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    List::iterator i = find(position);
+    if (i != m_triggers.end())
     {
-        if (i->tick_start() <= position && position <= i->tick_end())
-        {
-            start = i->tick_start();    /* return by reference */
-            ender = i->tick_end();      /* ditto               */
-            return true;
-        }
+        start = i->tick_start();        /* return by reference */
+        ender = i->tick_end();          /* ditto               */
+        return true;
     }
     return false;
 }
@@ -451,21 +583,18 @@ triggers::intersect (midipulse position, midipulse & start, midipulse & ender)
 void
 triggers::grow (midipulse tickfrom, midipulse tickto, midipulse len)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    List::iterator i = find(tickfrom);
+    if (i != m_triggers.end())
     {
-        if (i->tick_start() <= tickfrom && tickfrom <= i->tick_end())
-        {
-            midipulse start = i->tick_start();
-            midipulse ender = i->tick_end();
-            if (tickto < start)
-                start = tickto;
+        midipulse start = i->tick_start();
+        midipulse ender = i->tick_end();
+        if (tickto < start)
+            start = tickto;
 
-            if ((tickto + len - 1) > ender)
-                ender = tickto + len - 1;
+        if ((tickto + len - 1) > ender)
+            ender = tickto + len - 1;
 
-            add(start, ender - start + 1, i->offset());
-            break;
-        }
+        add(start, ender - start + 1, i->offset());
     }
 }
 
@@ -480,14 +609,9 @@ triggers::grow (midipulse tickfrom, midipulse tickto, midipulse len)
 void
 triggers::remove (midipulse tick)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
-    {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
-        {
-            m_triggers.erase(i);
-            break;
-        }
-    }
+    List::iterator i = find(tick);
+    if (i != m_triggers.end())
+        m_triggers.erase(i);
 }
 
 /**
@@ -503,6 +627,9 @@ triggers::remove (midipulse tick)
  * \param splittick
  *      The position just after where the original trigger will be
  *      truncated, and the new trigger begins.
+ *
+ *  Since add() can grow the vector, \a trig must not be used after this
+ *  call.
  */
 
 void
@@ -528,20 +655,17 @@ triggers::split (trigger & trig, midipulse splittick)
 void
 triggers::split (midipulse splittick)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    List::iterator i = find(splittick);
+    if (i != m_triggers.end())
     {
-        if (i->tick_start() <= splittick && splittick <= i->tick_end())
+        if (rc().allow_snap_split())
         {
-            if (rc().allow_snap_split())
-            {
-                split(*i, splittick);               /* stazed feature   */
-            }
-            else
-            {
-                midipulse tick = (i->tick_end() - i->tick_start() + 1) / 2;
-                split(*i, i->tick_start() + tick);
-            }
-            break;
+            split(*i, splittick);                   /* stazed feature   */
+        }
+        else
+        {
+            midipulse tick = (i->tick_end() - i->tick_start() + 1) / 2;
+            split(*i, i->tick_start() + tick);
         }
     }
 }
@@ -653,6 +777,7 @@ triggers::copy (midipulse starttick, midipulse distance)
 {
     midipulse from_start_tick = starttick + distance;
     midipulse from_end_tick = from_start_tick + distance - 1;
+    List copies;
     move(starttick, distance, true);
     for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
@@ -674,15 +799,18 @@ triggers::copy (midipulse starttick, midipulse distance)
             if (t.offset() < 0)
                 t.increment_offset(m_length);
 
-            m_triggers.push_front(t);
+            copies.push_back(t);
         }
     }
-    m_triggers.sort();
+    m_triggers.insert(m_triggers.end(), copies.begin(), copies.end());
+    std::stable_sort(m_triggers.begin(), m_triggers.end());
 }
 
 /**
  *  Moves triggers in the trigger-list.  There's no way to optimize this by
- *  saving tick values, as they are potentially modified at each step.
+ *  saving tick values, as they are potentially modified at each step.  The
+ *  first loop uses an index, because splitting a trigger adds one, which
+ *  can reallocate the vector.
  *
  * \param starttick
  *      The current location of the triggers.
@@ -700,36 +828,50 @@ void
 triggers::move (midipulse starttick, midipulse distance, bool direction)
 {
     midipulse endtick = starttick + distance;
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    std::size_t n = 0;
+    while (n < m_triggers.size())
     {
-        if (i->tick_start() < starttick && starttick < i->tick_end())
+        if
+        (
+            m_triggers[n].tick_start() < starttick &&
+            starttick < m_triggers[n].tick_end()
+        )
         {
             if (direction)                              /* forward */
-                split(*i, starttick);
+                split(m_triggers[n], starttick);
             else                                        /* back    */
-                split(*i, endtick);
+                split(m_triggers[n], endtick);
         }
-        if (i->tick_start() < starttick && starttick < i->tick_end())
+        if
+        (
+            m_triggers[n].tick_start() < starttick &&
+            starttick < m_triggers[n].tick_end()
+        )
         {
             if (direction)                              /* forward */
-                split(*i, starttick);
+                split(m_triggers[n], starttick);
             else                                        /* back    */
-                i->tick_end(starttick - 1);
+                m_triggers[n].tick_end(starttick - 1);
         }
         if
         (
-            i->tick_start() >= starttick &&
-            i->tick_end() <= endtick && ! direction
+            m_triggers[n].tick_start() >= starttick &&
+            m_triggers[n].tick_end() <= endtick && ! direction
         )
         {
-            m_triggers.erase(i);
-            i = m_triggers.begin();                     /* A BETTER WAY? */
+            m_triggers.erase(m_triggers.begin() + n);
+            continue;                                   /* same index   */
         }
-        if (i->tick_start() < endtick && endtick < i->tick_end())
+        if
+        (
+            m_triggers[n].tick_start() < endtick &&
+            endtick < m_triggers[n].tick_end()
+        )
         {
             if (! direction)                            /* forward */
-                i->tick_start(endtick);
+                m_triggers[n].tick_start(endtick);
         }
+        ++n;
     }
     for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
@@ -945,16 +1087,7 @@ triggers::get_maximum ()
 bool
 triggers::get_state (midipulse tick)
 {
-    bool result = false;
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
-    {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
-        {
-            result = true;
-            break;
-        }
-    }
-    return result;
+    return find(tick) != m_triggers.end();
 }
 
 /**
@@ -1103,9 +1236,9 @@ triggers::paste (midipulse paste_tick)
  *      on the values returned through the return parameters.
  *
  * \sideeffect
- *      The value of the m_iterator_draw_trigger member will be altered by this
- *      call, unless pointing to the end of the triggerlist, or if there are
- *      no triggers.
+ *      The value of the m_draw_index member will be altered by this call,
+ *      unless pointing to the end of the triggerlist, or if there are no
+ *      triggers.
  */
 
 bool
@@ -1117,13 +1250,14 @@ triggers::next
     midipulse & offset
 )
 {
-    while (m_iterator_draw_trigger != m_triggers.end())
+    if (m_draw_index < m_triggers.size())
     {
-        tick_on  = m_iterator_draw_trigger->tick_start();
-        selected = m_iterator_draw_trigger->selected();
-        offset = m_iterator_draw_trigger->offset();
-        tick_off = m_iterator_draw_trigger->tick_end();
-        ++m_iterator_draw_trigger;
+        const trigger & t = m_triggers[m_draw_index];
+        tick_on  = t.tick_start();
+        selected = t.selected();
+        offset = t.offset();
+        tick_off = t.tick_end();
+        ++m_draw_index;
         return true;
     }
     return false;
@@ -1141,10 +1275,10 @@ trigger
 triggers::next_trigger ()
 {
     trigger result;
-    while (m_iterator_draw_trigger != m_triggers.end())
+    while (m_draw_index < m_triggers.size())
     {
-        result = *m_iterator_draw_trigger;
-        ++m_iterator_draw_trigger;
+        result = m_triggers[m_draw_index];
+        ++m_draw_index;
     }
     return result;
 }
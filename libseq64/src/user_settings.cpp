@@ -209,7 +209,10 @@ user_settings::user_settings ()
     mc_max_zoom                 (SEQ64_MAXIMUM_ZOOM),
     mc_baseline_ppqn            (SEQ64_DEFAULT_PPQN),
     m_user_option_daemonize     (false),
-    m_user_option_logfile       ()
+    m_user_option_logfile       (),
+    m_user_option_renderfile    (),
+    m_user_option_metricsfile   (),
+    m_user_option_metrics_interval (1)
 {
     // Empty body; it's no use to call normalize() here, see set_defaults().
 }
@@ -314,7 +317,10 @@ user_settings::user_settings (const user_settings & rhs)
     mc_max_zoom                 (rhs.mc_max_zoom),
     mc_baseline_ppqn            (SEQ64_DEFAULT_PPQN),
     m_user_option_daemonize     (false),
-    m_user_option_logfile       ()
+    m_user_option_logfile       (),
+    m_user_option_renderfile    (),
+    m_user_option_metricsfile   (),
+    m_user_option_metrics_interval (1)
 {
     // Empty body; no need to call normalize() here.
 }
@@ -427,6 +433,9 @@ user_settings::operator = (const user_settings & rhs)
 
         m_user_option_daemonize = rhs.m_user_option_daemonize;
         m_user_option_logfile = rhs.m_user_option_logfile;
+        m_user_option_renderfile = rhs.m_user_option_renderfile;
+        m_user_option_metricsfile = rhs.m_user_option_metricsfile;
+        m_user_option_metrics_interval = rhs.m_user_option_metrics_interval;
     }
     return *this;
 }
@@ -498,6 +507,9 @@ user_settings::set_defaults ()
 
     m_user_option_daemonize = false;
     m_user_option_logfile.clear();
+    m_user_option_renderfile.clear();
+    m_user_option_metricsfile.clear();
+    m_user_option_metrics_interval = 1;
     normalize();                            // recalculate derived values
 }
 
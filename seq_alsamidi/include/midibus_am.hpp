@@ -176,16 +176,23 @@ protected:
     virtual bool api_init_in_sub ();
     virtual bool api_deinit_in ();
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_scheduled
+    (
+        event * e24, midibyte channel, midipulse delay
+    );
     virtual void api_sysex (event * e24);
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
     virtual void api_start ();
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
+    virtual void api_clock_scheduled (midipulse tick, midipulse delay);
 
 private:
 
     bool set_virtual_name (int portid, const std::string & portname);
+    int create_input_port (const std::string & portname, unsigned caps);
+    void encode_event (event * e24, midibyte channel, snd_seq_event_t & ev);
 
 };          // class midibus (ALSA version)
 
@@ -370,6 +370,20 @@ mastermidibus::api_init (int ppqn, midibpm bpm)
     );
     m_bus_announce->set_input(true);
 
+    /*
+     * In the scheduled-output mode, the events are stamped relative to the
+     * current position of our queue, so the queue must run all the time.
+     */
+
+    m_scheduled_output = rc().alsa_scheduled_output();
+    m_lookahead_ms = rc().alsa_lookahead_ms();
+    if (m_scheduled_output)
+    {
+        snd_seq_start_queue(m_alsa_seq, m_queue, NULL); /* start timer      */
+        snd_seq_drain_output(m_alsa_seq);
+        infoprintf("ALSA scheduled output, %d ms lookahead\n", m_lookahead_ms);
+    }
+
     /*
      * Set clock values and initialize the configured inputs.  Some inputs
      * might not need to be initialized, according to the configuration.
@@ -392,7 +406,8 @@ mastermidibus::api_init (int ppqn, midibpm bpm)
 void
 mastermidibus::api_start ()
 {
-    snd_seq_start_queue(m_alsa_seq, m_queue, NULL);     /* start timer */
+    if (! m_scheduled_output)                           /* already running */
+        snd_seq_start_queue(m_alsa_seq, m_queue, NULL); /* start timer */
 }
 
 /**
@@ -408,12 +423,16 @@ mastermidibus::api_start ()
 void
 mastermidibus::api_continue_from (midipulse /* tick */)
 {
-    snd_seq_start_queue(m_alsa_seq, m_queue, NULL);     /* start timer */
+    if (! m_scheduled_output)                           /* already running */
+        snd_seq_start_queue(m_alsa_seq, m_queue, NULL); /* start timer */
 }
 
 /**
  *  Stops each of the output busses.  If ALSA support is enable, also drains
- *  the output, synchronizes the output queue, and then stop the queue.
+ *  the output, synchronizes the output queue, and then stop the queue.  In
+ *  the scheduled-output mode, the sync waits for the events still pending in
+ *  the queue (such as the final Note Offs) to go out, and the queue is left
+ *  running for the events played while stopped.
  *
  * \threadsafe
  */
@@ -423,7 +442,8 @@ mastermidibus::api_stop ()
 {
     snd_seq_drain_output(m_alsa_seq);
     snd_seq_sync_output_queue(m_alsa_seq);
-    snd_seq_stop_queue(m_alsa_seq, m_queue, NULL);  /* start timer */
+    if (! m_scheduled_output)
+        snd_seq_stop_queue(m_alsa_seq, m_queue, NULL);  /* start timer */
 }
 
 /**
@@ -609,6 +629,50 @@ mastermidibus::api_port_start (int bus, int port)
     );
 }
 
+/**
+ *  Converts the real-time stamp that ALSA put on an input event (see
+ *  midibus::create_input_port()) to a wakeup_event::now_us() time.  The
+ *  age of the event is the current real time of the queue minus the stamp;
+ *  the arrival time is that much before now.
+ *
+ * \param seq
+ *      The ALSA sequencer handle.
+ *
+ * \param queue
+ *      The master queue, which stamped the event.
+ *
+ * \param ev
+ *      The input event.
+ *
+ * \return
+ *      Returns the arrival time of the event, or the current time if the
+ *      event has no real-time stamp.
+ */
+
+static std::int64_t
+arrival_us (snd_seq_t * seq, int queue, const snd_seq_event_t * ev)
+{
+    std::int64_t result = wakeup_event::now_us();
+    if ((ev->flags & SND_SEQ_TIME_STAMP_MASK) == SND_SEQ_TIME_STAMP_REAL)
+    {
+        snd_seq_queue_status_t * status;
+        snd_seq_queue_status_alloca(&status);
+        if (snd_seq_get_queue_status(seq, queue, status) >= 0)
+        {
+            const snd_seq_real_time_t * now =
+                snd_seq_queue_status_get_real_time(status);
+
+            std::int64_t ageus =
+                (std::int64_t(now->tv_sec) - ev->time.time.tv_sec) * 1000000 +
+                (std::int64_t(now->tv_nsec) - ev->time.time.tv_nsec) / 1000;
+
+            if (ageus > 0)
+                result -= ageus;
+        }
+    }
+    return result;
+}
+
 /**
  *  Grab a MIDI event.  First, a rather large buffer is allocated on the stack
  *  to hold the MIDI event data.  Next, if the --alsa-manual-ports option is
@@ -670,7 +734,7 @@ mastermidibus::api_get_midi_event (event * inev)
     if (bytes <= 0)                                 /* happens at startup    */
         return false;
 
-    inev->set_timestamp(ev->time.tick);
+    inev->set_timestamp(arrival_us(m_alsa_seq, m_queue, ev));  /* arrival */
     inev->set_status_keep_channel(buffer[0]);
 
     /**
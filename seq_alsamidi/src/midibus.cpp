@@ -32,6 +32,7 @@
  */
 
 #include "globals.h"
+#include "alsa_event.hpp"               /* seq64::encode_channel_event()    */
 #include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
 #include "event.hpp"                    /* seq64::event (MIDI event)        */
 #include "midibus.hpp"                  /* seq64::midibus for ALSA          */
@@ -236,7 +237,49 @@ midibus::api_init_out ()
 }
 
 /**
- *  Initialize the MIDI input port.
+ *  Creates an input port like snd_seq_create_simple_port() does, but with
+ *  time-stamping on:  ALSA stamps each event delivered to the port with the
+ *  real time of the master queue when the event arrives, so that
+ *  mastermidibus::api_get_midi_event() gets the arrival time rather than
+ *  the time the input thread got around to reading the event.
+ *
+ * \param portname
+ *      The name of the port.
+ *
+ * \param caps
+ *      The SND_SEQ_PORT_CAP_* capabilities of the port.
+ *
+ * \return
+ *      Returns the port number, or a negative ALSA error code.
+ */
+
+int
+midibus::create_input_port (const std::string & portname, unsigned caps)
+{
+    snd_seq_port_info_t * pinfo;
+    snd_seq_port_info_alloca(&pinfo);
+    snd_seq_port_info_set_name(pinfo, portname.c_str());
+    snd_seq_port_info_set_capability(pinfo, caps);
+    snd_seq_port_info_set_type
+    (
+        pinfo, SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION
+    );
+    snd_seq_port_info_set_midi_channels(pinfo, 16);
+    snd_seq_port_info_set_timestamping(pinfo, 1);
+    snd_seq_port_info_set_timestamp_real(pinfo, 1);
+    snd_seq_port_info_set_timestamp_queue(pinfo, queue_number());
+
+    int result = snd_seq_create_port(m_seq, pinfo);
+    if (result >= 0)
+        result = snd_seq_port_info_get_port(pinfo);
+
+    return result;
+}
+
+/**
+ *  Initialize the MIDI input port.  The subscription asks for real-time
+ *  stamps from the master queue, as the port itself does; see
+ *  create_input_port().
  *
  * \return
  *      Returns true unless setting up ALSA MIDI failed in some way.
@@ -245,17 +288,14 @@ midibus::api_init_out ()
 bool
 midibus::api_init_in ()
 {
-    int result = snd_seq_create_simple_port             /* create ports */
+    int result = create_input_port
     (
-        m_seq,
-        m_input_port_name.c_str(),
-        SND_SEQ_PORT_CAP_NO_EXPORT | SND_SEQ_PORT_CAP_WRITE,
-        SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION
+        m_input_port_name, SND_SEQ_PORT_CAP_NO_EXPORT | SND_SEQ_PORT_CAP_WRITE
     );
     m_local_addr_port = result;
     if (result < 0)
     {
-        errprint("snd_seq_create_simple_port(read) error");
+        errprint("snd_seq_create_port(read) error");
         return false;
     }
 
@@ -273,11 +313,12 @@ midibus::api_init_in ()
     snd_seq_port_subscribe_set_dest(subs, &dest);       /* local              */
 
     /*
-     * Use the master queue, and get ticks, then subscribe.
+     * Use the master queue, and get real-time stamps, then subscribe.
      */
 
     snd_seq_port_subscribe_set_queue(subs, queue_number());
     snd_seq_port_subscribe_set_time_update(subs, 1);
+    snd_seq_port_subscribe_set_time_real(subs, 1);
     result = snd_seq_subscribe_port(m_seq, subs);
     if (result < 0)
     {
@@ -367,7 +408,9 @@ midibus::api_init_out_sub ()
 }
 
 /**
- *  Initialize the output in a different way?
+ *  Initialize the output in a different way?  The port stamps the events
+ *  it gets with the real time of the master queue; see
+ *  create_input_port().
  *
  * \return
  *      Returns true unless setting up the ALSA port failed in some way.
@@ -380,17 +423,14 @@ midibus::api_init_in_sub ()
     if (portname.empty())
         portname = m_input_port_name;
 
-    int result = snd_seq_create_simple_port             /* create ports */
+    int result = create_input_port
     (
-        m_seq,
-        portname.c_str(),
-        SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE,
-        SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION
+        portname, SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE
     );
     m_local_addr_port = result;
     if (result < 0)
     {
-        errprint("snd_seq_create_simple_port(write) error");
+        errprint("snd_seq_create_port(write) error");
         return false;
     }
     else
@@ -424,7 +464,8 @@ midibus::api_deinit_in ()
     snd_seq_port_subscribe_set_dest(subs, &dest);
 
     snd_seq_port_subscribe_set_queue(subs, queue_number()); /* master queue */
-    snd_seq_port_subscribe_set_time_update(subs, 1);        /* get ticks    */
+    snd_seq_port_subscribe_set_time_update(subs, 1);        /* get stamps   */
+    snd_seq_port_subscribe_set_time_real(subs, 1);          /* real time    */
 
     int result = snd_seq_unsubscribe_port(m_seq, subs);     /* subscribe    */
     if (result < 0)
@@ -449,9 +490,8 @@ midibus::api_deinit_in ()
 
 /**
  *  This play() function takes a native event, encodes it to an ALSA MIDI
- *  sequencer event, sets the broadcasting to the subscribers, sets the
- *  direct-passing mode to send the event without queueing, and puts it in the
- *  queue.
+ *  sequencer event (see encode_event()), sets the direct-passing mode to send
+ *  the event without queueing, and puts it in the queue.
  *
  * \threadsafe
  *
@@ -465,23 +505,78 @@ midibus::api_deinit_in ()
 
 void
 midibus::api_play (event * e24, midibyte channel)
+{
+    snd_seq_event_t ev;
+    encode_event(e24, channel, ev);
+    snd_seq_ev_set_direct(&ev);                     /* it is immediate      */
+    snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
+}
+
+/**
+ *  The scheduled version of api_play().  Instead of being sent directly, the
+ *  event is stamped with a tick relative to the current position of the
+ *  master buss's ALSA queue, which must be running, and the ALSA sequencer
+ *  delivers it at that time.  Since the queue follows the same tempo as the
+ *  output thread, the lateness of the output thread is absorbed as long as
+ *  it is less than the lookahead.  Used in the [alsa-scheduled-output] mode.
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param delay
+ *      The number of ticks from now at which the event is to be delivered.
+ */
+
+void
+midibus::api_play_scheduled (event * e24, midibyte channel, midipulse delay)
+{
+    snd_seq_event_t ev;
+    encode_event(e24, channel, ev);
+    snd_seq_ev_schedule_tick                        /* relative to "now"    */
+    (
+        &ev, queue_number(), 1, snd_seq_tick_time_t(delay)
+    );
+    snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
+}
+
+/**
+ *  Encodes a native event into an ALSA sequencer event addressed to the
+ *  subscribers of this port.  Channel messages are encoded by
+ *  encode_channel_event(); only other messages go through an ALSA MIDI event
+ *  parser.  The caller sets the timing (direct or scheduled).
+ *
+ * \param e24
+ *      The event to be encoded.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param ev
+ *      The ALSA event to be filled in.
+ */
+
+void
+midibus::encode_event (event * e24, midibyte channel, snd_seq_event_t & ev)
 {
     midibyte buffer[4];                             /* temp for MIDI data   */
     buffer[0] = e24->get_status();                  /* fill buffer          */
     buffer[0] += (channel & 0x0F);
     e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
-
-    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
-    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
-
-    snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);                          /* clear event          */
-    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
-    snd_midi_event_free(midi_ev);                   /* free the parser      */
+    if (! encode_channel_event(buffer, ev))         /* fast path failed     */
+    {
+        snd_midi_event_t * midi_ev;                 /* ALSA MIDI parser     */
+        snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
+        snd_midi_event_encode(midi_ev, buffer, 3, &ev);
+        snd_midi_event_free(midi_ev);               /* free the parser      */
+    }
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
     snd_seq_ev_set_subs(&ev);
-    snd_seq_ev_set_direct(&ev);                     /* it is immediate      */
-    snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
 }
 
 /**
@@ -707,6 +802,39 @@ midibus::api_clock (midipulse /* tick */)
     snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
 }
 
+/**
+ *  The scheduled version of api_clock().  The clock is stamped with a tick
+ *  relative to the current position of the master buss's ALSA queue, like
+ *  the events of api_play_scheduled(), so that it keeps in step with them.
+ *  Used in the [alsa-scheduled-output] mode.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      Provides the starting tick, unused in the ASLA implementation.
+ *
+ * \param delay
+ *      The number of ticks from now at which the clock is to be delivered.
+ */
+
+void
+midibus::api_clock_scheduled (midipulse /* tick */, midipulse delay)
+{
+    snd_seq_event_t ev;
+    snd_seq_ev_clear(&ev);                          /* clear event          */
+    ev.type = SND_SEQ_EVENT_CLOCK;
+    ev.tag = 127;
+    snd_seq_ev_set_fixed(&ev);
+    snd_seq_ev_set_priority(&ev, 1);
+    snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
+    snd_seq_ev_set_subs(&ev);
+    snd_seq_ev_schedule_tick                        /* relative to "now"    */
+    (
+        &ev, queue_number(), 1, snd_seq_tick_time_t(delay)
+    );
+    snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
+}
+
 #if REMOVE_QUEUED_ON_EVENTS_CODE
 
 /**
@@ -102,6 +102,7 @@ namespace seq64
     class maintime;
     class options;
     class perfedit;
+    class statswnd;
 
 /**
  *  This class implements the functionality of the main window of the
@@ -293,6 +294,13 @@ private:
 
     options * m_options;
 
+    /**
+     *  A pointer to the window showing the timing statistics of the output
+     *  thread.  Created the first time it is opened.
+     */
+
+    statswnd * m_stats_wnd;
+
     /**
      *  Mouse cursor?
      */
@@ -613,6 +621,7 @@ private:
 
     void open_performance_edit ();
     void open_performance_edit_2 ();
+    void open_timing_stats ();
     void enregister_perfedits ();
     void sequence_key (int seq);
 
@@ -154,6 +154,14 @@ private:
 
     int m_sequence_offset;
 
+    /**
+     *  The perform::dirty_generation() value at the last scan for dirty
+     *  sequences.  If it has not changed, no sequence needs a redraw, and
+     *  the scan is skipped.
+     */
+
+    unsigned long m_dirty_generation;
+
     /**
      *  Indicates if the given sequence is active or not.  If this really is
      *  the true meaning of this value, we ought to get it directly from the
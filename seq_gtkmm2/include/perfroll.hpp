@@ -36,9 +36,20 @@
  *
  */
 
+#include <map>                          /* std::map of thumbnails       */
+
 #include "gui_drawingarea_gtk2.hpp"
 #include "fruityperfroll_input.hpp"     /* FruityPerfInput      */
 #include "perfroll_input.hpp"           /* Seq24PerfInput       */
+#include "sequence.hpp"                 /* seq64::note_summary_ptr      */
+
+/**
+ *  The widest repetition of a sequence, in pixels, that the song editor
+ *  pre-renders as a thumbnail.  Wider repetitions, seen only when zoomed far
+ *  in, are drawn from the note summary of the sequence instead.
+ */
+
+#define SEQ64_THUMBNAIL_MAX_X   2048
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -216,6 +227,14 @@ private:
 
     int m_sequence_offset;
 
+    /**
+     *  The perform::dirty_generation() value at the last scan for dirty
+     *  sequences.  If it has not changed, no sequence needs a redraw, and
+     *  the scan is skipped.
+     */
+
+    unsigned long m_dirty_generation;
+
     /**
      *  Provides the width of the piano roll in ticks.  Calculated in
      *  init_before_show() based on the maximum trigger found in the perform
@@ -310,6 +329,30 @@ private:
 
     bool m_grow_direction;
 
+    /**
+     *  One pre-rendered repetition of a sequence, as drawn inside its
+     *  triggers, with one pixmap for each trigger background.  It stays
+     *  good while the note summary, the size, and the transposability of
+     *  the sequence are the same.
+     */
+
+    struct thumbnail
+    {
+        note_summary_ptr th_summary;            /**< The summary drawn.     */
+        int th_width;                           /**< The repetition width.  */
+        int th_height;                          /**< The trigger height.    */
+        bool th_transposable;                   /**< Black or red notes.    */
+        Glib::RefPtr<Gdk::Pixmap> th_pixmap[2]; /**< Unselected, selected.  */
+    };
+
+    /**
+     *  The thumbnails of the sequences, keyed by sequence number, created as
+     *  the sequences are drawn.  Only the rows in view keep theirs; see
+     *  prune_thumbnails().
+     */
+
+    std::map<int, thumbnail> m_thumbnails;
+
 public:
 
     perfroll
@@ -349,6 +392,17 @@ private:
     void convert_x (int x, midipulse & tick);
     void snap_x (int & x);
     void draw_sequence_on (int seqnum);
+    Glib::RefPtr<Gdk::Pixmap> get_thumbnail
+    (
+        int seqnum, const note_summary_ptr & ns,
+        int width, int height, bool selected, bool transposable
+    );
+    void prune_thumbnails ();
+    void draw_note_summary
+    (
+        Glib::RefPtr<Gdk::Pixmap> & pixmap, const note_summary & ns,
+        bool transposable, int x0, int y0, int width, int xmin, int xmax
+    );
     void draw_background_on (int seqnum);
     void draw_drawable_row (long y);
     void change_horz ();
@@ -0,0 +1,123 @@
+#ifndef SEQ64_STATSWND_HPP
+#define SEQ64_STATSWND_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          statswnd.hpp
+ *
+ *  This module declares the window that shows the timing statistics of the
+ *  output thread.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The window is opened from the View menu.  It refreshes itself once a
+ *  second from perform::get_output_stats(), and its Reset button calls
+ *  perform::reset_output_stats().
+ */
+
+#include <sigc++/connection.h>
+#include <gtkmm/window.h>
+
+#include "gui_window_gtk2.hpp"          /* seq64::qui_window_gtk2           */
+#include "perfstats.hpp"                /* seq64::perfstats::METRICS        */
+
+/**
+ *  The number of value columns in the table:  count, average, maximum, 50th
+ *  percentile, and 99th percentile.
+ */
+
+#define SEQ64_STATS_COLUMNS             5
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace Gtk
+{
+    class Button;
+    class Label;
+    class Table;
+    class VBox;
+}
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class perform;
+
+/**
+ *  Shows the timing statistics of the output thread of the performance.
+ */
+
+class statswnd : public gui_window_gtk2
+{
+
+private:
+
+    /*
+     * GUI elements
+     */
+
+    Gtk::VBox * m_vbox;             /**< The main vertical packing box.     */
+    Gtk::Table * m_table;           /**< One row per metric.                */
+    Gtk::Label * m_label_summary;   /**< Elapsed time and underruns.        */
+    Gtk::Button * m_button_reset;   /**< Sets the statistics back to zero.  */
+
+    /**
+     *  The labels of the values in the table, one row per metric.
+     */
+
+    Gtk::Label * m_values[perfstats::METRICS][SEQ64_STATS_COLUMNS];
+
+    /**
+     *  The connection to the refresh timer, disconnected by the destructor
+     *  so that the timer never calls a deleted window.
+     */
+
+    sigc::connection m_timer;
+
+public:
+
+    statswnd (perform & p);
+    virtual ~statswnd ();
+
+private:
+
+    void reset ();
+    bool refresh ();
+
+};
+
+}           // namespace seq64
+
+#endif      // SEQ64_STATSWND_HPP
+
+/*
+ * statswnd.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -468,19 +468,17 @@ mainwid::draw_sequence_on_pixmap (int seqnum)
             }
             draw_rectangle_on_pixmap(fg_color(), x, y, lx, ly, false);
 
-            int low_note;                                // for side-effect
-            int high_note;                               // ditto
-            bool have_notes = seq->get_minmax_note_events(low_note, high_note);
-            if (have_notes)
+            /*
+             * The cached note summary replaces the scan of the events.  It
+             * is rebuilt only when the sequence changes.
+             */
+
+            note_summary_ptr ns = seq->get_note_summary();
+            if (ns->ns_have_notes)
             {
-                int height = high_note - low_note + 2;    // 2-pixel border
+                int low_note = ns->ns_low_note;
+                int height = ns->ns_high_note - low_note + 2;   // 2-px border
                 int len = seq->get_length();
-                midipulse tick_s;
-                midipulse tick_f;
-                int note;
-                bool selected;
-                int velocity;
-                draw_type_t dt;
                 Color drawcolor = fg_color();
                 Color eventcolor = fg_color();
 
@@ -492,18 +490,13 @@ mainwid::draw_sequence_on_pixmap (int seqnum)
                 }
 #endif
 
-                seq->reset_draw_marker();       /* reset container iterator */
-                do
+                std::vector<note_summary_item>::const_iterator ni;
+                for (ni = ns->ns_items.begin(); ni != ns->ns_items.end(); ++ni)
                 {
-                    dt = seq->get_next_note_event   /* side-effects */
-                    (
-                        tick_s, tick_f, note, selected, velocity
-                    );
-                    if (dt == DRAW_FIN)
-                        break;
-
-                    int tick_s_x = tick_s * m_seqarea_seq_x / len;
-                    int tick_f_x = tick_f * m_seqarea_seq_x / len;
+                    draw_type_t dt = ni->nsi_type;
+                    int note = ni->nsi_note;
+                    int tick_s_x = ni->nsi_tick_start * m_seqarea_seq_x / len;
+                    int tick_f_x = ni->nsi_tick_finish * m_seqarea_seq_x / len;
                     int note_y;
                     if (dt == DRAW_TEMPO)
                     {
@@ -529,8 +522,6 @@ mainwid::draw_sequence_on_pixmap (int seqnum)
                     {
                         set_line(Gdk::LINE_SOLID, 2);
                         drawcolor = tempo_paint();
-                        note_y = m_seqarea_seq_y -
-                             m_seqarea_seq_y * (note + 1) / SEQ64_MAX_DATA_VALUE;
                     }
 
                     int sx = rectangle_x + tick_s_x;            /* start x  */
@@ -554,8 +545,7 @@ mainwid::draw_sequence_on_pixmap (int seqnum)
                         set_line(Gdk::LINE_SOLID, 1);
                         drawcolor = eventcolor;
                     }
-
-                } while (dt != DRAW_FIN);
+                }
             }
         }
         else                                            /* sequence inactive */
@@ -105,6 +105,7 @@
 #include "midifile.hpp"
 #include "options.hpp"
 #include "perfedit.hpp"
+#include "statswnd.hpp"
 #include "cmdlineopts.hpp"              /* for build info function          */
 #include "calculations.hpp"             /* pulse_to_measurestring()         */
 
@@ -295,6 +296,7 @@ mainwnd::mainwnd
     m_perf_edit             (new perfedit(p, false /*allowperf2*/, ppqn)),
     m_perf_edit_2           (allowperf2 ? new perfedit(p, true, ppqn) : nullptr),
     m_options               (nullptr),
+    m_stats_wnd             (nullptr),
     m_main_cursor           (),
     m_image_play            (),
     m_button_learn          (manage(new Gtk::Button())),    /* group learn (L) */
@@ -1120,6 +1122,9 @@ mainwnd::~mainwnd ()
     if (not_nullptr(m_options))
         delete m_options;
 
+    if (not_nullptr(m_stats_wnd))
+        delete m_stats_wnd;
+
     /*
      * delete m_tooltips;
      */
@@ -1246,6 +1251,7 @@ mainwnd::timer_callback ()
     midipulse tick = perf().get_tick();         /* use no get_start_tick()! */
     midibpm bpm = perf().get_beats_per_minute();
     update_markers(tick);
+    perf().poll_autosave();                     /* cheap unless it is due   */
     if (m_button_queue->get_active() != perf().is_keep_queue())
         m_button_queue->set_active(perf().is_keep_queue());
 
@@ -1531,6 +1537,20 @@ mainwnd::enregister_perfedits ()
     }
 }
 
+/**
+ *  Opens the View / Timing Statistics window, creating it the first time.
+ */
+
+void
+mainwnd::open_timing_stats ()
+{
+    if (is_nullptr(m_stats_wnd))
+        m_stats_wnd = new statswnd(perf());
+
+    m_stats_wnd->show_all();
+    m_stats_wnd->raise();
+}
+
 /**
  *  Opens the File / Options dialog.
  */
@@ -3382,6 +3402,15 @@ mainwnd::populate_menu_view ()
         );
         enregister_perfedits();
     }
+    m_menu_view->items().push_back(SeparatorElem());
+    m_menu_view->items().push_back
+    (
+        MenuElem
+        (
+            "_Timing Statistics...",
+            mem_fun(*this, &mainwnd::open_timing_stats)
+        )
+    );
 }
 
 /**
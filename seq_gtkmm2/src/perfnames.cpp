@@ -98,6 +98,7 @@ perfnames::perfnames
     m_seqs_in_set           (usr().seqs_in_set()),          /* c_seqs_in_set*/
     m_sequence_max          (c_max_sequence),
     m_sequence_offset       (0),
+    m_dirty_generation      (0),
     m_sequence_active       ()                              /* an array     */
 {
     for (int i = 0; i < m_sequence_max; ++i)
@@ -483,12 +484,18 @@ perfnames::on_size_allocate (Gtk::Allocation & a)
 }
 
 /**
- *  Redraws sequences that have been modified.
+ *  Redraws sequences that have been modified.  If no pattern has been marked
+ *  dirty since the last call, nothing is scanned.
  */
 
 void
 perfnames::redraw_dirty_sequences ()
 {
+    unsigned long generation = perf().dirty_generation();
+    if (generation == m_dirty_generation)
+        return;
+
+    m_dirty_generation = generation;
     int y_f = m_window_y / m_names_y;
     for (int y = 0; y <= y_f; ++y)
     {
@@ -124,6 +124,7 @@ perfroll::perfroll
 #endif
     m_4bar_offset           (0),                            // now a full offset
     m_sequence_offset       (0),
+    m_dirty_generation      (0),
     m_roll_length_ticks     (0),
     m_drop_tick             (0),
     m_drop_tick_trigger_offset (0),
@@ -140,7 +141,8 @@ perfroll::perfroll
     ),
     m_moving                (false),
     m_growing               (false),
-    m_grow_direction        (false)
+    m_grow_direction        (false),
+    m_thumbnails            ()
 {
     set_ppqn(ppqn);                                         // choose_ppqn(ppqn)
     for (int i = 0; i < m_sequence_max; ++i)
@@ -223,6 +225,7 @@ perfroll::change_vert ()
     {
         m_drop_y += (m_sequence_offset - vvalue) * m_names_y;
         m_sequence_offset = vvalue;
+        prune_thumbnails();
         enqueue_draw();
     }
 }
@@ -585,6 +588,12 @@ perfroll::auto_scroll_horz ()
 /**
  *  Draws the given pattern/sequence on the given drawable area.
  *  Statement nesting from hell!
+ *
+ *  Each repetition of the sequence inside a trigger is a copy of the
+ *  pre-rendered thumbnail of the sequence, clipped to the inside of the
+ *  trigger box, and only the repetitions in view are drawn.  So the cost of
+ *  a redraw depends on the visible triggers, not on the number of events.
+ *  A repetition too wide for a thumbnail is drawn from the note summary.
  */
 
 void
@@ -597,10 +606,20 @@ perfroll::draw_sequence_on (int seqnum)
         m_sequence_active[seqnum] = true;
         sequence * seq = perf().get_sequence(seqnum);
         seq->reset_draw_trigger_marker();
+
+        int thumbkey = seqnum;
         seqnum -= m_sequence_offset;
 
         midipulse sequence_length = seq->get_length();
         int length_w = sequence_length / m_perf_scale_x;
+        note_summary_ptr ns = seq->get_note_summary();
+
+#ifdef SEQ64_STAZED_TRANSPOSE
+        bool transposable = seq->get_transposable();
+#else
+        bool transposable = true;
+#endif
+
         midipulse tick_on;
         midipulse tick_off;
         midipulse offset;
@@ -621,37 +640,74 @@ perfroll::draw_sequence_on (int seqnum)
                  * Items drawn:
                  *
                  *  1. Main trigger box
-                 *  2. Trigger outline
-                 *  3. The left hand side of the little sequence grab handle
-                 *  4. Its right side.
+                 *  2. The repetitions and their length markers
+                 *  3. Trigger outline
+                 *  4. The left hand side of the little sequence grab handle
+                 *  5. Its right side.
                  */
 
                 draw_rectangle_on_pixmap
                 (
                     selected ? grey() : white_paint(), x, y, w, h
                 );
-                draw_rectangle_on_pixmap(black_paint(), x, y, w, h, false);
-                draw_rectangle_on_pixmap
-                (
-                    dark_cyan(),                /* try instead of black()   */
-                    x, y, m_size_box_w, m_size_box_w, false
-                );
-                draw_rectangle_on_pixmap        /* color set previous call  */
+
+                Glib::RefPtr<Gdk::Pixmap> thumb = get_thumbnail
                 (
-                    x + w - m_size_box_w, y + h - m_size_box_w,
-                    m_size_box_w, m_size_box_w, false
+                    thumbkey, ns, length_w, h, selected, transposable
                 );
+                int box_l = x + 1;                      /* inside the box   */
+                int box_r = x + w - 1;
+                if (box_l < 0)
+                    box_l = 0;
+
+                if (box_r > window_x())
+                    box_r = window_x();
 
                 midipulse tickmarker =          /* length marker first tick */
                 (
                     tick_on - (tick_on % sequence_length) +
                     (offset % sequence_length) - sequence_length
                 );
+                midipulse lefttick = (box_l + x_offset) * m_perf_scale_x;
+                if (tickmarker + sequence_length < lefttick)
+                {
+                    midipulse skipped = (lefttick - tickmarker) /
+                        sequence_length - 1;
+
+                    tickmarker += skipped * sequence_length;
+                }
                 while (tickmarker < tick_off)
                 {
-                    midipulse tickmarker_x =
+                    int tickmarker_x =
                         (tickmarker / m_perf_scale_x) - x_offset;
 
+                    if (tickmarker_x > box_r)
+                        break;                  /* the rest is out of view  */
+
+                    int left = tickmarker_x > box_l ? tickmarker_x : box_l ;
+                    int right = tickmarker_x + length_w + 1;
+                    if (right > box_r)
+                        right = box_r;
+
+                    if (left < right && ns->ns_have_notes)
+                    {
+                        if (thumb)
+                        {
+                            m_pixmap->draw_drawable
+                            (
+                                m_gc, thumb, left - tickmarker_x, 1,
+                                left, y + 1, right - left, h - 1
+                            );
+                        }
+                        else
+                        {
+                            draw_note_summary
+                            (
+                                m_pixmap, *ns, transposable,
+                                tickmarker_x, y, length_w, left, right
+                            );
+                        }
+                    }
                     if (tickmarker > tick_on)
                     {
                         draw_rectangle
@@ -659,119 +715,216 @@ perfroll::draw_sequence_on (int seqnum)
                             m_pixmap, light_grey(), tickmarker_x, y + 4, 1, h - 8
                         );
                     }
+                    tickmarker += sequence_length;
+                }
+                draw_rectangle_on_pixmap(black_paint(), x, y, w, h, false);
+                draw_rectangle_on_pixmap
+                (
+                    dark_cyan(),                /* try instead of black()   */
+                    x, y, m_size_box_w, m_size_box_w, false
+                );
+                draw_rectangle_on_pixmap        /* color set previous call  */
+                (
+                    x + w - m_size_box_w, y + h - m_size_box_w,
+                    m_size_box_w, m_size_box_w, false
+                );
+            }
+        }
+    }
+    else
+        m_thumbnails.erase(seqnum);
+}
 
-                    int low_note;                       // for side-effect
-                    int high_note;                      // ditto
-                    bool have_notes = seq->get_minmax_note_events
-                    (
-                        low_note, high_note             // side-effects
-                    );
-                    if (have_notes)
-                    {
-                        int height = high_note - low_note + 2;
-                        int length = seq->get_length();
-                        midipulse tick_s;
-                        midipulse tick_f;
-                        int note;
-                        bool selected;
-                        int velocity;
-                        draw_type_t dt;
+/**
+ *  Gets the thumbnail of a sequence, drawing it first if the sequence, the
+ *  zoom, or the trigger background has changed since it was last drawn.
+ *
+ * \param seqnum
+ *      The number of the sequence, used as the key of the thumbnail.
+ *
+ * \param ns
+ *      The current note summary of the sequence.
+ *
+ * \param width
+ *      The width of one repetition of the sequence, in pixels.
+ *
+ * \param height
+ *      The height of the trigger box, in pixels.
+ *
+ * \param selected
+ *      If true, the thumbnail has the background of a selected trigger.
+ *
+ * \param transposable
+ *      If false, the notes are drawn in red instead of black.
+ *
+ * \return
+ *      Returns the thumbnail, or a null pointer if the sequence has no notes
+ *      or the repetition is wider than SEQ64_THUMBNAIL_MAX_X.
+ */
 
-#ifdef SEQ64_STAZED_TRANSPOSE
+Glib::RefPtr<Gdk::Pixmap>
+perfroll::get_thumbnail
+(
+    int seqnum, const note_summary_ptr & ns,
+    int width, int height, bool selected, bool transposable
+)
+{
+    Glib::RefPtr<Gdk::Pixmap> result;
+    bool drawable = width > 0 && width <= SEQ64_THUMBNAIL_MAX_X && height > 0;
+    if (drawable && ns->ns_have_notes && m_window)
+    {
+        thumbnail & th = m_thumbnails[seqnum];
+        if
+        (
+            th.th_summary != ns || th.th_width != width ||
+            th.th_height != height || th.th_transposable != transposable
+        )
+        {
+            th.th_summary = ns;
+            th.th_width = width;
+            th.th_height = height;
+            th.th_transposable = transposable;
+            th.th_pixmap[0].clear();
+            th.th_pixmap[1].clear();
+        }
 
-                        /*
-                         * If a pattern is not transposable, draw it in red
-                         * instead of black.
-                         */
+        int which = selected ? 1 : 0 ;
+        if (! th.th_pixmap[which])
+        {
+            Glib::RefPtr<Gdk::Pixmap> pixmap =
+                Gdk::Pixmap::create(m_window, width + 1, height, -1);
+
+            draw_rectangle
+            (
+                pixmap, selected ? grey() : white_paint(),
+                0, 0, width + 1, height
+            );
+            draw_note_summary
+            (
+                pixmap, *ns, transposable, 0, 0, width, 0, width + 1
+            );
+            th.th_pixmap[which] = pixmap;
+        }
+        result = th.th_pixmap[which];
+    }
+    return result;
+}
 
-                        bool transposable = seq->get_transposable();
-                        if (transposable)
-                            m_gc->set_foreground(black_paint());
-                        else
-                            m_gc->set_foreground(red());
-#else
-                        bool transposable = false;
-                        m_gc->set_foreground(black_paint());
-#endif
+/**
+ *  Drops the thumbnails of the sequences that are out of view, so that the
+ *  cache holds at most two pixmaps for each visible row, however many
+ *  sequences have been scrolled past.  Called when the view scrolls or
+ *  changes size.
+ */
 
-                        seq->reset_draw_marker();       /* container iterator */
-                        do
-                        {
-                            dt = seq->get_next_note_event   /* side-effects */
-                            (
-                                tick_s, tick_f, note, selected, velocity
-                            );
-                            if (dt == DRAW_FIN)
-                                break;
-
-                            int mny = m_names_y - 6;
-                            int note_y;
-                            if (dt == DRAW_TEMPO)
-                            {
-                                /*
-                                 * Do not to scale by the note range here.
-                                 */
-
-                                note_y =
-                                (
-                                    mny - (mny * note) / SEQ64_MAX_DATA_VALUE
-                                ) + 1;
-                            }
-                            else
-                            {
-                                note_y =
-                                (
-                                    mny - (mny * (note - low_note)) / height
-                                ) + 1;
-                            }
-                            int tick_s_x =
-                                ((tick_s * length_w) / length) + tickmarker_x;
-
-                            int tick_f_x =
-                                ((tick_f * length_w) / length) + tickmarker_x;
-
-                            if (dt == DRAW_NOTE_ON || dt == DRAW_NOTE_OFF)
-                                tick_f_x = tick_s_x + 1;
-
-                            if (tick_f_x <= tick_s_x)
-                                tick_f_x = tick_s_x + 1;
-
-                            if (tick_s_x < x)
-                                tick_s_x = x;
-
-                            if (tick_f_x > x + w)
-                                tick_f_x = x + w;
-
-                            if (tick_f_x >= x && tick_s_x <= x + w)
-                            {
-                                int ny = y + note_y;
-                                Color paint = transposable ? black() : red();
-                                if (dt == DRAW_TEMPO)
-                                {
-                                    set_line(Gdk::LINE_SOLID, 2);
-                                    paint = tempo_paint();
-                                }
-                                draw_line_on_pixmap
-                                (
-                                    paint, tick_s_x, ny, tick_f_x, ny
-                                );
-                                if (dt == DRAW_TEMPO)
-                                {
-                                    /*
-                                     * We would like to also draw a line from
-                                     * the end of the current tempo to the
-                                     * start of the next one.  But we
-                                     * currently have only the x value of the
-                                     * next tempo.
-                                     */
-
-                                    set_line(Gdk::LINE_SOLID, 1);
-                                }
-                            }
-                        } while (dt != DRAW_FIN);
-                    }
-                    tickmarker += sequence_length;
-                }
+void
+perfroll::prune_thumbnails ()
+{
+    int first = m_sequence_offset;
+    int last = m_sequence_offset + m_window_y / m_names_y;
+    std::map<int, thumbnail>::iterator t = m_thumbnails.begin();
+    while (t != m_thumbnails.end())
+    {
+        if (t->first < first || t->first > last)
+            m_thumbnails.erase(t++);
+        else
+            ++t;
+    }
+}
+
+/**
+ *  Draws the note and tempo lines of one repetition of a sequence, scaled
+ *  to the height of a trigger box.
+ *
+ * \param pixmap
+ *      The pixmap to draw on.
+ *
+ * \param ns
+ *      The note summary of the sequence.
+ *
+ * \param transposable
+ *      If false, the notes are drawn in red instead of black.
+ *
+ * \param x0
+ *      The x coordinate of the start of the repetition.
+ *
+ * \param y0
+ *      The y coordinate of the top of the trigger box.
+ *
+ * \param width
+ *      The width of the repetition.
+ *
+ * \param xmin
+ *      The leftmost x coordinate to draw on.
+ *
+ * \param xmax
+ *      The rightmost x coordinate to draw on.
+ */
+
+void
+perfroll::draw_note_summary
+(
+    Glib::RefPtr<Gdk::Pixmap> & pixmap, const note_summary & ns,
+    bool transposable, int x0, int y0, int width, int xmin, int xmax
+)
+{
+    midipulse length = ns.ns_length;
+    if (length <= 0)
+        return;
+
+    int low_note = ns.ns_low_note;
+    int height = ns.ns_high_note - low_note + 2;
+    int mny = m_names_y - 6;
+    std::vector<note_summary_item>::const_iterator ni;
+    for (ni = ns.ns_items.begin(); ni != ns.ns_items.end(); ++ni)
+    {
+        draw_type_t dt = ni->nsi_type;
+        int note = ni->nsi_note;
+        int note_y;
+        if (dt == DRAW_TEMPO)
+        {
+            /*
+             * Do not to scale by the note range here.
+             */
+
+            note_y = (mny - (mny * note) / SEQ64_MAX_DATA_VALUE) + 1;
+        }
+        else
+            note_y = (mny - (mny * (note - low_note)) / height) + 1;
+
+        int tick_s_x = ((ni->nsi_tick_start * width) / length) + x0;
+        int tick_f_x = ((ni->nsi_tick_finish * width) / length) + x0;
+        if (dt == DRAW_NOTE_ON || dt == DRAW_NOTE_OFF)
+            tick_f_x = tick_s_x + 1;
+
+        if (tick_f_x <= tick_s_x)
+            tick_f_x = tick_s_x + 1;
+
+        if (tick_s_x < xmin)
+            tick_s_x = xmin;
+
+        if (tick_f_x > xmax)
+            tick_f_x = xmax;
+
+        if (tick_f_x >= xmin && tick_s_x <= xmax)
+        {
+            int ny = y0 + note_y;
+            Color paint = transposable ? black() : red();
+            if (dt == DRAW_TEMPO)
+            {
+                set_line(Gdk::LINE_SOLID, 2);
+                paint = tempo_paint();
+            }
+            draw_line(pixmap, paint, tick_s_x, ny, tick_f_x, ny);
+            if (dt == DRAW_TEMPO)
+            {
+                /*
+                 * We would like to also draw a line from the end of the
+                 * current tempo to the start of the next one.  But we
+                 * currently have only the x value of the next tempo.
+                 */
+
+                set_line(Gdk::LINE_SOLID, 1);
             }
         }
     }
@@ -805,7 +958,8 @@ void perfroll::draw_background_on (int seqnum)
 }
 
 /**
- *  Redraws patterns/sequences that have been modified.
+ *  Redraws patterns/sequences that have been modified.  If no pattern has
+ *  been marked dirty since the last call, nothing is scanned.
  *
  * \change ca 2016-05-30
  *      Lets try not drawing sequences greater than the maximum, at all.
@@ -814,6 +968,11 @@ void perfroll::draw_background_on (int seqnum)
 void
 perfroll::redraw_dirty_sequences ()
 {
+    unsigned long generation = perf().dirty_generation();
+    if (generation == m_dirty_generation)
+        return;
+
+    m_dirty_generation = generation;
     bool draw = false;
     int yf = m_window_y / m_names_y;
     for (int y = 0; y <= yf; ++y)
@@ -1459,6 +1618,7 @@ perfroll::on_size_allocate (Gtk::Allocation & a)
     m_window_x = a.get_width();             /* side-effect  */
     m_window_y = a.get_height();            /* side-effect  */
     update_sizes();
+    prune_thumbnails();
 }
 
 }           // namespace seq64
@@ -256,10 +256,11 @@ seqdata::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
     {
 #endif
 
-        event_list::const_iterator ev;
-        m_seq.reset_ex_iterator(ev);
-        while (m_seq.get_next_event_ex(m_status, m_cc, ev))
+        event_snapshot_ptr es = m_seq.get_event_snapshot();  /* no lock  */
+        int index = 0;
+        while (es->next_event(index, m_status, m_cc))
         {
+            const event * ev = &es->get_event(index);
             midipulse tick = ev->get_timestamp();
             bool selected = ev->is_selected();
             if (tick >= starttick && tick <= endtick)
@@ -280,7 +281,7 @@ seqdata::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
                      * forget to increment the iterator now!
                      */
 
-                    ++ev;                           /* now a must-do        */
+                    ++index;                        /* now a must-do        */
                     continue;
                 }
                 else
@@ -336,7 +337,7 @@ seqdata::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
                     );
                 }
             }
-            ++ev;                                   /* now a must-do        */
+            ++index;                                /* now a must-do        */
         }
 #ifdef USE_STAZED_SEQDATA_EXTENSIONS
         if (seltype == EVENTS_UNSELECTED)
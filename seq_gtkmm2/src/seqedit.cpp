@@ -1750,9 +1750,13 @@ seqedit::popup_event_menu ()
     int bus = m_seq.get_midi_bus();
     int channel = m_seq.get_midi_channel();
     memset(ccs, false, sizeof(bool) * SEQ64_MIDI_COUNT_MAX);
-    m_seq.reset_draw_marker();
-    while (m_seq.get_next_event(status, cc))      /* used only here!  */
+    event_snapshot_ptr es = m_seq.get_event_snapshot();
+    for (int index = 0; index < es->count(); ++index)
     {
+        midibyte d1;
+        const event & ev = es->get_event(index);
+        status = ev.get_status();
+        ev.get_data(cc, d1);
         switch (status)
         {
         case EVENT_NOTE_OFF:
@@ -344,9 +344,8 @@ seqevent::update_pixmap ()
  *  Draws events on the given drawable object.  Very similar to
  *  seqdata::draw_events_on().
  *
- *  This function exercises the new version of get_nexxt_event(),
- *  get_next_event_ex(), which allows (and forces) the caller to provide the
- *  event iterator.
+ *  The events come from a read-only snapshot of the sequence, which is
+ *  iterated with our own index and without holding the sequence lock.
  *
  * \param drawable
  *      The given drawable object.
@@ -357,11 +356,12 @@ seqevent::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
 {
     int starttick = m_scroll_offset_ticks;
     int endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
-    event_list::const_iterator ev;
-    m_seq.reset_ex_iterator(ev);
+    event_snapshot_ptr es = m_seq.get_event_snapshot();
+    int index = 0;
     m_gc->set_foreground(black_paint());
-    while (m_seq.get_next_event_ex(m_status, m_cc, ev))
+    while (es->next_event(index, m_status, m_cc))
     {
+        const event * ev = &es->get_event(index);
         midipulse tick = ev->get_timestamp();
         bool selected = ev->is_selected();
         if (tick >= starttick && tick <= endtick)
@@ -378,7 +378,7 @@ seqevent::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
                 x, c_eventpadding_y+1, c_eventevent_x-3, c_eventevent_y-3
             );
         }
-        ++ev;                                           /* now a must-do    */
+        ++index;                                        /* now a must-do    */
     }
 }
 
@@ -813,11 +813,12 @@ seqroll::draw_events_on (Glib::RefPtr<Gdk::Drawable> draw)
             seq = &m_seq;
 
         m_gc->set_foreground(black_paint());    /* draw boxes from sequence */
-        seq->reset_draw_marker();
+        event_snapshot_ptr es = seq->get_event_snapshot();  /* no lock held */
+        int index = 0;
         while
         (
             (
-                dt = seq->get_next_note_event(tick_s, tick_f,
+                dt = es->next_note_event(index, tick_s, tick_f,
                    note, selected, velocity)
             ) != DRAW_FIN
         )
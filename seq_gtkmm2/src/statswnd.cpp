@@ -0,0 +1,208 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          statswnd.cpp
+ *
+ *  This module defines the window that shows the timing statistics of the
+ *  output thread.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Each metric gets a row with its count, average, maximum, and estimated
+ *  50th and 99th percentiles.  The percentiles come from the power-of-two
+ *  histograms of seq64::perfstats, so they are upper bounds, accurate to a
+ *  factor of two.
+ */
+
+#include <stdio.h>                      /* snprintf()                       */
+#include <sigc++/slot.h>
+#include <glibmm/main.h>                /* Glib::signal_timeout()           */
+#include <gtkmm/box.h>
+#include <gtkmm/button.h>
+#include <gtkmm/label.h>
+#include <gtkmm/table.h>
+
+#include "perform.hpp"                  /* seq64::perform::get_output_stats */
+#include "statswnd.hpp"
+
+/**
+ *  The refresh period of the window, in milliseconds.
+ */
+
+#define SEQ64_STATS_REFRESH_MS          1000
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The headings of the value columns of the table.
+ */
+
+static const char * const s_column_names[SEQ64_STATS_COLUMNS] =
+{
+    "Count", "Average", "Maximum", "50%", "99%"
+};
+
+/**
+ *  Constructs the statistics window, fills it, and starts its refresh
+ *  timer.
+ *
+ * \param p
+ *      The performance object, which holds the statistics.
+ */
+
+statswnd::statswnd (perform & p)
+ :
+    gui_window_gtk2     (p),
+    m_vbox              (manage(new Gtk::VBox(false, 4))),
+    m_table
+    (
+        manage
+        (
+            new Gtk::Table(perfstats::METRICS + 1, SEQ64_STATS_COLUMNS + 1)
+        )
+    ),
+    m_label_summary     (manage(new Gtk::Label())),
+    m_button_reset      (manage(new Gtk::Button("_Reset", true))),
+    m_values            (),
+    m_timer             ()
+{
+    set_title("Sequencer64 - Timing Statistics");
+    m_table->set_col_spacings(12);
+    m_table->set_row_spacings(2);
+    for (int c = 0; c < SEQ64_STATS_COLUMNS; ++c)
+    {
+        Gtk::Label * heading = manage(new Gtk::Label(s_column_names[c]));
+        m_table->attach(*heading, c + 1, c + 2, 0, 1);
+    }
+    for (int w = 0; w < perfstats::METRICS; ++w)
+    {
+        const char * name = perfstats::name(perfstats::metric_t(w));
+        Gtk::Label * label = manage(new Gtk::Label(name));
+        label->set_alignment(0.0, 0.5);
+        m_table->attach(*label, 0, 1, w + 1, w + 2);
+        for (int c = 0; c < SEQ64_STATS_COLUMNS; ++c)
+        {
+            Gtk::Label * value = manage(new Gtk::Label("0"));
+            value->set_alignment(1.0, 0.5);
+            value->set_width_chars(8);
+            m_table->attach(*value, c + 1, c + 2, w + 1, w + 2);
+            m_values[w][c] = value;
+        }
+    }
+    m_button_reset->set_tooltip_text
+    (
+        "Sets all of the timing statistics back to zero."
+    );
+    m_button_reset->signal_clicked().connect
+    (
+        sigc::mem_fun(*this, &statswnd::reset)
+    );
+
+    Gtk::HBox * hbox = manage(new Gtk::HBox(false, 4));
+    hbox->pack_start(*m_label_summary, true, true, 0);
+    hbox->pack_end(*m_button_reset, false, false, 0);
+    m_vbox->set_border_width(8);
+    m_vbox->pack_start(*m_table, true, true, 0);
+    m_vbox->pack_start(*hbox, false, false, 0);
+    add(*m_vbox);
+
+    refresh();
+    m_timer = Glib::signal_timeout().connect
+    (
+        sigc::mem_fun(*this, &statswnd::refresh), SEQ64_STATS_REFRESH_MS
+    );
+}
+
+/**
+ *  Stops the refresh timer.
+ */
+
+statswnd::~statswnd ()
+{
+    m_timer.disconnect();
+}
+
+/**
+ *  Sets the statistics back to zero, and shows them right away.
+ */
+
+void
+statswnd::reset ()
+{
+    perf().reset_output_stats();
+    refresh();
+}
+
+/**
+ *  Copies the statistics and shows them.  Also the callback of the refresh
+ *  timer.
+ *
+ * \return
+ *      Always returns true, to keep the timer running.
+ */
+
+bool
+statswnd::refresh ()
+{
+    perfstats::snapshot snap;
+    perf().get_output_stats(snap);
+
+    char temp[64];
+    for (int w = 0; w < perfstats::METRICS; ++w)
+    {
+        const stats_values & sv = snap.ss_metrics[w];
+        long long values[SEQ64_STATS_COLUMNS] =
+        {
+            sv.sv_count,
+            perfstats::average(sv),
+            sv.sv_max,
+            perfstats::percentile(sv, 50),
+            perfstats::percentile(sv, 99)
+        };
+        for (int c = 0; c < SEQ64_STATS_COLUMNS; ++c)
+        {
+            snprintf(temp, sizeof temp, "%lld", values[c]);
+            m_values[w][c]->set_text(temp);
+        }
+    }
+    snprintf
+    (
+        temp, sizeof temp, "Elapsed: %ld s   Underruns: %ld",
+        long(snap.ss_elapsed_us / 1000000), snap.ss_underruns
+    );
+    m_label_summary->set_text(temp);
+    return true;
+}
+
+}           /* namespace seq64 */
+
+/*
+ * statswnd.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
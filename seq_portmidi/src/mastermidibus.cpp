@@ -226,6 +226,7 @@ mastermidibus::api_get_midi_event (event * in)
     if (! result)
         return false;
 
+    in->set_timestamp(wakeup_event::now_us());          /* arrival time     */
     in->set_status(Pm_MessageStatus(event.message));
     in->set_sysex_size(3);
     in->set_data(Pm_MessageData1(event.message), Pm_MessageData2(event.message));
@@ -116,6 +116,15 @@ protected:
         m_midi_master.api_flush();
     }
 
+    /**
+     *  Provides the delay added to the output by the selected MIDI API.
+     */
+
+    virtual long api_output_latency_us () const
+    {
+        return m_midi_master.api_output_latency_us();
+    }
+
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port)
     {
         m_midi_master.api_port_start(masterbus, bus, port);
@@ -49,6 +49,7 @@ namespace seq64
     class event;
     class mastermidibus;
     class midibus;
+    class wakeup_event;
 
 /**
  *  A class for holding port information.
@@ -287,6 +288,13 @@ private:
 
     midibpm m_bpm;
 
+    /**
+     *  The wakeup of the master buss's input thread, for the input ports
+     *  to signal when they receive data in a callback.  Can be null.
+     */
+
+    wakeup_event * m_input_wakeup;
+
 protected:
 
     /**
@@ -397,6 +405,24 @@ public:
         return m_bpm;
     }
 
+    /**
+     * \getter m_input_wakeup
+     */
+
+    wakeup_event * input_wakeup () const
+    {
+        return m_input_wakeup;
+    }
+
+    /**
+     * \setter m_input_wakeup
+     */
+
+    void input_wakeup (wakeup_event * wakeup)
+    {
+        m_input_wakeup = wakeup;
+    }
+
     /**
      *  Special setter.
      */
@@ -441,6 +467,16 @@ public:
         return true;
     }
 
+    /**
+     *  Provides the delay that the API adds to every output message.  Used
+     *  only in the midi_jack_info class.
+     */
+
+    virtual long api_output_latency_us () const
+    {
+        return 0;
+    }
+
     /**
      *
      */
@@ -146,6 +146,17 @@ public:
         return m_jack_data.m_jack_port;
     }
 
+    /**
+     * \getter m_jack_data.m_jack_late_count
+     *      The number of output messages that missed their frame in the JACK
+     *      period, and had to be clamped.
+     */
+
+    unsigned long late_count () const
+    {
+        return m_jack_data.m_jack_late_count;
+    }
+
 protected:
 
     /**
@@ -177,6 +188,7 @@ protected:
         const std::string & destportname
     );
     bool register_port (bool input, const std::string & portname);
+    bool send_stamped_message (const char * msg, int nbytes);
 
 protected:
 
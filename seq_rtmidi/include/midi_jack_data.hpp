@@ -13,6 +13,7 @@
  *
  */
 
+#include <atomic>                       /* std::atomic<>                */
 #include <jack/jack.h>
 #include <jack/ringbuffer.h>
 
@@ -25,6 +26,30 @@
 namespace seq64
 {
 
+/**
+ *  Provides the record written to the m_jack_buffsize ring-buffer ahead of
+ *  each message written to the m_jack_buffmessage ring-buffer.  Besides the
+ *  size of the message, it holds the JACK frame time at which the message
+ *  was queued, so that the process callback can place the message at the
+ *  matching frame offset of the next period, instead of at frame 0.
+ */
+
+struct midi_jack_header
+{
+    /**
+     *  The number of bytes in the message.
+     */
+
+    int m_size;
+
+    /**
+     *  The value of jack_frame_time() when the message was queued.
+     */
+
+    jack_nframes_t m_frame;
+
+};          // struct midi_jack_header
+
 /**
  *  Contains the JACK MIDI API data as a kind of scratchpad for this object.
  *  This guy needs a constructor taking parameters for an rtmidi_in_data
@@ -53,8 +78,9 @@ struct midi_jack_data
     jack_port_t * m_jack_port;
 
     /**
-     *  Holds the size of data for communicating between the client
-     *  ring-buffer and the JACK port's internal buffer.
+     *  Holds the size and frame time (a midi_jack_header) of data for
+     *  communicating between the client ring-buffer and the JACK port's
+     *  internal buffer.
      */
 
     jack_ringbuffer_t * m_jack_buffsize;
@@ -80,6 +106,15 @@ struct midi_jack_data
 
     rtmidi_in_data * m_jack_rtmidiin;
 
+    /**
+     *  Counts the output messages that arrived too late for their intended
+     *  frame offset (e.g. after an xrun or a stalled output thread), and were
+     *  clamped to the earliest offset still available in the period.
+     *  Incremented only by the JACK process callback.
+     */
+
+    std::atomic<unsigned long> m_jack_late_count;
+
     /**
      * \ctor midi_jack_data
      */
@@ -90,7 +125,8 @@ struct midi_jack_data
         m_jack_buffsize     (nullptr),
         m_jack_buffmessage  (nullptr),
         m_jack_lasttime     (0),
-        m_jack_rtmidiin     (nullptr)
+        m_jack_rtmidiin     (nullptr),
+        m_jack_late_count   (0)
     {
         // Empty body
     }
@@ -127,6 +127,7 @@ public:
     virtual void api_set_beats_per_minute (midibpm b);
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port);
     virtual void api_flush ();
+    virtual long api_output_latency_us () const;
 
 private:
 
@@ -144,6 +144,15 @@ public:
         get_api_info()->add_bus(m);
     }
 
+    /**
+     *  Sets the wakeup that the input ports signal when they receive data.
+     */
+
+    void input_wakeup (wakeup_event * wakeup)
+    {
+        get_api_info()->input_wakeup(wakeup);
+    }
+
     /**
      *  Gets the buss/client ID for a MIDI interfaces.  This is the left-hand
      *  side of a X:Y pair (such as 128:0).
@@ -247,6 +256,11 @@ public:
         get_api_info()->api_port_start(masterbus, bus, port);
     }
 
+    long api_output_latency_us () const
+    {
+        return get_api_info()->api_output_latency_us();
+    }
+
     /*
      * There is no need for a corresponding port-exit function, because
      * the functionality in it is not API-specific.
@@ -16,10 +16,12 @@
  *  refactor and partition, and slightly easier to read.
  */
 
+#include <atomic>                           /* std::atomic<> counters       */
 #include <string>                           /* std::string                  */
 #include <vector>                           /* std::vector container        */
 
 #include "midibyte.hpp"                     /* seq64::midibyte typedef      */
+#include "ringbuffer.hpp"                   /* seq64::ringbuffer<> template */
 
 /**
  * This was the version of the RtMidi library from which this reimplementation
@@ -69,10 +71,27 @@
 #define SEQ64_NO_INDEX          (-1)        /* good values start at 0       */
 
 /**
- *  Default size of the MIDI queue.
+ *  Default size of the MIDI queue, in messages.  The queue is filled by the
+ *  JACK process callback and emptied by the input thread; it must absorb the
+ *  messages of a dense controller stream arriving between two polls.
  */
 
-#define SEQ64_DEFAULT_QUEUE_SIZE    100
+#define SEQ64_DEFAULT_QUEUE_SIZE    1024
+
+/**
+ *  Default size of the SysEx overflow area of the MIDI queue, in bytes.
+ *  Messages too long to be stored inline in the queue have their bytes
+ *  stored here.
+ */
+
+#define SEQ64_DEFAULT_SYSEX_QUEUE_SIZE  65536
+
+/**
+ *  The number of bytes a midi_message stores without allocating memory.
+ *  Every channel message, and every system message except SysEx, fits.
+ */
+
+#define SEQ64_MIDI_SHORT_MESSAGE    4
 
 /*
  * Do not document the namespace; it breaks Doxygen.
@@ -80,6 +99,7 @@
 
 namespace seq64
 {
+    class wakeup_event;
 
 /**
  *    MIDI API specifier arguments.  These items used to be nested in
@@ -118,6 +138,10 @@ enum rtmidi_api
  *  uses the seq64::event rather than the seq64::midi_message object.
  *  For the moment, we will translate between them until we have the
  *  interactions between the old and new modules under control.
+ *
+ *  Short messages are stored inline, so that building one never allocates
+ *  memory, which matters in the JACK process callback.  Only a message
+ *  longer than SEQ64_MIDI_SHORT_MESSAGE bytes (i.e. SysEx) uses the vector.
  */
 
 class midi_message
@@ -137,11 +161,23 @@ public:
 private:
 
     /**
-     *  Holds the event status and data bytes.
+     *  Holds the event status and data bytes of a short message.
+     */
+
+    midibyte m_short[SEQ64_MIDI_SHORT_MESSAGE];
+
+    /**
+     *  Holds all of the bytes of a long message.  Empty for a short message.
      */
 
     container m_bytes;
 
+    /**
+     *  The number of bytes in the message.
+     */
+
+    int m_count;
+
     /**
      *  Holds the (optional) timestamp of the MIDI message.
      */
@@ -154,42 +190,51 @@ public:
 
     midibyte operator [] (int i) const
     {
-        return (i >= 0 && i < int(m_bytes.size())) ? m_bytes[i] : 0 ;
+        return (i >= 0 && i < m_count) ? data()[i] : 0 ;
     }
 
 #ifdef USE_MIDI_MESSAGE_AT_ACCESS
 
     midibyte & at (int i)
     {
-        return m_bytes.at(i);       /* can throw an exception */
+        return m_count > SEQ64_MIDI_SHORT_MESSAGE ?
+            m_bytes.at(i) : m_short[i] ;    /* long one can throw exception */
     }
 
     const midibyte & at (int i) const
     {
-        return m_bytes.at(i);       /* can throw an exception */
+        return m_count > SEQ64_MIDI_SHORT_MESSAGE ?
+            m_bytes.at(i) : m_short[i] ;    /* long one can throw exception */
     }
 
 #endif
 
+    /**
+     * \getter m_short or m_bytes, whichever holds the message
+     */
+
+    const midibyte * data () const
+    {
+        return m_count > SEQ64_MIDI_SHORT_MESSAGE ? &m_bytes[0] : m_short ;
+    }
+
     const char * array () const
     {
-        return reinterpret_cast<const char *>(&m_bytes[0]);
+        return reinterpret_cast<const char *>(data());
     }
 
     int count () const
     {
-        return int(m_bytes.size());
+        return m_count;
     }
 
     bool empty () const
     {
-        return m_bytes.empty();
+        return m_count == 0;
     }
 
-    void push (midibyte b)
-    {
-        m_bytes.push_back(b);
-    }
+    void push (midibyte b);
+    void clear ();
 
     double timestamp () const
     {
@@ -217,9 +262,16 @@ typedef void (* rtmidi_callback_t)
 );
 
 /**
- *  Provides a queue of midi_message structures.  This entity used to be a
- *  plain structure nested in the midi_in_api class.  We made it a class to
+ *  Provides a queue of MIDI messages.  This entity used to be a plain
+ *  structure nested in the midi_in_api class.  We made it a class to
  *  encapsulate some common operations to save a burden on the callers.
+ *
+ *  The queue is a wait-free single-producer/single-consumer ring:  add() is
+ *  called only by the JACK process callback, and pop_front() only by the
+ *  input thread.  All memory is allocated by the constructor.  Each slot
+ *  stores a short message inline; the bytes of a longer message (SysEx) go
+ *  to a separate ring of bytes, in the same order.  A message that does not
+ *  fit is dropped and counted, rather than blocking the callback.
  */
 
 class midi_queue
@@ -227,60 +279,113 @@ class midi_queue
 
 private:
 
-    unsigned m_front;
-    unsigned m_back;
-    unsigned m_size;
-    unsigned m_ring_size;
-    midi_message * m_ring;
+    /**
+     *  One slot of the queue.  The bytes of a message longer than
+     *  SEQ64_MIDI_SHORT_MESSAGE are not in qm_bytes, but in m_sysex.
+     */
+
+    typedef struct
+    {
+        double qm_timestamp;                        /**< Message timestamp. */
+        int qm_count;                               /**< Message size.      */
+        midibyte qm_bytes[SEQ64_MIDI_SHORT_MESSAGE];  /**< Short message.   */
+
+    } queued_message;
+
+    /**
+     *  The ring of messages.
+     */
+
+    ringbuffer<queued_message> m_ring;
+
+    /**
+     *  The ring of the bytes of long messages.
+     */
+
+    ringbuffer<midibyte> m_sysex;
+
+    /**
+     *  The number of short messages dropped because the queue was full.
+     *  Written only by the producer.
+     */
+
+    std::atomic<unsigned> m_dropped;
+
+    /**
+     *  The number of long messages dropped because the queue or the SysEx
+     *  area was full.  Written only by the producer.
+     */
+
+    std::atomic<unsigned> m_dropped_sysex;
+
+private:        // do not allow these functions to be used
+
+    midi_queue (const midi_queue &);
+    midi_queue & operator = (const midi_queue &);
 
 public:
 
-    midi_queue ();
-    ~midi_queue ();
+    midi_queue
+    (
+        unsigned queuesize = SEQ64_DEFAULT_QUEUE_SIZE,
+        unsigned sysexsize = SEQ64_DEFAULT_SYSEX_QUEUE_SIZE
+    );
 
     /**
-     * \getter m_size == 0
+     *  Checks for messages to read.  Meant for the consumer.
      */
 
     bool empty () const
     {
-        return m_size == 0;
+        return m_ring.empty();
     }
 
     /**
-     * \getter m_size == 0
+     *  Counts the messages to read.  Meant for the consumer.
      */
 
     int count () const
     {
-        return int(m_size);
+        return int(m_ring.count());
     }
 
     /**
-     * \return
-     *      Returns true if the queue size is at maximum.
+     * \getter m_dropped
      */
 
-    bool full () const
+    unsigned dropped () const
     {
-        return m_size == m_ring_size;
+        return m_dropped.load(std::memory_order_relaxed);
     }
 
-    bool add (const midi_message & mmsg);
-    void pop ();
-    midi_message pop_front ();
-    void allocate (unsigned queuesize = SEQ64_DEFAULT_QUEUE_SIZE);
-    void deallocate ();
+    /**
+     * \getter m_dropped_sysex
+     */
+
+    unsigned dropped_sysex () const
+    {
+        return m_dropped_sysex.load(std::memory_order_relaxed);
+    }
+
+    bool add (const midibyte * bytes, int count, double timestamp);
 
     /**
-     * \getter m_ring[m_front]
+     *  Adds a copy of a midi_message.  Called only by the producer.
+     *
+     * \param mmsg
+     *      The message to be queued.
+     *
+     * \return
+     *      Returns false if the message was dropped.
      */
 
-    const midi_message & front () const
+    bool add (const midi_message & mmsg)
     {
-        return m_ring[m_front];
+        return add(mmsg.data(), mmsg.count(), mmsg.timestamp());
     }
 
+    bool pop_front (midi_message & mmsg);
+
 };
 
 /**
@@ -304,6 +409,7 @@ private:
     rtmidi_callback_t m_user_callback;
     void * m_user_data;
     bool m_continue_sysex;
+    wakeup_event * m_wakeup;
 
 public:
 
@@ -442,6 +548,26 @@ public:
         m_user_data = dataptr;
     }
 
+    /**
+     * \getter m_wakeup
+     *      The wakeup to signal when messages are added to the queue, or
+     *      null.
+     */
+
+    wakeup_event * wakeup () const
+    {
+        return m_wakeup;
+    }
+
+    /**
+     * \setter m_wakeup
+     */
+
+    void wakeup (wakeup_event * w)
+    {
+        m_wakeup = w;
+    }
+
     /**
      * \getter m_user_callback
      */
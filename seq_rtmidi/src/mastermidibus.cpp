@@ -72,7 +72,7 @@ mastermidibus::mastermidibus (int ppqn, midibpm bpm)
     ),
     m_use_jack_polling  (rc().with_jack_midi())
 {
-    // Empty body
+    m_midi_master.input_wakeup(&m_input_wakeup);
 }
 
 /**
@@ -267,6 +267,11 @@ mastermidibus::activate ()
  *  primitive poll, which exits when some data is obtained.
  *
  *          m_midi_master.api_poll_for_midi();       // NON-FUNCTIONAL!
+ *
+ *  With JACK, if no input bus has data, this function blocks on the input
+ *  wakeup, which the JACK input callback signals as soon as it has queued
+ *  data, rather than sleeping for a fixed time.  Like the ALSA poll(), it
+ *  times out after SEQ64_INPUT_WAIT_MS, so that the input thread can exit.
  */
 
 int
@@ -274,18 +279,13 @@ mastermidibus::api_poll_for_midi ()
 {
     if (m_use_jack_polling)
     {
-        for (;;)
-        {
-            if (m_inbus_array.poll_for_midi())
-            {
-                return 1;
-            }
-            else
-            {
-                millisleep(1);
-                return 0;
-            }
-        }
+        if (m_inbus_array.poll_for_midi())
+            return 1;
+
+        if (m_input_wakeup.wait(SEQ64_INPUT_WAIT_MS))
+            return m_inbus_array.poll_for_midi() ? 1 : 0 ;
+
+        return 0;
     }
     else
         return m_midi_master.api_poll_for_midi();
@@ -86,6 +86,7 @@
  */
 
 #include "globals.h"
+#include "alsa_event.hpp"               /* seq64::encode_channel_event()    */
 #include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
 #include "event.hpp"                    /* seq64::event (MIDI event)        */
 #include "midibus_rm.hpp"               /* seq64::midibus for rtmidi        */
@@ -547,7 +548,8 @@ midi_alsa::api_poll_for_midi ()
  *  This play() function takes a native event, encodes it to an ALSA MIDI
  *  sequencer event, sets the broadcasting to the subscribers, sets the
  *  direct-passing mode to send the event without queueing, and puts it in the
- *  queue.
+ *  queue.  Channel messages are encoded by encode_channel_event(); only
+ *  other messages go through an ALSA MIDI event parser.
  *
  * \threadsafe
  *
@@ -567,13 +569,15 @@ midi_alsa::api_play (event * e24, midibyte channel)
     buffer[0] += (channel & 0x0F);
     e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
 
-    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
-    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
-
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);                          /* clear event          */
-    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
-    snd_midi_event_free(midi_ev);                   /* free the parser      */
+    if (! encode_channel_event(buffer, ev))         /* fast path failed     */
+    {
+        snd_midi_event_t * midi_ev;                 /* ALSA MIDI parser     */
+        snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
+        snd_midi_event_encode(midi_ev, buffer, 3, &ev);
+        snd_midi_event_free(midi_ev);               /* free the parser      */
+    }
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
 
 #ifdef SEQ64_SHOW_API_CALLS_XXX                     /* Too Much Information */
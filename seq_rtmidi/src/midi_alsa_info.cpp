@@ -557,7 +557,7 @@ midi_alsa_info::api_get_midi_event (event * inev)
         return false;
     }
 
-    inev->set_timestamp(ev->time.tick);
+    inev->set_timestamp(wakeup_event::now_us());    /* arrival time     */
     inev->set_status_keep_channel(buffer[0]);
 
     /**
@@ -144,6 +144,7 @@
 #include "jack_assistant.hpp"           /* seq64::jack_status_pair_t        */
 #include "midibus_rm.hpp"               /* seq64::midibus for rtmidi        */
 #include "midi_jack.hpp"                /* seq64::midi_jack                 */
+#include "mutex.hpp"                    /* seq64::wakeup_event              */
 #include "settings.hpp"                 /* seq64::rc() accessor function    */
 
 /**
@@ -172,17 +173,25 @@ namespace seq64
  *
  *      -#  Get the JACK port buffer and the MIDI event-count into this
  *          buffer.
- *      -#  For each MIDI event, get the event from JACK and push it into a
- *          local midi_message object.
+ *      -#  For each MIDI event, get the event from JACK.
  *      -#  Get the event time, converting it to a delta time if possible.
+ *          For the queue, also get the exact time of the event's frame,
+ *          converted to the wakeup_event::now_us() clock, so that
+ *          recording can place the event at the exact tick.
  *      -#  If it is not a SysEx continuation, then:
- *          -#  If we're using a callback, pass the data to that callback.  Do
+ *          -#  If we're using a callback, push the data into a local
+ *              midi_message object and pass it to that callback.  Do
  *              we need this callback to interface with the midibus-based
  *              code?
- *          -#  Otherwise, add the midi_message container to the rtmidi input
+ *          -#  Otherwise, add the data directly to the rtmidi input
  *              queue.  One can then grab this data in a midibase ::
- *              poll_for_midi() call.  We still ought to check the add
- *              success.
+ *              poll_for_midi() call.  If the queue is full, the message is
+ *              dropped and counted by the queue.
+ *
+ *  Nothing here allocates memory, except the callback path for a SysEx
+ *  message, and the queue is wait-free.  Once all of the events are queued,
+ *  the input thread, which is blocked in the master buss's
+ *  api_poll_for_midi(), is woken.
  *
  *  The ALSA code polls for events, and that model is also available here.
  *  We're still working exactly how it will work best.
@@ -239,39 +248,59 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
         jack_midi_event_t jmevent;
         jack_time_t jtime;
         int evcount = jack_midi_get_event_count(buff);
+        bool queued = false;
         for (int j = 0; j < evcount; ++j)
         {
-            midi_message message;
             int rc = jack_midi_event_get(&jmevent, buff, j);
             if (rc == 0)
             {
                 int eventsize = int(jmevent.size);
-                for (int i = 0; i < eventsize; ++i)
-                    message.push(jmevent.buffer[i]);
-
+                double timestamp = 0.0;
                 jtime = jack_get_time();            /* compute delta time   */
                 if (rtindata->first_message())
-                {
                     rtindata->first_message(false);
-                }
                 else
-                {
-                    message.timestamp
-                    (
-                        (jtime - jackdata->m_jack_lasttime) * 0.000001
-                    );
-                }
+                    timestamp = (jtime - jackdata->m_jack_lasttime) * 0.000001;
+
                 jackdata->m_jack_lasttime = jtime;
                 if (! rtindata->continue_sysex())
                 {
                     if (rtindata->using_callback())
                     {
+                        midi_message message;
+                        for (int i = 0; i < eventsize; ++i)
+                            message.push(jmevent.buffer[i]);
+
+                        message.timestamp(timestamp);
                         rtmidi_callback_t callback = rtindata->user_callback();
                         callback(message, rtindata->user_data());
                     }
                     else
                     {
-                        (void) rtindata->queue().add(message);
+                        /*
+                         * The frame time can be in the future of
+                         * jack_get_time(), so compute the offset signed.
+                         */
+
+                        jack_time_t ftime = jack_frames_to_time
+                        (
+                            jackdata->m_jack_client,
+                            jack_last_frame_time(jackdata->m_jack_client) +
+                                jmevent.time
+                        );
+                        std::int64_t arrival = wakeup_event::now_us() -
+                            (std::int64_t(jtime) - std::int64_t(ftime));
+
+                        if
+                        (
+                            rtindata->queue().add
+                            (
+                                jmevent.buffer, eventsize, double(arrival)
+                            )
+                        )
+                        {
+                            queued = true;
+                        }
                     }
                 }
             }
@@ -287,6 +316,8 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                 }
             }
         }
+        if (queued && not_nullptr(rtindata->wakeup()))
+            rtindata->wakeup()->signal();           /* wake input thread    */
     }
     return 0;
 }
@@ -316,6 +347,15 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
  *  wrap out process in a for-loop over the number of frames.  In our tests,
  *  we are getting 1024 frames, and the code seems to work without that loop.
  *
+ *  Each message is preceded by a midi_jack_header holding its size and the
+ *  JACK frame time at which it was queued.  Rather than putting every
+ *  message at frame 0 of the period (which quantizes all output to the
+ *  period size), each message is reserved at its queuing frame, delayed by
+ *  one period.  Messages queued during the current period are left in the
+ *  ring-buffer for the next one.  Messages that are too late for their frame
+ *  are clamped to the earliest usable offset, and counted in
+ *  midi_jack_data::m_jack_late_count.
+ *
  * \param nframes
  *    The frame number to be processed.
  *
@@ -350,7 +390,6 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
         return 0;
     }
 
-    static size_t soffset = 0;
     void * buf = jack_port_get_buffer(jackdata->m_jack_port, nframes);
 
 #ifdef SEQ64_SHOW_API_CALLS_TMI
@@ -364,28 +403,59 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
     jack_midi_clear_buffer(buf);
 
     /*
-     * A for-loop over the number of nframes?  See discussion above.
+     * Messages were stamped with jack_frame_time() by the thread that queued
+     * them, i.e. during the previous period.  Playing them one period later
+     * preserves their spacing.  The signed difference copes with the
+     * wraparound of the frame counter.
      */
 
-    while (jack_ringbuffer_read_space(jackdata->m_jack_buffsize) > 0)
+    jack_nframes_t cyclestart = is_nullptr(jackdata->m_jack_client) ?
+        0 : jack_last_frame_time(jackdata->m_jack_client) ;
+
+    jack_nframes_t lastoffset = 0;
+    midi_jack_header header;
+    while
+    (
+        jack_ringbuffer_read_space(jackdata->m_jack_buffsize) >= sizeof header
+    )
     {
-        int space;
-        (void) jack_ringbuffer_read
+        (void) jack_ringbuffer_peek
         (
-            jackdata->m_jack_buffsize, (char *) &space, sizeof space
+            jackdata->m_jack_buffsize, (char *) &header, sizeof header
         );
-        jack_midi_data_t * md = jack_midi_event_reserve(buf, soffset, space);
+
+        jack_nframes_t offset = 0;
+        if (not_nullptr(jackdata->m_jack_client))
+        {
+            int32_t delta = int32_t(header.m_frame + nframes - cyclestart);
+            if (delta >= int32_t(nframes))
+                break;                          /* due in a later period    */
+
+            if (delta < int32_t(lastoffset))
+            {
+                if (delta < 0)
+                    ++jackdata->m_jack_late_count;
+
+                delta = int32_t(lastoffset);    /* JACK needs sorted events */
+            }
+            offset = jack_nframes_t(delta);
+        }
+        jack_ringbuffer_read_advance(jackdata->m_jack_buffsize, sizeof header);
+
+        size_t space = size_t(header.m_size);
+        jack_midi_data_t * md = jack_midi_event_reserve(buf, offset, space);
         if (not_nullptr(md))
         {
             char * mididata = reinterpret_cast<char *>(md);
             (void) jack_ringbuffer_read         /* copy into mididata */
             (
-                jackdata->m_jack_buffmessage, mididata, size_t(space)
+                jackdata->m_jack_buffmessage, mididata, space
             );
+            lastoffset = offset;
 
 #ifdef SEQ64_SHOW_API_CALLS_TMI
-            printf("%d bytes read: ", space);
-            for (int i = 0; i < space; ++i)
+            printf("%d bytes read at frame %u: ", int(space), unsigned(offset));
+            for (size_t i = 0; i < space; ++i)
                 printf("%x ", (unsigned char)(mididata[i]));
 
             printf("\n");
@@ -393,6 +463,7 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
         }
         else
         {
+            jack_ringbuffer_read_advance(jackdata->m_jack_buffmessage, space);
             errprint("jack_midi_event_reserve() returned a null pointer");
         }
     }
@@ -475,6 +546,10 @@ midi_jack::~midi_jack ()
     if (not_nullptr(m_jack_data.m_jack_buffmessage))
         jack_ringbuffer_free(m_jack_data.m_jack_buffmessage);
 
+    if (late_count() > 0)
+    {
+        infoprintf("%lu late JACK MIDI output events clamped\n", late_count());
+    }
     apiprint("~midi_jack", "jack");
 }
 
@@ -801,11 +876,10 @@ midi_jack::api_deinit_in ()
 }
 
 /**
- *  We could push the bytes of the event into a midibyte vector, as done in
- *  send_message().  The ALSA code (seq_alsamidi/src/midibus.cpp) sticks the
- *  event bytes in an array, which might be a little faster than using
- *  push_back(), but let's try the vector first.  The rtmidi code here is from
- *  midi_out_jack::send_message().
+ *  We used to push the bytes of the event into a midibyte vector, as done in
+ *  send_message().  Like the ALSA code (seq_alsamidi/src/midibus.cpp), we now
+ *  stick the event bytes in an array, and hand them to
+ *  send_stamped_message().
  */
 
 void
@@ -815,33 +889,19 @@ midi_jack::api_play (event * e24, midibyte channel)
     midibyte d0, d1;
     e24->get_data(d0, d1);
 
-    midi_message message;
-    message.push(status);
-    message.push(d0);
-    if (e24->is_two_bytes())                    /* \change ca 2017-04-26 */
-        message.push(d1);
+    char message[3];                            /* no need for a vector */
+    message[0] = char(status);
+    message[1] = char(d0);
+    message[2] = char(d1);
+    int nbytes = e24->is_two_bytes() ? 3 : 2 ;  /* \change ca 2017-04-26 */
 
 #ifdef SEQ64_SHOW_API_CALLS_TMI
     printf("midi_jack::play()\n");
 #endif
 
-    int nbytes = message.count();               /* send_message(message) */
-    if (nbytes > 0 && m_jack_data.valid_buffer())
+    if (! send_stamped_message(message, nbytes))
     {
-        int count1 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffmessage,
-            message.array(),                    /* (const char *) &m[0] */
-            message.count()
-        );
-        int count2 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffsize, (char *) &nbytes, sizeof nbytes
-        );
-        if ((count1 <= 0) || (count2 <= 0))
-        {
-            errprint("JACK api_play failed");
-        }
+        errprint("JACK api_play failed");
     }
 }
 
@@ -975,30 +1035,66 @@ midi_jack::api_clock (midipulse tick)
 void
 midi_jack::send_byte (midibyte evbyte, midipulse tick)
 {
-    midi_message message;
-    message.push(evbyte);
-    int nbytes = 1;
-
+    char message = char(evbyte);
     if (is_null_midipulse(tick))
     {
         // TODO
     }
+    if (! send_stamped_message(&message, 1))
+    {
+        errprint("JACK send_byte() failed");
+    }
+}
 
-    if (m_jack_data.valid_buffer())
+/**
+ *  Writes a message, preceded by its midi_jack_header, to the JACK
+ *  ring-buffers.  The header records the current JACK frame time, which
+ *  jack_process_rtmidi_output() uses to place the message at the proper
+ *  frame offset of the next process period.  The message is written before
+ *  the header, and only if both fit, so that the process callback never sees
+ *  a header without its data.
+ *
+ * \param msg
+ *      Provides the bytes of the message.
+ *
+ * \param nbytes
+ *      Provides the number of bytes in the message.
+ *
+ * \return
+ *      Returns true if the message and its header were written.
+ */
+
+bool
+midi_jack::send_stamped_message (const char * msg, int nbytes)
+{
+    bool result = nbytes > 0 && m_jack_data.valid_buffer();
+    if (result)
     {
-        int count1 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffmessage, message.array(), 1
-        );
-        int count2 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffsize, (char *) &nbytes, sizeof nbytes
-        );
-        if ((count1 <= 0) || (count2 <= 0))
+        midi_jack_header header;
+        header.m_size = nbytes;
+        header.m_frame = is_nullptr(client_handle()) ?
+            0 : jack_frame_time(client_handle()) ;
+
+        result =
+            jack_ringbuffer_write_space(m_jack_data.m_jack_buffmessage) >=
+                size_t(nbytes) &&
+            jack_ringbuffer_write_space(m_jack_data.m_jack_buffsize) >=
+                sizeof header;
+
+        if (result)
         {
-            errprint("JACK send_byte() failed");
+            (void) jack_ringbuffer_write
+            (
+                m_jack_data.m_jack_buffmessage, msg, size_t(nbytes)
+            );
+            (void) jack_ringbuffer_write
+            (
+                m_jack_data.m_jack_buffsize, (const char *) &header,
+                sizeof header
+            );
         }
     }
+    return result;
 }
 
 void
@@ -1425,12 +1521,15 @@ midi_in_jack::midi_in_jack (midibus & parentbus, midi_info & masterinfo)
      */
 
     m_jack_data.m_jack_rtmidiin = input_data();
+    input_data()->wakeup(master_info().input_wakeup());
 }
 
 /**
  *  Checks the rtmidi_in_data queue for the number of items in the queue.
- *
- *  WE MAY NEED LOCKING.
+ *  No locking is needed, as the queue is a single-producer/single-consumer
+ *  ring, and this function runs in the (single) consumer thread.  There is
+ *  no need to sleep here either; the master buss waits on the wakeup that
+ *  jack_process_rtmidi_input() signals.
  *
  * \return
  *      Returns the value of rtindata->queue().count(), unless the caller is
@@ -1447,10 +1546,7 @@ midi_in_jack::api_poll_for_midi ()
         return 0;
     }
     else
-    {
-        millisleep(1);
         return rtindata->queue().count();
-    }
 }
 
 /**
@@ -1469,11 +1565,11 @@ bool
 midi_in_jack::api_get_midi_event (event * inev)
 {
     rtmidi_in_data * rtindata = m_jack_data.m_jack_rtmidiin;
-    bool result = ! rtindata->queue().empty();
+    midi_message & mm = rtindata->message();    /* reused, no allocation    */
+    bool result = rtindata->queue().pop_front(mm);
     if (result)
     {
-        midi_message mm = rtindata->queue().pop_front();
-        inev->set_timestamp(mm.timestamp());
+        inev->set_timestamp(midipulse(mm.timestamp()));  /* arrival time    */
         if (mm.count() == 3)
         {
             inev->set_status_keep_channel(mm[0]);
@@ -1527,12 +1623,22 @@ midi_in_jack::api_get_midi_event (event * inev)
 
 /**
  *  Destructor.  Currently the base class closes the port, closes the JACK
- *  client, and cleans up the API data structure.
+ *  client, and cleans up the API data structure.  Here, we report any input
+ *  messages dropped because the input queue was full, even in release
+ *  builds, since they mean lost data.
  */
 
 midi_in_jack::~midi_in_jack()
 {
-    // No code yet
+    const midi_queue & q = input_data()->queue();
+    if (q.dropped() > 0 || q.dropped_sysex() > 0)
+    {
+        fprintf
+        (
+            stderr, "[MIDI input queue overflow: %u messages, %u SysEx]\n",
+            q.dropped(), q.dropped_sysex()
+        );
+    }
 }
 
 /*
@@ -1576,8 +1682,8 @@ midi_out_jack::~midi_out_jack ()
 }
 
 /**
- *  Sends a JACK MIDI output message.  It writes the full message size and
- *  the message itself to the JACK ring buffer.
+ *  Sends a JACK MIDI output message.  It writes the full message size, its
+ *  frame time, and the message itself to the JACK ring buffers.
  *
  * \param message
  *      Provides the MIDI message object, which contains the bytes to send.
@@ -1590,17 +1696,9 @@ midi_out_jack::~midi_out_jack ()
 bool
 midi_out_jack::send_message (const midi_message & message)
 {
-    int nbytes = message.count();
-    int count1 = jack_ringbuffer_write
-    (
-        m_jack_data.m_jack_buffmessage, message.array(), message.count()
-    );
-    int count2 = jack_ringbuffer_write
-    (
-        m_jack_data.m_jack_buffsize, (char *) &nbytes, sizeof(nbytes)
-    );
+    bool result = send_stamped_message(message.array(), message.count());
     apiprint("send_message", "jack");
-    return (count1 > 0) && (count2 > 0);
+    return result;
 }
 
 }           // namespace seq64
@@ -435,6 +435,32 @@ midi_jack_info::api_flush ()
     // No code yet
 }
 
+/**
+ *  Provides the delay added to the output.  The process callback plays each
+ *  message one period after it was queued (see jack_process_rtmidi_output()
+ *  in the midi_jack module), so the delay is one period.
+ *
+ * \return
+ *      Returns the length of a JACK period in microseconds, or 0 if there is
+ *      no JACK client.
+ */
+
+long
+midi_jack_info::api_output_latency_us () const
+{
+    long result = 0;
+    if (not_nullptr(m_jack_client))
+    {
+        jack_nframes_t rate = jack_get_sample_rate(m_jack_client);
+        if (rate > 0)
+        {
+            jack_nframes_t frames = jack_get_buffer_size(m_jack_client);
+            result = long(1000000.0 * frames / rate);
+        }
+    }
+    return result;
+}
+
 /**
  *  Sets up all of the ports, represented by midibus objects, that have
  *  been created.
@@ -32,139 +32,168 @@ namespace seq64
 
 midi_message::midi_message ()
  :
+    m_short     (),
     m_bytes     (),
+    m_count     (0),
     m_timestamp (0.0)
 {
     // Empty body
 }
 
-/*
- * class midi_queue
- */
-
 /**
- *  Default constructor.
+ *  Appends a byte to the message.  The first SEQ64_MIDI_SHORT_MESSAGE bytes
+ *  are stored inline.  When the message grows beyond that, all of its bytes
+ *  move to the vector, the only case in which memory is allocated.
+ *
+ * \param b
+ *      The byte to append.
  */
 
-midi_queue::midi_queue ()
- :
-    m_front     (0),
-    m_back      (0),
-    m_size      (0),
-    m_ring_size (0),
-    m_ring      (nullptr)
+void
+midi_message::push (midibyte b)
 {
-    allocate();
-}
-
-/**
- *  Destructor.
- */
+    if (m_count < SEQ64_MIDI_SHORT_MESSAGE)
+    {
+        m_short[m_count] = b;
+    }
+    else
+    {
+        if (m_count == SEQ64_MIDI_SHORT_MESSAGE)
+            m_bytes.assign(m_short, m_short + m_count);
 
-midi_queue::~midi_queue ()
-{
-    deallocate();
+        m_bytes.push_back(b);
+    }
+    ++m_count;
 }
 
 /**
- *
- *  This would be better off as a constructor operation.  But one step at a
- *  time.
+ *  Empties the message so that it can be reused.  The vector keeps its
+ *  memory for the next long message.
  */
 
 void
-midi_queue::allocate (unsigned queuesize)
+midi_message::clear ()
 {
-    if (queuesize > 0 && is_nullptr(m_ring))
-    {
-        m_ring = new (std::nothrow) midi_message[queuesize];
-        if (not_nullptr(m_ring))
-            m_ring_size = queuesize;
-    }
+    m_bytes.clear();
+    m_count = 0;
+    m_timestamp = 0.0;
 }
 
+/*
+ * class midi_queue
+ */
+
 /**
+ *  Constructs the queue, allocating all of the memory it will ever use.
+ *
+ * \param queuesize
+ *      The maximum number of messages in the queue.
  *
- *  This would be better off as a destructor operation.  But one step at a
- *  time.
+ * \param sysexsize
+ *      The maximum number of bytes of long messages in the queue.
  */
 
-void
-midi_queue::deallocate ()
+midi_queue::midi_queue (unsigned queuesize, unsigned sysexsize)
+ :
+    m_ring          (queuesize),
+    m_sysex         (sysexsize),
+    m_dropped       (0),
+    m_dropped_sysex (0)
 {
-    if (not_nullptr(m_ring))
-    {
-        delete [] m_ring;
-        m_ring = nullptr;
-    }
+    // Empty body
 }
 
 /**
+ *  Adds a message to the queue.  Called only by the producer, normally the
+ *  JACK process callback, so that this function must not allocate, block,
+ *  or print.  If there is no room, the message is dropped and counted.
+ *
+ * \param bytes
+ *      Points to the bytes of the message.
+ *
+ * \param count
+ *      The number of bytes in the message.
  *
- *  As long as we haven't reached our queue size limit, push the message.
+ * \param timestamp
+ *      The timestamp of the message.
+ *
+ * \return
+ *      Returns false if the message was dropped.
  */
 
 bool
-midi_queue::add (const midi_message & mmsg)
+midi_queue::add (const midibyte * bytes, int count, double timestamp)
 {
-    bool result = ! full();
-    if (result)
+    queued_message qm;
+    qm.qm_timestamp = timestamp;
+    qm.qm_count = count;
+    if (count <= SEQ64_MIDI_SHORT_MESSAGE)
     {
-        m_ring[m_back++] = mmsg;
-        if (m_back == m_ring_size)
-            m_back = 0;
+        for (int i = 0; i < count; ++i)
+            qm.qm_bytes[i] = bytes[i];
 
-        ++m_size;
-    }
-    else
-    {
-        errprintfunc("message queue limit reached");
+        bool result = m_ring.push(qm);
+        if (! result)
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+
+        return result;
     }
-    return result;
-}
 
-/**
- *  Pops, so to speak, the front message out of the queue, effectively
- *  throwing it away.  One useful call sequence is:
- *
-\verbatim
-    midi_message latest = queue.front();
-    queue.pop();
-\endverbatim
- *
- *  An alternative is to use the pop_front() function instead.
- */
+    /*
+     * The bytes must not be stored unless the slot for the message is
+     * available, or the consumer would take them for the next long
+     * message's bytes.  Since only the producer fills the ring, a free slot
+     * seen here stays free.
+     */
 
-void
-midi_queue::pop ()
-{
-    --m_size;
-    ++m_front;
-    if (m_front == m_ring_size)
-        m_front = 0;
+    bool result = m_ring.count() < m_ring.capacity();
+    if (result)
+        result = m_sysex.push(bytes, std::size_t(count));
+
+    if (result)
+        (void) m_ring.push(qm);
+    else
+        m_dropped_sysex.fetch_add(1, std::memory_order_relaxed);
+
+    return result;
 }
 
 /**
- *  Pops a copy of the front message.   Could be a little inefficient, since a
- *  couple of copies are made, and we cannot use return-code optimization.
+ *  Pops a copy of the front message.  Called only by the consumer.  A short
+ *  message is copied without allocating memory, if the destination
+ *  midi_message is reused.
  *
- *  Perhaps at some point we could use move semantics?
+ * \param [out] mmsg
+ *      The destination for the message.  It is cleared first.
  *
  * \return
- *      Returns a copy of the message that was in front before the popping.
- *      If the queue is empty, an empty (all zeros) message is returned.
- *      Can be checked with the midi_message::empty() function.
+ *      Returns false if the queue was empty, in which case \a mmsg is left
+ *      empty.
  */
 
-midi_message
-midi_queue::pop_front ()
+bool
+midi_queue::pop_front (midi_message & mmsg)
 {
-    midi_message result;
-    if (m_size != 0)
+    mmsg.clear();
+    bool result = ! m_ring.empty();
+    if (result)
     {
-        midi_message & mmr = m_ring[m_front];
-        result = mmr;
-        pop();
+        const queued_message & qm = m_ring.front();
+        mmsg.timestamp(qm.qm_timestamp);
+        if (qm.qm_count <= SEQ64_MIDI_SHORT_MESSAGE)
+        {
+            for (int i = 0; i < qm.qm_count; ++i)
+                mmsg.push(qm.qm_bytes[i]);
+        }
+        else
+        {
+            for (int i = 0; i < qm.qm_count; ++i)
+            {
+                mmsg.push(m_sysex.front());
+                m_sysex.pop();
+            }
+        }
+        m_ring.pop();
     }
     return result;
 }
@@ -184,7 +213,8 @@ rtmidi_in_data::rtmidi_in_data ()
     m_using_callback    (false),
     m_user_callback     (nullptr),
     m_user_data         (nullptr),
-    m_continue_sysex    (false)
+    m_continue_sysex    (false),
+    m_wakeup            (nullptr)
 {
     // no body
 }
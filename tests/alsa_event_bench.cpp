@@ -0,0 +1,281 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          alsa_event_bench.cpp
+ *
+ *  This module defines a check and benchmark of the encoding of channel
+ *  messages into ALSA sequencer events.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Every channel-voice status, on every channel, with a spread of data
+ *  values, is encoded both by encode_channel_event() and, as the ALSA
+ *  output used to do for every event, by a new snd_midi_event_t parser
+ *  that is freed afterward.  The two snd_seq_event_t results must be the
+ *  same, byte for byte.  Both ways are then timed on a mix of messages.
+ *  No ALSA client or device is needed.
+ *
+ *  Built and run by "make check"; see tests/Makefile.am.  Run it by hand as
+ *  "./alsa_event_bench [events]".  It is skipped if the library was built
+ *  without ALSA.
+ */
+
+#include <stdio.h>
+#include <string.h>                     /* memcmp()                         */
+#include <vector>
+
+#include "alsa_event.hpp"               /* seq64::encode_channel_event()    */
+#include "test_harness.hpp"             /* seq64::test_harness              */
+
+#ifdef SEQ64_HAVE_LIBASOUND
+
+/**
+ *  The size of the ALSA MIDI parser, as the ALSA output creates it.
+ */
+
+#define SEQ64_MIDI_EVENT_SIZE_MAX   10
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  A channel message of three bytes.  The last data byte is ignored for
+ *  Program Change and Channel Pressure.
+ */
+
+class channel_message
+{
+
+public:
+
+    midibyte m_bytes[3];                /**< Status and two data bytes.     */
+
+    channel_message (midibyte status, midibyte d1, midibyte d2)
+    {
+        m_bytes[0] = status;
+        m_bytes[1] = d1;
+        m_bytes[2] = d2;
+    }
+
+};
+
+/**
+ *  Compares and times the two encodings.
+ */
+
+class alsa_event_bench
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+public:
+
+    alsa_event_bench (test_harness & h) : m_harness (h)
+    {
+        // Empty body
+    }
+
+    bool check ();
+    void run (int count);
+
+private:
+
+    static void encode_parser (const midibyte buffer [], snd_seq_event_t & ev);
+
+};
+
+/**
+ *  Encodes a message the way the ALSA output did before
+ *  encode_channel_event():  with an ALSA MIDI parser made for the event.
+ *
+ * \param buffer
+ *      The status and data bytes.
+ *
+ * \param ev
+ *      The ALSA event to fill in.  It must already be cleared.
+ */
+
+void
+alsa_event_bench::encode_parser (const midibyte buffer [], snd_seq_event_t & ev)
+{
+    snd_midi_event_t * midi_ev;
+    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
+    snd_midi_event_encode(midi_ev, buffer, 3, &ev);
+    snd_midi_event_free(midi_ev);
+}
+
+/**
+ *  Encodes every channel-voice status on every channel, with data bytes at
+ *  and near their limits, both ways, and compares the events.
+ *
+ * \return
+ *      Returns true if all of the events are the same.
+ */
+
+bool
+alsa_event_bench::check ()
+{
+    static const midibyte s_data [] = { 0, 1, 63, 64, 65, 126, 127 };
+    static const int s_count = int(sizeof s_data / sizeof s_data[0]);
+    int checked = 0;
+    for (int status = 0x80; status < 0xF0; ++status)
+    {
+        for (int i = 0; i < s_count; ++i)
+        {
+            for (int j = 0; j < s_count; ++j)
+            {
+                channel_message m(midibyte(status), s_data[i], s_data[j]);
+                snd_seq_event_t fast;
+                snd_seq_event_t slow;
+                snd_seq_ev_clear(&fast);
+                snd_seq_ev_clear(&slow);
+                if (! encode_channel_event(m.m_bytes, fast))
+                {
+                    return m_harness.fail
+                    (
+                        "status 0x%02X not encoded", status
+                    );
+                }
+                encode_parser(m.m_bytes, slow);
+                if (memcmp(&fast, &slow, sizeof fast) != 0)
+                {
+                    return m_harness.fail
+                    (
+                        "0x%02X %d %d encoded differently",
+                        status, int(s_data[i]), int(s_data[j])
+                    );
+                }
+                ++checked;
+            }
+        }
+    }
+    printf("%d messages encoded identically\n", checked);
+    return true;
+}
+
+/**
+ *  Times both encodings on a mix of messages like those a pattern plays:
+ *  mostly Note Ons and Note Offs, with some Control Changes, Program
+ *  Changes, and pitch bends.
+ *
+ * \param count
+ *      The number of messages to encode each way.
+ */
+
+void
+alsa_event_bench::run (int count)
+{
+    std::vector<channel_message> mix;
+    for (int i = 0; i < 64; ++i)
+    {
+        midibyte ch = midibyte(i % 16);
+        midibyte note = midibyte(36 + i);
+        mix.push_back(channel_message(EVENT_NOTE_ON + ch, note, 100));
+        mix.push_back(channel_message(EVENT_NOTE_OFF + ch, note, 0));
+        if (i % 4 == 0)
+            mix.push_back(channel_message(EVENT_CONTROL_CHANGE + ch, 7, 90));
+
+        if (i % 16 == 0)
+            mix.push_back(channel_message(EVENT_PROGRAM_CHANGE + ch, 5, 0));
+
+        if (i % 8 == 0)
+            mix.push_back(channel_message(EVENT_PITCH_WHEEL + ch, 0, 72));
+    }
+
+    int sum = 0;                        /* keeps the encoding from going    */
+    std::int64_t start = test_harness::now_us();
+    for (int i = 0; i < count; ++i)
+    {
+        snd_seq_event_t ev;
+        snd_seq_ev_clear(&ev);
+        (void) encode_channel_event(mix[i % mix.size()].m_bytes, ev);
+        sum += ev.type;
+    }
+    std::int64_t fast = test_harness::now_us() - start;
+
+    start = test_harness::now_us();
+    for (int i = 0; i < count; ++i)
+    {
+        snd_seq_event_t ev;
+        snd_seq_ev_clear(&ev);
+        encode_parser(mix[i % mix.size()].m_bytes, ev);
+        sum -= ev.type;
+    }
+    std::int64_t slow = test_harness::now_us() - start;
+    if (sum != 0)
+        (void) m_harness.fail("the timed encodings differ");
+
+    printf
+    (
+        "%d events\n"
+        "encode_channel_event(): %.0f events/s\n"
+        "snd_midi_event parser:  %.0f events/s\n",
+        count,
+        test_harness::per_second(count, fast),
+        test_harness::per_second(count, slow)
+    );
+}
+
+}           // namespace seq64
+
+#endif      // SEQ64_HAVE_LIBASOUND
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+
+#ifdef SEQ64_HAVE_LIBASOUND
+
+    seq64::alsa_event_bench bench(h);
+    if (bench.check())
+        bench.run(h.int_arg(0, 1000000));
+
+    return h.status();
+
+#else
+
+    printf("built without ALSA, skipped\n");
+    return SEQ64_TEST_SKIPPED;
+
+#endif
+}
+
+/*
+ * alsa_event_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
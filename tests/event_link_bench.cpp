@@ -0,0 +1,588 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_link_bench.cpp
+ *
+ *  This module defines a check and benchmark of the linking of Note Ons to
+ *  Note Offs by the event_list class.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Three linkers are compared on patterns of 200,000 events:
+ *
+ *      -   The old quadratic linker, which searched forward from each Note
+ *          On for its Note Off, and then from the start of the pattern.  It
+ *          is kept here, as the reference.
+ *      -   The one-pass linker, event_list::verify_and_link().
+ *      -   The incremental linker, event_list::add_linked(), which links
+ *          each event as it is recorded.
+ *
+ *  The first pattern has notes at random times, which can overlap other
+ *  notes of the same pitch, and some of which wrap around the end of the
+ *  pattern.  The quadratic and the one-pass linkers must give it the same
+ *  links.  The second pattern is played as a keyboard would, each pitch
+ *  being released before it is struck again, with some notes wrapping
+ *  around too.  It is loaded and linked up to a point, and the rest is
+ *  recorded onto it with add_linked(), in the order that a looping
+ *  recording would deliver it; all three linkers must then give the same
+ *  links.  Each linker is timed.
+ *
+ *  Built and run by "make check"; see tests/Makefile.am.  Run it by hand as
+ *  "./event_link_bench [events] [recorded]".  With the std::vector
+ *  container, every add_linked() relinks the whole pattern, so keep the
+ *  number of recorded events small.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>                    /* std::sort(), std::max_element()  */
+#include <vector>
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "event_list.hpp"               /* seq64::event_list                */
+#include "test_harness.hpp"             /* seq64::test_harness              */
+
+/**
+ *  The number of pitches used, starting at note 24, and the longest note
+ *  and longest gap between notes, in ticks.
+ */
+
+#define SEQ64_BENCH_PITCHES     72
+#define SEQ64_BENCH_NOTE_MAX    192
+#define SEQ64_BENCH_GAP_MAX     96
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  One Note On and the Note Off linked to it, if any, found in a linked
+ *  pattern.  The links of two patterns with the same events are the same
+ *  if they give the same sorted vectors of these.
+ */
+
+class note_link
+{
+
+public:
+
+    midipulse m_on;                     /**< Time-stamp of the Note On.     */
+    int m_note;                         /**< Pitch of the Note On.          */
+    midipulse m_off;                    /**< Time-stamp of the Note Off.    */
+
+    note_link (midipulse on, int note, midipulse off)
+     :
+        m_on    (on),
+        m_note  (note),
+        m_off   (off)
+    {
+        // Empty body
+    }
+
+    /**
+     *  Orders the links by Note On, pitch, and then Note Off.
+     */
+
+    bool operator < (const note_link & rhs) const
+    {
+        if (m_on != rhs.m_on)
+            return m_on < rhs.m_on;
+
+        if (m_note != rhs.m_note)
+            return m_note < rhs.m_note;
+
+        return m_off < rhs.m_off;
+    }
+
+    /**
+     *  Compares all three members.
+     */
+
+    bool operator == (const note_link & rhs) const
+    {
+        return m_on == rhs.m_on && m_note == rhs.m_note && m_off == rhs.m_off;
+    }
+
+};
+
+/**
+ *  The links found in a pattern, sorted.
+ */
+
+typedef std::vector<note_link> note_links;
+
+/**
+ *  Makes the patterns, links them each way, and compares the links.
+ */
+
+class event_link_bench
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+    /**
+     *  The events of the pattern, in time order.
+     */
+
+    std::vector<event> m_events;
+
+    /**
+     *  The length of the pattern, in ticks.
+     */
+
+    midipulse m_length;
+
+public:
+
+    event_link_bench (test_harness & h)
+     :
+        m_harness   (h),
+        m_events    (),
+        m_length    (0)
+    {
+        // Empty body
+    }
+
+    void make_random (int count);
+    void make_played (int count);
+    void run_quadratic (note_links & links);
+    void run_one_pass (note_links & links);
+    void run_incremental (int recorded, note_links & links);
+    bool compare
+    (
+        const char * name, const note_links & a, const note_links & b
+    );
+
+private:
+
+    void add_note (midipulse on, midipulse off, int note);
+    void finish ();
+    void load (event_list & evl, std::size_t count);
+    static void link_quadratic (event_list & evl);
+    static void collect (const event_list & evl, note_links & links);
+
+};
+
+/**
+ *  Adds a Note On and its Note Off to the events.
+ *
+ * \param on
+ *      The time-stamp of the Note On.
+ *
+ * \param off
+ *      The time-stamp of the Note Off, which is before the Note On if the
+ *      note wraps around the end of the pattern.
+ *
+ * \param note
+ *      The pitch.
+ */
+
+void
+event_link_bench::add_note (midipulse on, midipulse off, int note)
+{
+    event e;
+    e.set_timestamp(on);
+    e.set_status(EVENT_NOTE_ON);
+    e.set_data(midibyte(note), midibyte(1 + rand() % 127));
+    m_events.push_back(e);
+    e.set_timestamp(off);
+    e.set_status(EVENT_NOTE_OFF);
+    e.set_data(midibyte(note), 0);
+    m_events.push_back(e);
+}
+
+/**
+ *  Puts the events in time order, as the event_list sorts them.
+ */
+
+void
+event_link_bench::finish ()
+{
+    std::stable_sort(m_events.begin(), m_events.end());
+}
+
+/**
+ *  Makes notes at random times, which can overlap notes of the same pitch.
+ *  The notes that would end past the end of the pattern wrap around to its
+ *  start.
+ *
+ * \param count
+ *      The number of events to make, rounded down to an even number.
+ */
+
+void
+event_link_bench::make_random (int count)
+{
+    m_events.clear();
+    m_length = midipulse(count / 2) * SEQ64_BENCH_GAP_MAX / SEQ64_BENCH_PITCHES;
+    for (int i = 0; i < count / 2; ++i)
+    {
+        midipulse on = midipulse(rand()) % m_length;
+        midipulse off = on + 1 + rand() % (SEQ64_BENCH_NOTE_MAX - 1);
+        if (off >= m_length)
+            off -= m_length;
+
+        add_note(on, off, 24 + rand() % SEQ64_BENCH_PITCHES);
+    }
+    finish();
+}
+
+/**
+ *  Makes notes that never overlap notes of the same pitch, as played on a
+ *  keyboard.  Every fourth pitch also gets a last note that wraps around to
+ *  tick 0, before the first note of the pitch.
+ *
+ * \param count
+ *      The number of events to make, rounded down to an even number.
+ */
+
+void
+event_link_bench::make_played (int count)
+{
+    m_events.clear();
+    std::vector<midipulse> next(SEQ64_BENCH_PITCHES, 1);
+    int notes = count / 2 - SEQ64_BENCH_PITCHES / 4;
+    for (int i = 0; i < notes; ++i)
+    {
+        int p = i % SEQ64_BENCH_PITCHES;
+        midipulse on = next[p] + rand() % SEQ64_BENCH_GAP_MAX;
+        midipulse off = on + 1 + rand() % (SEQ64_BENCH_NOTE_MAX - 1);
+        add_note(on, off, 24 + p);
+        next[p] = off + 1;
+    }
+    m_length = *std::max_element(next.begin(), next.end()) + 1;
+    for (int p = 0; p < SEQ64_BENCH_PITCHES; p += 4)
+        add_note(next[p], 0, 24 + p);
+
+    finish();
+}
+
+/**
+ *  Appends the first events to an empty event_list, and sorts them.
+ *
+ * \param evl
+ *      The event_list to fill.
+ *
+ * \param count
+ *      The number of events to load.
+ */
+
+void
+event_link_bench::load (event_list & evl, std::size_t count)
+{
+    evl.reserve(int(count));
+    for (std::size_t i = 0; i < count; ++i)
+        evl.append(m_events[i]);
+
+    evl.sort();
+}
+
+/**
+ *  The linker that verify_and_link() used before the one-pass linker:  for
+ *  each Note On, the first unmarked Note Off of the same pitch after it, or
+ *  else from the start of the pattern.  Its cost grows with the distance
+ *  from each Note On to its Note Off, and with the whole pattern for each
+ *  note that wraps around.
+ *
+ * \param evl
+ *      The event_list to link.
+ */
+
+void
+event_link_bench::link_quadratic (event_list & evl)
+{
+    for (event_list::iterator i = evl.begin(); i != evl.end(); ++i)
+    {
+        event & e = event_list::dref(i);
+        e.clear_link();
+        e.unmark();
+    }
+    for (event_list::iterator on = evl.begin(); on != evl.end(); ++on)
+    {
+        event & eon = event_list::dref(on);
+        if (! eon.is_note_on())
+            continue;
+
+        bool endfound = false;
+        event_list::iterator off = on;
+        for (++off; off != evl.end(); ++off)
+        {
+            event & eoff = event_list::dref(off);
+            if
+            (
+                eoff.is_note_off() &&
+                eoff.get_note() == eon.get_note() && ! eoff.is_marked()
+            )
+            {
+                eon.link(&eoff);
+                eoff.link(&eon);
+                eon.mark();
+                eoff.mark();
+                endfound = true;
+                break;
+            }
+        }
+        if (endfound)
+            continue;
+
+        for (off = evl.begin(); off != on; ++off)
+        {
+            event & eoff = event_list::dref(off);
+            if
+            (
+                eoff.is_note_off() &&
+                eoff.get_note() == eon.get_note() && ! eoff.is_marked()
+            )
+            {
+                eon.link(&eoff);
+                eoff.link(&eon);
+                eon.mark();
+                eoff.mark();
+                break;
+            }
+        }
+    }
+    for (event_list::iterator i = evl.begin(); i != evl.end(); ++i)
+        event_list::dref(i).unmark();
+}
+
+/**
+ *  Gathers the links of a pattern.  A Note On without a Note Off gets a
+ *  Note Off time of -1.
+ *
+ * \param evl
+ *      The linked event_list.
+ *
+ * \param [out] links
+ *      The links, sorted.
+ */
+
+void
+event_link_bench::collect (const event_list & evl, note_links & links)
+{
+    links.clear();
+    for (event_list::const_iterator i = evl.begin(); i != evl.end(); ++i)
+    {
+        const event & e = event_list::dref(i);
+        if (e.is_note_on())
+        {
+            midipulse off = -1;
+            if (e.is_linked())
+                off = e.get_linked()->get_timestamp();
+
+            links.push_back(note_link(e.get_timestamp(), e.get_note(), off));
+        }
+    }
+    std::sort(links.begin(), links.end());
+}
+
+/**
+ *  Links the whole pattern with the quadratic linker, and times it.
+ *
+ * \param [out] links
+ *      The links made.
+ */
+
+void
+event_link_bench::run_quadratic (note_links & links)
+{
+    event_list evl;
+    load(evl, m_events.size());
+    std::int64_t start = test_harness::now_us();
+    link_quadratic(evl);
+    std::int64_t us = test_harness::now_us() - start;
+    collect(evl, links);
+    printf
+    (
+        "quadratic linker:   %.0f events/s\n",
+        test_harness::per_second(evl.count(), us)
+    );
+}
+
+/**
+ *  Links the whole pattern with event_list::verify_and_link(), and times
+ *  it.
+ *
+ * \param [out] links
+ *      The links made.
+ */
+
+void
+event_link_bench::run_one_pass (note_links & links)
+{
+    event_list evl;
+    load(evl, m_events.size());
+    std::int64_t start = test_harness::now_us();
+    evl.verify_and_link(m_length);
+    std::int64_t us = test_harness::now_us() - start;
+    collect(evl, links);
+    printf
+    (
+        "one-pass linker:    %.0f events/s\n",
+        test_harness::per_second(evl.count(), us)
+    );
+}
+
+/**
+ *  Loads and links the start of the pattern, and then records the rest
+ *  onto it with event_list::add_linked(), timing only the recording.  The
+ *  events are recorded as a looping recording delivers them:  in time
+ *  order to the end of the pattern, and then the Note Offs of the notes
+ *  that wrap around, at tick 0.  Those Note Offs are not loaded with the
+ *  start of the pattern, since they are played after their Note Ons.
+ *
+ * \param recorded
+ *      The number of events to record.
+ *
+ * \param [out] links
+ *      The links made.
+ */
+
+void
+event_link_bench::run_incremental (int recorded, note_links & links)
+{
+    std::size_t cut = m_events.size() > std::size_t(recorded) ?
+        m_events.size() - std::size_t(recorded) : 0 ;
+
+    std::vector<event> wrapped;                     /* Note Offs at tick 0  */
+    event_list evl;
+    for (std::size_t i = 0; i < cut; ++i)
+    {
+        const event & e = m_events[i];
+        if (e.is_note_off() && e.get_timestamp() == 0)
+            wrapped.push_back(e);
+        else
+            evl.append(e);
+    }
+    evl.sort();
+    evl.verify_and_link(m_length);
+
+    int count = 0;
+    std::int64_t start = test_harness::now_us();
+    for (std::size_t i = cut; i < m_events.size(); ++i, ++count)
+        evl.add_linked(m_events[i]);
+
+    for (std::size_t i = 0; i < wrapped.size(); ++i, ++count)
+        evl.add_linked(wrapped[i]);
+
+    std::int64_t us = test_harness::now_us() - start;
+    collect(evl, links);
+    printf
+    (
+        "incremental linker: %.0f events/s, %d events recorded\n",
+        test_harness::per_second(count, us), count
+    );
+}
+
+/**
+ *  Checks that two linkers gave the same links.
+ *
+ * \param name
+ *      Names the pair of linkers, for the failure message.
+ *
+ * \param a
+ *      The links of the first linker.
+ *
+ * \param b
+ *      The links of the second linker.
+ *
+ * \return
+ *      Returns true if the links are the same.
+ */
+
+bool
+event_link_bench::compare
+(
+    const char * name, const note_links & a, const note_links & b
+)
+{
+    if (a.size() != b.size())
+    {
+        return m_harness.fail
+        (
+            "%s: %d and %d links", name, int(a.size()), int(b.size())
+        );
+    }
+
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (! (a[i] == b[i]))
+        {
+            return m_harness.fail
+            (
+                "%s: Note On %d at %ld linked to %ld and to %ld", name,
+                a[i].m_note, long(a[i].m_on), long(a[i].m_off), long(b[i].m_off)
+            );
+        }
+    }
+    return true;
+}
+
+}           // namespace seq64
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+    int count = h.int_arg(0, 200000);
+    seq64::event_link_bench bench(h);
+    seq64::note_links quadratic;
+    seq64::note_links onepass;
+    seq64::note_links incremental;
+
+    printf("%d events, overlapping notes:\n", count);
+    bench.make_random(count);
+    bench.run_quadratic(quadratic);
+    bench.run_one_pass(onepass);
+    if (bench.compare("random, one-pass", quadratic, onepass))
+        printf("same links\n");
+
+    printf("%d events, played notes:\n", count);
+    bench.make_played(count);
+    bench.run_quadratic(quadratic);
+    bench.run_one_pass(onepass);
+    bench.run_incremental(h.int_arg(1, 2000), incremental);
+    bool ok = bench.compare("played, one-pass", quadratic, onepass);
+    if (bench.compare("played, incremental", quadratic, incremental) && ok)
+        printf("same links\n");
+
+    return h.status();
+}
+
+/*
+ * event_link_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
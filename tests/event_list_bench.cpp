@@ -0,0 +1,343 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_list_bench.cpp
+ *
+ *  This module defines a benchmark of the containers of the event_list
+ *  class.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  A pattern of 100,000 events (50,000 notes at random times) is loaded
+ *  the way a MIDI file is, by appending the events in a shuffled order and
+ *  sorting them once.  It is then played, as sequence::play() walks it, one
+ *  window of ticks after the other; and then more events are added one at
+ *  a time with event_list::add(), as recording and editing do.  Each stage
+ *  is timed, and the container is checked to be in order after it.
+ *
+ *  The container is the one that the library was built with.  To compare
+ *  the three, build the whole tree three times, configured with
+ *  CPPFLAGS="-DSEQ64_EVENT_CONTAINER_CHOSEN" plus nothing,
+ *  -DSEQ64_USE_EVENT_MAP, or -DSEQ64_USE_EVENT_VECTOR, and run this program
+ *  from each build, as "./event_list_bench [events] [inserts] [passes]".
+ *  The checksum printed does not depend on the order of the events, so all
+ *  three builds must print the same one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>                    /* std::swap()                      */
+#include <vector>
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "event_list.hpp"               /* seq64::event_list                */
+#include "test_harness.hpp"             /* seq64::test_harness              */
+
+/**
+ *  The name of the container that the library was built with.
+ */
+
+#ifdef SEQ64_USE_EVENT_MAP
+#define SEQ64_BENCH_CONTAINER   "std::multimap"
+#elif defined SEQ64_USE_EVENT_VECTOR
+#define SEQ64_BENCH_CONTAINER   "std::vector"
+#else
+#define SEQ64_BENCH_CONTAINER   "std::list"
+#endif
+
+/**
+ *  The length of the pattern, in ticks, and the number of ticks played in
+ *  each window.
+ */
+
+#define SEQ64_BENCH_LENGTH      (192 * 4 * 256)
+#define SEQ64_BENCH_WINDOW      16
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Fills an event_list and times its operations.
+ */
+
+class event_list_bench
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+    /**
+     *  The events to benchmark.
+     */
+
+    event_list m_events;
+
+public:
+
+    event_list_bench (test_harness & h)
+     :
+        m_harness   (h),
+        m_events    ()
+    {
+        // Empty body
+    }
+
+    void load (int count);
+    void play (int passes);
+    void insert (int count);
+
+private:
+
+    bool check_order (const char * stage);
+
+};
+
+/**
+ *  Makes a random Note On or Note Off event.
+ *
+ * \param tick
+ *      The time-stamp of the event.
+ *
+ * \param on
+ *      True for a Note On, false for a Note Off.
+ */
+
+static event
+make_note (midipulse tick, bool on)
+{
+    event e;
+    e.set_timestamp(tick);
+    e.set_status(on ? EVENT_NOTE_ON : EVENT_NOTE_OFF);
+    midibyte velocity = on ? midibyte(1 + rand() % 127) : 0 ;
+    e.set_data(midibyte(24 + rand() % 72), velocity);
+    return e;
+}
+
+/**
+ *  Gives the part of the checksum of the pattern that an event adds.  The
+ *  sum does not depend on the order of the events.
+ *
+ * \param e
+ *      The event.
+ */
+
+static unsigned long
+checksum (const event & e)
+{
+    midibyte d0, d1;
+    e.get_data(d0, d1);
+    return (unsigned long)(e.get_timestamp()) * (e.get_status() + d0 + d1);
+}
+
+/**
+ *  Checks that the events are in time order.
+ *
+ * \param stage
+ *      The name of the stage just timed, for the failure message.
+ *
+ * \return
+ *      Returns true if the order is good.
+ */
+
+bool
+event_list_bench::check_order (const char * stage)
+{
+    midipulse last = 0;
+    int index = 0;
+    for
+    (
+        event_list::const_iterator i = m_events.begin();
+        i != m_events.end(); ++i, ++index
+    )
+    {
+        midipulse tick = event_list::dref(i).get_timestamp();
+        if (tick < last)
+            return m_harness.fail("%s: event %d out of order", stage, index);
+
+        last = tick;
+    }
+    return true;
+}
+
+/**
+ *  Appends notes at random times, in a shuffled order, and sorts them, as
+ *  reading a MIDI file does.
+ *
+ * \param count
+ *      The number of events to load, rounded down to an even number.
+ */
+
+void
+event_list_bench::load (int count)
+{
+    std::vector<event> notes;
+    for (int i = 0; i < count / 2; ++i)
+    {
+        midipulse tick = midipulse(rand()) % (SEQ64_BENCH_LENGTH - 192);
+        notes.push_back(make_note(tick, true));
+        notes.push_back(make_note(tick + 1 + rand() % 191, false));
+    }
+    for (int i = int(notes.size()) - 1; i > 0; --i)
+        std::swap(notes[i], notes[rand() % (i + 1)]);
+
+    unsigned long expected = 0;
+    for (int i = 0; i < int(notes.size()); ++i)
+        expected += checksum(notes[i]);
+
+    std::int64_t start = test_harness::now_us();
+    m_events.reserve(int(notes.size()));
+    for (int i = 0; i < int(notes.size()); ++i)
+        m_events.append(notes[i]);
+
+    m_events.sort();
+    std::int64_t us = test_harness::now_us() - start;
+    unsigned long sum = 0;
+    for
+    (
+        event_list::const_iterator i = m_events.begin();
+        i != m_events.end(); ++i
+    )
+    {
+        sum += checksum(event_list::dref(i));
+    }
+    if (m_events.count() != int(notes.size()) || sum != expected)
+        (void) m_harness.fail("load: %d events kept", m_events.count());
+
+    (void) check_order("load");
+    printf
+    (
+        "%s: %d events, checksum %lu\n"
+        "append and sort: %.0f events/s\n",
+        SEQ64_BENCH_CONTAINER, m_events.count(), sum,
+        test_harness::per_second(m_events.count(), us)
+    );
+}
+
+/**
+ *  Walks the whole pattern, one window of ticks at a time, keeping the
+ *  position reached, as sequence::play() does, and counts the Note Ons.
+ *
+ * \param passes
+ *      The number of times to play the pattern.
+ */
+
+void
+event_list_bench::play (int passes)
+{
+    int notes = 0;
+    std::int64_t start = test_harness::now_us();
+    for (int p = 0; p < passes; ++p)
+    {
+        event_list::const_iterator e = m_events.begin();
+        for (midipulse t = 0; t < SEQ64_BENCH_LENGTH; t += SEQ64_BENCH_WINDOW)
+        {
+            midipulse end = t + SEQ64_BENCH_WINDOW;
+            while (e != m_events.end())
+            {
+                const event & ev = event_list::dref(e);
+                if (ev.get_timestamp() >= end)
+                    break;
+
+                if (ev.is_note_on())
+                    ++notes;
+
+                ++e;
+            }
+        }
+    }
+    std::int64_t us = test_harness::now_us() - start;
+    if (notes != passes * (m_events.count() / 2))
+        (void) m_harness.fail("play: %d notes played", notes);
+
+    printf
+    (
+        "play, %d passes: %.0f events/s\n", passes,
+        test_harness::per_second(long(passes) * m_events.count(), us)
+    );
+}
+
+/**
+ *  Adds notes at random times, one at a time, with event_list::add(), as
+ *  recording and editing do.
+ *
+ * \param count
+ *      The number of events to add.
+ */
+
+void
+event_list_bench::insert (int count)
+{
+    std::vector<event> notes;
+    for (int i = 0; i < count; ++i)
+    {
+        midipulse tick = midipulse(rand()) % SEQ64_BENCH_LENGTH;
+        notes.push_back(make_note(tick, true));
+    }
+
+    int before = m_events.count();
+    std::int64_t start = test_harness::now_us();
+    for (int i = 0; i < count; ++i)
+        m_events.add(notes[i]);
+
+    std::int64_t us = test_harness::now_us() - start;
+    if (m_events.count() != before + count)
+        (void) m_harness.fail("insert: %d events kept", m_events.count());
+
+    (void) check_order("insert");
+    printf
+    (
+        "add, %d events: %.0f events/s\n", count,
+        test_harness::per_second(count, us)
+    );
+}
+
+}           // namespace seq64
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+    seq64::event_list_bench bench(h);
+    bench.load(h.int_arg(0, 100000));
+    bench.play(h.int_arg(2, 20));
+    bench.insert(h.int_arg(1, 200));
+    return h.status();
+}
+
+/*
+ * event_list_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
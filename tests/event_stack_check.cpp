@@ -0,0 +1,402 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_stack_check.cpp
+ *
+ *  This module defines a check of the undo and redo stack of the sequence
+ *  class, the event_stack.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  A pattern is edited at random:  events are added, runs of events are
+ *  removed or changed, and now and then every event is changed or the
+ *  pattern is cleared.  After each edit, the pattern is pushed both onto an
+ *  event_stack and onto a vector of full copies, which is what the sequence
+ *  used before; some of the time, the top is popped off both instead.  The
+ *  tops and sizes of the two stacks must agree after each step.  The same
+ *  is then done with a small memory limit, which must drop the oldest
+ *  entries and keep the newest ones intact.  Last, pushing an edit of one
+ *  event of a large pattern is timed against copying the pattern.
+ *
+ *  The container is the one that the library was built with; see
+ *  event_list_bench.cpp for building the three of them.  Built and run by
+ *  "make check"; see tests/Makefile.am.  Run it by hand as
+ *  "./event_stack_check [events] [edits]".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iterator>                     /* std::advance()                   */
+#include <vector>
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "event_list.hpp"               /* seq64::event_list                */
+#include "event_stack.hpp"              /* seq64::event_stack               */
+#include "test_harness.hpp"             /* seq64::test_harness              */
+
+/**
+ *  The length of the pattern, in ticks.
+ */
+
+#define SEQ64_CHECK_LENGTH      (192 * 4 * 64)
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Edits a pattern and compares an event_stack of it with full copies.
+ */
+
+class event_stack_check
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+    /**
+     *  The pattern being edited.
+     */
+
+    event_list m_events;
+
+public:
+
+    event_stack_check (test_harness & h)
+     :
+        m_harness   (h),
+        m_events    ()
+    {
+        // Empty body
+    }
+
+    bool check (int events, int edits, int kilobytes);
+    void run (int events, int edits);
+
+private:
+
+    void fill (int count);
+    void edit ();
+    bool same (const event_list & a, const event_list & b, int step);
+
+};
+
+/**
+ *  Makes a Note On or Note Off event with random data.
+ *
+ * \param tick
+ *      The time-stamp of the event.
+ */
+
+static event
+make_event (midipulse tick)
+{
+    event e;
+    e.set_timestamp(tick);
+    e.set_status(rand() % 2 == 0 ? EVENT_NOTE_ON : EVENT_NOTE_OFF);
+    e.set_data(midibyte(24 + rand() % 72), midibyte(rand() % 128));
+    return e;
+}
+
+/**
+ *  Replaces the pattern with events at random times.
+ *
+ * \param count
+ *      The number of events.
+ */
+
+void
+event_stack_check::fill (int count)
+{
+    m_events.clear();
+    for (int i = 0; i < count; ++i)
+        (void) m_events.append(make_event(rand() % SEQ64_CHECK_LENGTH));
+
+    m_events.sort();
+}
+
+/**
+ *  Makes one random edit of the pattern, of the kinds the pattern editor
+ *  makes:  adding a few events, deleting or changing a run of them, and,
+ *  less often, changing all of them or clearing the pattern.
+ */
+
+void
+event_stack_check::edit ()
+{
+    int kind = rand() % 20;
+    int count = m_events.count();
+    int first = count > 0 ? rand() % count : 0 ;
+    int length = 1 + rand() % 5;
+    event_list::iterator ei = m_events.begin();
+    std::advance(ei, first);
+    if (kind < 6 || count == 0)
+    {
+        for (int i = 0; i < length; ++i)
+            (void) m_events.add(make_event(rand() % SEQ64_CHECK_LENGTH));
+    }
+    else if (kind < 12)
+    {
+        for (int i = 0; i < length && first < m_events.count(); ++i)
+        {
+            ei = m_events.begin();          /* remove() may invalidate it   */
+            std::advance(ei, first);
+            m_events.remove(ei);
+        }
+    }
+    else if (kind < 18)
+    {
+        for (int i = 0; i < length && ei != m_events.end(); ++i, ++ei)
+            event_list::dref(ei).set_note_velocity(rand() % 128);
+    }
+    else if (kind < 19)
+    {
+        for (ei = m_events.begin(); ei != m_events.end(); ++ei)
+            event_list::dref(ei).set_note_velocity(rand() % 128);
+    }
+    else
+        m_events.clear();
+}
+
+/**
+ *  Compares the MIDI data of two event lists.
+ *
+ * \param a
+ *      The list from the event_stack.
+ *
+ * \param b
+ *      The full copy.
+ *
+ * \param step
+ *      The step of the check, for the failure message.
+ *
+ * \return
+ *      Returns true if the lists hold the same events in the same order.
+ */
+
+bool
+event_stack_check::same
+(
+    const event_list & a, const event_list & b, int step
+)
+{
+    if (a.count() != b.count())
+    {
+        return m_harness.fail
+        (
+            "step %d: %d events, expected %d", step, a.count(), b.count()
+        );
+    }
+
+    int index = 0;
+    event_list::const_iterator bi = b.begin();
+    for
+    (
+        event_list::const_iterator ai = a.begin();
+        ai != a.end(); ++ai, ++bi, ++index
+    )
+    {
+        const event & ea = event_list::dref(ai);
+        const event & eb = event_list::dref(bi);
+        midibyte a0, a1, b0, b1;
+        ea.get_data(a0, a1);
+        eb.get_data(b0, b1);
+        bool ok = ea.get_timestamp() == eb.get_timestamp() &&
+            ea.get_status() == eb.get_status() && a0 == b0 && a1 == b1;
+
+        if (! ok)
+            return m_harness.fail("step %d: event %d differs", step, index);
+    }
+    return true;
+}
+
+/**
+ *  Edits the pattern at random, pushing and popping it on an event_stack
+ *  and on a vector of full copies, and compares the two after each step.
+ *  Then pops both stacks to the bottom.  With a memory limit, the
+ *  event_stack may hold fewer entries than the copies; those it holds must
+ *  be the newest ones.
+ *
+ * \param events
+ *      The number of events to start the pattern with.
+ *
+ * \param edits
+ *      The number of steps.
+ *
+ * \param kilobytes
+ *      The memory limit of the event_stack, or 0 for none.
+ *
+ * \return
+ *      Returns true if the two stacks always agreed.
+ */
+
+bool
+event_stack_check::check (int events, int edits, int kilobytes)
+{
+    event_stack stack;
+    std::vector<event_list> copies;
+    stack.limit(kilobytes);
+    fill(events);
+    int pops = 0;
+    for (int step = 0; step < edits; ++step)
+    {
+        if (! stack.empty() && rand() % 4 == 0)
+        {
+            m_events = stack.top();         /* as sequence::pop_undo() does */
+            stack.pop();
+            copies.pop_back();
+            if (stack.empty())
+                copies.clear();             /* the rest were dropped        */
+
+            ++pops;
+        }
+        else
+        {
+            edit();
+            stack.push(m_events);
+            copies.push_back(m_events);
+        }
+
+        std::size_t size = stack.size();
+        bool ok = kilobytes > 0 ?
+            size <= copies.size() : size == copies.size() ;
+
+        if (size == 0 && ! copies.empty())
+            ok = false;
+
+        if (! ok)
+        {
+            return m_harness.fail
+            (
+                "step %d: %d entries, expected %d",
+                step, int(size), int(copies.size())
+            );
+        }
+        if (! copies.empty() && ! same(stack.top(), copies.back(), step))
+            return false;
+    }
+
+    std::size_t kept = stack.size();
+    while (! stack.empty())
+    {
+        if (! same(stack.top(), copies.back(), -int(stack.size())))
+            return false;
+
+        stack.pop();
+        copies.pop_back();
+    }
+    if (kilobytes == 0 && ! copies.empty())
+        return m_harness.fail("%d entries left over", int(copies.size()));
+
+    printf
+    (
+        "limit %d KB: %d steps, %d pops, %d entries kept at the end\n",
+        kilobytes, edits, pops, int(kept)
+    );
+    return true;
+}
+
+/**
+ *  Times pushing an edit of one event of a large pattern onto an
+ *  event_stack, against copying the whole pattern, as the sequence did.
+ *
+ * \param events
+ *      The size of the pattern.
+ *
+ * \param edits
+ *      The number of edits to push.
+ */
+
+void
+event_stack_check::run (int events, int edits)
+{
+    fill(events);
+    std::vector<int> positions;
+    for (int i = 0; i < edits; ++i)
+        positions.push_back(rand() % events);
+
+    event_stack stack;
+    std::int64_t start = test_harness::now_us();
+    for (int i = 0; i < edits; ++i)
+    {
+        event_list::iterator ei = m_events.begin();
+        std::advance(ei, positions[i]);
+        event_list::dref(ei).set_note_velocity(i % 128);
+        stack.push(m_events);
+    }
+    std::int64_t deltas = test_harness::now_us() - start;
+
+    std::vector<event_list> copies;
+    start = test_harness::now_us();
+    for (int i = 0; i < edits; ++i)
+    {
+        event_list::iterator ei = m_events.begin();
+        std::advance(ei, positions[i]);
+        event_list::dref(ei).set_note_velocity(i % 128);
+        copies.push_back(m_events);
+    }
+    std::int64_t copied = test_harness::now_us() - start;
+    if (stack.size() != copies.size())
+        (void) m_harness.fail("%d entries pushed", int(stack.size()));
+
+    printf
+    (
+        "%d events, %d one-event edits pushed\n"
+        "event_stack: %.0f pushes/s\n"
+        "full copies: %.0f pushes/s\n",
+        events, edits,
+        test_harness::per_second(edits, deltas),
+        test_harness::per_second(edits, copied)
+    );
+}
+
+}           // namespace seq64
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+    int edits = h.int_arg(1, 2000);
+    seq64::event_stack_check check(h);
+    if (check.check(2000, edits, 0) && check.check(2000, edits, 64))
+        check.run(h.int_arg(0, 100000), 200);
+
+    return h.status();
+}
+
+/*
+ * event_stack_check.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
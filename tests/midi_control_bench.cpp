@@ -0,0 +1,253 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_control_bench.cpp
+ *
+ *  This module defines a benchmark of the MIDI control lookup of the
+ *  perform class.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Every extended MIDI control is made active, with its toggle, on, and
+ *  off settings on Control Change numbers of three channels, and a stream
+ *  of Control Change events is sent through perform::midi_control_event().
+ *  The value ranges of the controls exclude the values sent, so that only
+ *  the lookup is timed, not the actions.  The old scan, which tested the
+ *  toggle, on, and off settings of every control with
+ *  midi_control::match(), is timed on the same events for comparison.
+ *  Before timing, the entries of the lookup table, obtained with
+ *  perform::midi_control_matches(), are checked against the old scan for
+ *  every status and data byte.
+ *
+ *  Built and run by "make check"; see tests/Makefile.am.  Run it by hand as
+ *  "./midi_control_bench [events]".
+ */
+
+#include <stdio.h>
+#include <vector>
+
+#include "test_harness.hpp"             /* seq64::test_harness, etc.        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Sets up the controls of a perform object and runs the benchmark.
+ */
+
+class midi_control_bench
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+    /**
+     *  The performance whose controls are looked up.
+     */
+
+    perform & m_perform;
+
+public:
+
+    midi_control_bench (test_harness & h, perform & p)
+     :
+        m_harness   (h),
+        m_perform   (p)
+    {
+        // Empty body
+    }
+
+    void setup ();
+    bool check ();
+    void run (int events);
+
+private:
+
+    int scan (midibyte status, midibyte data, std::vector<int> & entries);
+
+};
+
+/**
+ *  Activates every extended control.  The toggle settings use channel 1,
+ *  the on settings channel 2, and the off settings channel 3, all with the
+ *  control number as the Control Change number.
+ */
+
+void
+midi_control_bench::setup ()
+{
+    g_midi_control_limit = c_midi_controls_extended;
+    for (int ctl = 0; ctl < c_midi_controls_extended; ++ctl)
+    {
+        int toggle[6] = { 1, 0, 0xB0, ctl, 0, 0 };      /* value range 0..0 */
+        int on[6] = { 1, 0, 0xB1, ctl, 0, 0 };
+        int off[6] = { 1, 0, 0xB2, ctl, 0, 0 };
+        m_perform.midi_control_toggle(ctl).set(toggle);
+        m_perform.midi_control_on(ctl).set(on);
+        m_perform.midi_control_off(ctl).set(off);
+    }
+    m_perform.midi_controls_changed();
+}
+
+/**
+ *  The old lookup:  tests the toggle, on, and off settings of every
+ *  control.
+ *
+ * \param status
+ *      The status byte of the event.
+ *
+ * \param data
+ *      The first data byte of the event.
+ *
+ * \param [out] entries
+ *      The matching entries, encoded as in the lookup table.
+ *
+ * \return
+ *      Returns the number of matches.
+ */
+
+int
+midi_control_bench::scan
+(
+    midibyte status, midibyte data, std::vector<int> & entries
+)
+{
+    entries.clear();
+    for (int ctl = 0; ctl < g_midi_control_limit; ++ctl)
+    {
+        if (m_perform.midi_control_toggle(ctl).match(status, data))
+            entries.push_back(ctl * 3 + midi_control::action_toggle);
+
+        if (m_perform.midi_control_on(ctl).match(status, data))
+            entries.push_back(ctl * 3 + midi_control::action_on);
+
+        if (m_perform.midi_control_off(ctl).match(status, data))
+            entries.push_back(ctl * 3 + midi_control::action_off);
+    }
+    return int(entries.size());
+}
+
+/**
+ *  Checks that the lookup table holds, for every status and data byte,
+ *  the entries that the old scan finds, in the same order.
+ *
+ * \return
+ *      Returns true if all of the entries agree.
+ */
+
+bool
+midi_control_bench::check ()
+{
+    std::vector<int> expected;
+    std::vector<int> entries;
+    for (int status = 0x80; status <= 0xFF; ++status)
+    {
+        for (int data = 0; data <= 0x7F; ++data)
+        {
+            midibyte s = midibyte(status);
+            midibyte d = midibyte(data);
+            (void) scan(s, d, expected);
+            (void) m_perform.midi_control_matches(s, d, entries);
+            if (entries != expected)
+            {
+                return m_harness.fail
+                (
+                    "entries differ for 0x%02X %d", status, data
+                );
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ *  Times the lookup table and the old scan.
+ *
+ * \param events
+ *      The number of events to send.  A quarter of them, on channel 4,
+ *      match no control.
+ */
+
+void
+midi_control_bench::run (int events)
+{
+    std::int64_t start = test_harness::now_us();
+    for (int i = 0; i < events; ++i)
+    {
+        event ev;
+        ev.set_status(midibyte(0xB0 + i % 4));
+        ev.set_data(midibyte(i % 128), 64);
+        m_perform.midi_control_event(ev);
+    }
+    std::int64_t indexed = test_harness::now_us() - start;
+
+    std::vector<int> entries;
+    long matches = 0;
+    start = test_harness::now_us();
+    for (int i = 0; i < events; ++i)
+        matches += scan(midibyte(0xB0 + i % 4), midibyte(i % 128), entries);
+
+    std::int64_t scanned = test_harness::now_us() - start;
+    printf
+    (
+        "%d controls, %d events, %ld matches\n"
+        "indexed lookup: %.0f events/s\n"
+        "linear scan:    %.0f events/s\n",
+        c_midi_controls_extended, events, matches,
+        test_harness::per_second(events, indexed),
+        test_harness::per_second(events, scanned)
+    );
+}
+
+}           // namespace seq64
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+    seq64::test_performance tp;
+    seq64::midi_control_bench bench(h, tp.perf());
+    bench.setup();
+    if (bench.check())
+        bench.run(h.int_arg(0, 1000000));
+
+    return h.status();
+}
+
+/*
+ * midi_control_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,280 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midifile_save_bench.cpp
+ *
+ *  This module defines a benchmark of the saving of a large song by the
+ *  midifile class.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Every one of the 1024 patterns is filled with 256 notes (512 events),
+ *  and the song is saved with midifile::write() a number of times, the
+ *  best and average times being reported.  Each save must be the same as
+ *  the first, byte for byte, however the tracks were shared among the
+ *  threads of midifile::fill_tracks().  The file is then read back into a
+ *  second performance, whose patterns are checked to hold as many events as
+ *  the originals.
+ *
+ *  Built and run by "make check"; see tests/Makefile.am.  Run it by hand as
+ *  "./midifile_save_bench [saves] [directory]".  It is skipped if the MIDI
+ *  system cannot be opened, as the patterns need a master buss.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "sequence_edit.hpp"            /* seq64::sequence_edit             */
+#include "test_harness.hpp"             /* seq64::test_harness              */
+
+/**
+ *  The number of notes in each pattern, each made of a Note On and a Note
+ *  Off event.
+ */
+
+#define SEQ64_BENCH_NOTES       256
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Fills a performance and checks it against the one read back.
+ */
+
+class midifile_save_bench
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+public:
+
+    midifile_save_bench (test_harness & h) : m_harness (h)
+    {
+        // Empty body
+    }
+
+    void fill (perform & p);
+    bool check (perform & p, perform & q);
+
+};
+
+/**
+ *  Fills every pattern of a performance with sixteenth notes, with pitches
+ *  and velocities that vary from pattern to pattern.
+ *
+ * \param p
+ *      The performance to fill.
+ */
+
+void
+midifile_save_bench::fill (perform & p)
+{
+    for (int seq = 0; seq < c_max_sequence; ++seq)
+    {
+        p.new_sequence(seq);
+        sequence & s = *p.get_sequence(seq);
+        midipulse step = s.get_ppqn() / 4;
+        s.set_length(step * SEQ64_BENCH_NOTES);
+
+        sequence_edit edit(s, false);
+        for (int n = 0; n < SEQ64_BENCH_NOTES; ++n)
+        {
+            midibyte note = midibyte(36 + (seq + n * 7) % 48);
+            event on;
+            on.set_timestamp(n * step);
+            on.set_status(EVENT_NOTE_ON);
+            on.set_data(note, midibyte(64 + (seq + n) % 64));
+            edit.add(on);
+
+            event off;
+            off.set_timestamp(n * step + step - 1);
+            off.set_status(EVENT_NOTE_OFF);
+            off.set_data(note, 0);
+            edit.add(off);
+        }
+    }
+}
+
+/**
+ *  Reads a whole file.
+ *
+ * \param name
+ *      The name of the file.
+ *
+ * \param [out] bytes
+ *      The contents of the file.
+ *
+ * \return
+ *      Returns true if the file could be read.
+ */
+
+static bool
+read_file (const std::string & name, std::vector<char> & bytes)
+{
+    bytes.clear();
+    FILE * f = fopen(name.c_str(), "rb");
+    if (f == NULL)
+        return false;
+
+    char buffer[65536];
+    std::size_t count;
+    while ((count = fread(buffer, 1, sizeof buffer, f)) > 0)
+        bytes.insert(bytes.end(), buffer, buffer + count);
+
+    fclose(f);
+    return true;
+}
+
+/**
+ *  Checks that the patterns of two performances hold as many events.  The
+ *  time signature and tempo read back into the first pattern are not
+ *  counted, as they are written from the performance.
+ *
+ * \param p
+ *      The original performance.
+ *
+ * \param q
+ *      The performance read back from the file.
+ *
+ * \return
+ *      Returns true if all of the patterns agree.
+ */
+
+bool
+midifile_save_bench::check (perform & p, perform & q)
+{
+    for (int seq = 0; seq < c_max_sequence; ++seq)
+    {
+        if (! q.is_active(seq))
+            return m_harness.fail("pattern %d was not read back", seq);
+
+        const event_list & evl = q.get_sequence(seq)->events();
+        int expected = p.get_sequence(seq)->event_count();
+        int count = evl.count();
+        if (evl.has_time_signature())
+            --count;                    /* first track, if not in the file  */
+
+        if (evl.has_tempo())
+            --count;
+
+        if (count != expected)
+        {
+            return m_harness.fail
+            (
+                "pattern %d has %d events, expected %d", seq, count, expected
+            );
+        }
+    }
+    return true;
+}
+
+}           // namespace seq64
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+    int saves = h.int_arg(0, 10);
+    std::string name = h.string_arg(1, "/tmp") + "/midifile_save_bench.midi";
+    if (saves < 1)
+        saves = 1;
+
+    seq64::test_performance tp;
+    seq64::test_performance tq;
+    if (! tp.create_master_bus() || ! tq.create_master_bus())
+    {
+        printf("no MIDI system, skipped\n");
+        return SEQ64_TEST_SKIPPED;
+    }
+
+    seq64::perform & p = tp.perf();
+    seq64::midifile_save_bench bench(h);
+    bench.fill(p);
+
+    std::vector<char> bytes;
+    std::vector<char> again;
+    std::int64_t best = 0;
+    std::int64_t total = 0;
+    for (int i = 0; i < saves; ++i)
+    {
+        seq64::midifile f(name);
+        std::int64_t start = seq64::test_harness::now_us();
+        bool ok = f.write(p);
+        std::int64_t us = seq64::test_harness::now_us() - start;
+        if (ok)
+            ok = seq64::read_file(name, i == 0 ? bytes : again);
+
+        if (! ok)
+        {
+            (void) h.fail("could not write %s", name.c_str());
+            return h.status();
+        }
+        if (i > 0 && again != bytes)
+        {
+            (void) h.fail("save %d differs from the first one", i + 1);
+            return h.status();
+        }
+        total += us;
+        if (i == 0 || us < best)
+            best = us;
+    }
+    printf
+    (
+        "%d patterns of %d events, %d bytes\n"
+        "save: best %ld us, average %ld us, over %d saves\n",
+        c_max_sequence, 2 * SEQ64_BENCH_NOTES, int(bytes.size()),
+        long(best), long(total / saves), saves
+    );
+
+    seq64::midifile r(name);
+    if (! r.parse(tq.perf(), 0))
+        (void) h.fail("could not parse %s", name.c_str());
+    else if (bench.check(p, tq.perf()))
+        printf("all saves identical, and read back\n");
+
+    remove(name.c_str());
+    return h.status();
+}
+
+/*
+ * midifile_save_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
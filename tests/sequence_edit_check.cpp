@@ -0,0 +1,1018 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          sequence_edit_check.cpp
+ *
+ *  This module defines a check of the bulk edits of the sequence class,
+ *  which are made with a sequence_edit transaction.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  A pattern of 6060 events (3000 notes, some of them wrapping around the
+ *  end, and 60 volume changes) has its middle half selected, and then each
+ *  bulk edit is made on it:  moving, stretching, growing, and shrinking the
+ *  selection, transposing it, pasting a copy of it, and quantizing and
+ *  tightening it.  Each edit is also made on a copy of the events by the
+ *  reference class below, which keeps the code that the sequence class used
+ *  before the edits were batched, and the two results must hold the same
+ *  events.  Undoing the edit must then give back the pattern.  The time of
+ *  each edit is printed for both ways.
+ *
+ *  The container is the one that the library was built with; see
+ *  event_list_bench.cpp for building the three of them.  Built and run by
+ *  "make check"; see tests/Makefile.am.  Run it by hand as
+ *  "./sequence_edit_check".  It is skipped if the MIDI system cannot be
+ *  opened, as removing notes from a pattern turns them off on its buss.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>                    /* std::sort()                      */
+#include <vector>
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "event_list.hpp"               /* seq64::event_list                */
+#include "scales.h"                     /* c_scales_transpose_up[], etc.    */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "test_harness.hpp"             /* seq64::test_harness              */
+
+/**
+ *  The length of the pattern, in ticks, and the snap used by the edits.
+ */
+
+#define SEQ64_CHECK_LENGTH      (192 * 4 * 16)
+#define SEQ64_CHECK_SNAP        48
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The bulk edits, as the sequence class made them before they were
+ *  batched by sequence_edit.  Each function is the old one, with the
+ *  locking, the undo, and the notifications taken out, and with the fixes
+ *  made since to moving and growing notes.  They use only the public
+ *  functions of event_list; in particular, event_list::add() sorts the
+ *  events on each call, as it did.
+ */
+
+class reference
+{
+
+private:
+
+    event_list m_events;                /**< The events being edited.       */
+    event_list m_clipboard;             /**< The events copied.             */
+    midipulse m_length;                 /**< The length of the pattern.     */
+    midipulse m_snap_tick;              /**< The snap of the pattern.       */
+    midipulse m_note_off_margin;        /**< As sequence::note_off_margin() */
+
+public:
+
+    reference (const event_list & events, midipulse margin)
+     :
+        m_events            (events),
+        m_clipboard         (),
+        m_length            (SEQ64_CHECK_LENGTH),
+        m_snap_tick         (SEQ64_CHECK_SNAP),
+        m_note_off_margin   (margin)
+    {
+        m_events.verify_and_link(m_length);     /* a copy has no links      */
+    }
+
+    /**
+     * \getter m_events
+     */
+
+    const event_list & events () const
+    {
+        return m_events;
+    }
+
+    void move_selected_notes (midipulse delta_tick, int delta_note);
+    void stretch_selected (midipulse delta_tick);
+    void grow_selected (midipulse delta);
+    void transpose_notes (int steps, int scale);
+    void copy_selected ();
+    void paste_selected (midipulse tick, int note);
+    void quantize_events
+    (
+        midibyte status, midibyte cc,
+        midipulse snap_tick, int divide, bool linked
+    );
+
+private:
+
+    bool mark_selected ();
+    bool remove_marked ();
+    midipulse trim_timestamp (midipulse t);
+    midipulse adjust_timestamp (midipulse t, bool isnoteoff);
+    midipulse clip_timestamp (midipulse ontime, midipulse offtime);
+
+};
+
+/**
+ *  Marks the selected events.
+ *
+ * \return
+ *      Returns true if any event was marked.
+ */
+
+bool
+reference::mark_selected ()
+{
+    bool result = false;
+    for
+    (
+        event_list::iterator i = m_events.begin();
+        i != m_events.end(); ++i
+    )
+    {
+        event & e = event_list::dref(i);
+        if (e.is_selected())
+        {
+            e.mark();
+            result = true;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Removes the marked events, keeping the order of the others.
+ *
+ * \return
+ *      Returns true if any event was removed.
+ */
+
+bool
+reference::remove_marked ()
+{
+    bool result = false;
+    event_list kept;
+    for
+    (
+        event_list::iterator i = m_events.begin();
+        i != m_events.end(); ++i
+    )
+    {
+        const event & e = event_list::dref(i);
+        if (e.is_marked())
+            result = true;
+        else
+            (void) kept.append(e);
+    }
+    if (result)
+        m_events = kept;
+
+    return result;
+}
+
+/**
+ *  As sequence::trim_timestamp().
+ */
+
+midipulse
+reference::trim_timestamp (midipulse t)
+{
+    if (t >= m_length)
+        t -= m_length;
+
+    if (t < 0)
+        t += m_length;
+
+    if (t == 0)
+        t = m_length - m_note_off_margin;
+
+    return t;
+}
+
+/**
+ *  As sequence::adjust_timestamp().
+ */
+
+midipulse
+reference::adjust_timestamp (midipulse t, bool isnoteoff)
+{
+    if (t > m_length)
+        t -= m_length;
+
+    if (t < 0)
+        t += m_length;
+
+    if (isnoteoff)
+    {
+        if (t == 0)
+            t = m_length - m_note_off_margin;
+    }
+    else
+    {
+        if (t == m_length)
+            t = 0;
+    }
+    return t;
+}
+
+/**
+ *  As sequence::clip_timestamp().
+ */
+
+midipulse
+reference::clip_timestamp (midipulse ontime, midipulse offtime)
+{
+    if (offtime <= ontime)
+        offtime = ontime + m_snap_tick - m_note_off_margin;
+    else if (offtime >= m_length)
+        offtime = m_length - m_note_off_margin;
+
+    return offtime;
+}
+
+/**
+ *  The old sequence::move_selected_notes(), except that a selected event
+ *  that cannot be moved is left in place instead of being deleted.
+ */
+
+void
+reference::move_selected_notes (midipulse delta_tick, int delta_note)
+{
+    if (mark_selected())
+    {
+        event_list moved_events;
+        for
+        (
+            event_list::iterator i = m_events.begin();
+            i != m_events.end(); ++i
+        )
+        {
+            event & er = event_list::dref(i);
+            if (er.is_marked())
+            {
+                event e = er;
+                e.unmark();
+                int newnote = e.get_note() + delta_note;
+                if (newnote >= 0 && newnote < c_num_keys)
+                {
+                    midipulse newts = e.get_timestamp() + delta_tick;
+                    newts = adjust_timestamp(newts, e.is_note_off());
+                    if (e.is_note())
+                        e.set_note(midibyte(newnote));
+
+                    e.set_timestamp(newts);
+                    e.select();
+                    moved_events.add(e);
+                }
+                else
+                    er.unmark();
+            }
+        }
+        m_events.merge(moved_events);
+        if (remove_marked())
+            m_events.verify_and_link(m_length);
+    }
+}
+
+/**
+ *  The old sequence::stretch_selected().
+ */
+
+void
+reference::stretch_selected (midipulse delta_tick)
+{
+    if (mark_selected())
+    {
+        unsigned first_ev = 0x7fffffff;
+        unsigned last_ev = 0x00000000;
+        for
+        (
+            event_list::iterator i = m_events.begin();
+            i != m_events.end(); ++i
+        )
+        {
+            event & er = event_list::dref(i);
+            if (er.is_selected())
+            {
+                if (er.get_timestamp() < midipulse(first_ev))
+                    first_ev = er.get_timestamp();
+
+                if (er.get_timestamp() > midipulse(last_ev))
+                    last_ev = er.get_timestamp();
+            }
+        }
+        unsigned old_len = last_ev - first_ev;
+        unsigned new_len = old_len + delta_tick;
+        if (new_len > 1)
+        {
+            float ratio = float(new_len) / float(old_len);
+            event_list stretched_events;
+            (void) mark_selected();
+            for
+            (
+                event_list::iterator i = m_events.begin();
+                i != m_events.end(); ++i
+            )
+            {
+                event & er = event_list::dref(i);
+                if (er.is_marked())
+                {
+                    event n = er;
+                    midipulse t = er.get_timestamp() - first_ev;
+                    n.set_timestamp(midipulse(ratio * t) + first_ev);
+                    n.unmark();
+                    stretched_events.add(n);
+                }
+            }
+            m_events.merge(stretched_events);
+            if (remove_marked())
+                m_events.verify_and_link(m_length);
+        }
+    }
+}
+
+/**
+ *  The old sequence::grow_selected(), except that a selected non-note event
+ *  is moved instead of being deleted.  A selected note that is not a linked
+ *  Note On stays marked, and is deleted, as before.
+ */
+
+void
+reference::grow_selected (midipulse delta)
+{
+    if (mark_selected())
+    {
+        event_list grown_events;
+        for
+        (
+            event_list::iterator i = m_events.begin();
+            i != m_events.end(); ++i
+        )
+        {
+            event & er = event_list::dref(i);
+            if (er.is_note())
+            {
+                if (er.is_marked() && er.is_note_on() && er.is_linked())
+                {
+                    event * off = er.get_linked();
+                    event e = *off;
+                    midipulse offtime = off->get_timestamp();
+                    midipulse newtime = trim_timestamp(offtime + delta);
+                    off->mark();
+                    er.unmark();
+                    e.unmark();
+                    e.set_timestamp(newtime);
+                    grown_events.add(e);
+                }
+            }
+            else if (er.is_marked())
+            {
+                event e = er;
+                midipulse ontime = er.get_timestamp();
+                midipulse newtime = clip_timestamp(ontime, ontime + delta);
+                e.unmark();
+                e.set_timestamp(newtime);
+                grown_events.add(e);
+            }
+        }
+        m_events.merge(grown_events);
+        if (remove_marked())
+            m_events.verify_and_link(m_length);
+    }
+}
+
+/**
+ *  The old sequence::transpose_notes().
+ */
+
+void
+reference::transpose_notes (int steps, int scale)
+{
+    if (mark_selected())
+    {
+        event_list transposed_events;
+        const int * transpose_table;
+        if (steps < 0)
+        {
+            transpose_table = &c_scales_transpose_dn[scale][0];
+            steps *= -1;
+        }
+        else
+            transpose_table = &c_scales_transpose_up[scale][0];
+
+        for
+        (
+            event_list::iterator i = m_events.begin();
+            i != m_events.end(); ++i
+        )
+        {
+            event & er = event_list::dref(i);
+            if (er.is_marked() && er.is_note())
+            {
+                event e = er;
+                e.unmark();
+                int note = e.get_note();
+                bool off_scale = false;
+                if (transpose_table[note % SEQ64_OCTAVE_SIZE] == 0)
+                {
+                    off_scale = true;
+                    note -= 1;
+                }
+                for (int x = 0; x < steps; ++x)
+                    note += transpose_table[note % SEQ64_OCTAVE_SIZE];
+
+                if (off_scale)
+                    note += 1;
+
+                e.set_note(note);
+                transposed_events.add(e);
+            }
+            else
+                er.unmark();
+        }
+        (void) remove_marked();
+        m_events.merge(transposed_events);
+        m_events.verify_and_link(m_length);
+    }
+}
+
+/**
+ *  The old sequence::copy_selected().
+ */
+
+void
+reference::copy_selected ()
+{
+    event_list clipbd;
+    for
+    (
+        event_list::iterator i = m_events.begin();
+        i != m_events.end(); ++i
+    )
+    {
+        if (event_list::dref(i).is_selected())
+            clipbd.add(event_list::dref(i));
+    }
+    if (! clipbd.empty())
+    {
+        midipulse first_tick = event_list::dref(clipbd.begin()).get_timestamp();
+        for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
+        {
+            midipulse t = event_list::dref(i).get_timestamp();
+            if (t >= first_tick)
+                event_list::dref(i).set_timestamp(t - first_tick);
+        }
+        m_clipboard = clipbd;
+    }
+}
+
+/**
+ *  The old sequence::paste_selected().
+ */
+
+void
+reference::paste_selected (midipulse tick, int note)
+{
+    if (! m_clipboard.empty())
+    {
+        event_list clipbd = m_clipboard;
+        for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
+        {
+            event & e = event_list::dref(i);
+            e.set_timestamp(e.get_timestamp() + tick);
+        }
+
+        int highest_note = 0;
+        for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
+        {
+            event & e = event_list::dref(i);
+            if (e.is_note_on() || e.is_note_off())
+            {
+                midibyte n = e.get_note();
+                if (n > highest_note)
+                    highest_note = n;
+            }
+        }
+
+        int note_delta = note - highest_note;
+        for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
+        {
+            event & e = event_list::dref(i);
+            if (e.is_note())
+                e.set_note(e.get_note() + note_delta);
+        }
+        m_events.merge(clipbd, false);
+        m_events.sort();
+        m_events.verify_and_link(m_length);
+    }
+}
+
+/**
+ *  The old sequence::quantize_events().
+ */
+
+void
+reference::quantize_events
+(
+    midibyte status, midibyte cc,
+    midipulse snap_tick, int divide, bool linked
+)
+{
+    if (mark_selected())
+    {
+        event_list quantized_events;
+        for
+        (
+            event_list::iterator i = m_events.begin();
+            i != m_events.end(); ++i
+        )
+        {
+            event & er = event_list::dref(i);
+            midibyte d0, d1;
+            er.get_data(d0, d1);
+            bool match = er.get_status() == status;
+            bool canselect;
+            if (status == EVENT_CONTROL_CHANGE)
+                canselect = match && d0 == cc;
+            else
+                canselect = match;
+
+            if (! er.is_marked())
+                canselect = false;
+
+            if (canselect)
+            {
+                event e = er;
+                er.select();
+                e.unmark();
+
+                midipulse t = e.get_timestamp();
+                midipulse t_remainder = t % snap_tick;
+                midipulse t_delta = 0;
+                if (t_remainder < snap_tick / 2)
+                    t_delta = -(t_remainder / divide);
+                else
+                    t_delta = (snap_tick - t_remainder) / divide;
+
+                if ((t_delta + t) >= m_length)
+                    t_delta = -e.get_timestamp();
+
+                e.set_timestamp(e.get_timestamp() + t_delta);
+                quantized_events.add(e);
+                if (er.is_linked() && linked)
+                {
+                    event f = *er.get_linked();
+                    midipulse ft = f.get_timestamp() + t_delta;
+                    f.unmark();
+                    er.get_linked()->select();
+                    if (ft < 0)
+                        ft += m_length;
+
+                    if (ft == m_length)
+                        ft -= m_note_off_margin;
+
+                    if (ft > m_length)
+                        ft -= m_length;
+
+                    f.set_timestamp(ft);
+                    quantized_events.add(f);
+                }
+            }
+        }
+        (void) remove_marked();
+        m_events.merge(quantized_events);
+        m_events.verify_and_link(m_length);
+    }
+}
+
+/**
+ *  The parts of an event that the edits change, in an order that does not
+ *  depend on the container.
+ */
+
+class event_item
+{
+
+public:
+
+    midipulse m_tick;                   /**< The time-stamp.                */
+    int m_status;                       /**< The status, without channel.   */
+    int m_d0;                           /**< The first data byte.           */
+    int m_d1;                           /**< The second data byte.          */
+    bool m_selected;                    /**< The selection.                 */
+
+    event_item (const event & e)
+     :
+        m_tick      (e.get_timestamp()),
+        m_status    (e.get_status()),
+        m_d0        (0),
+        m_d1        (0),
+        m_selected  (e.is_selected())
+    {
+        midibyte d0, d1;
+        e.get_data(d0, d1);
+        m_d0 = d0;
+        m_d1 = d1;
+    }
+
+    bool operator < (const event_item & rhs) const
+    {
+        if (m_tick != rhs.m_tick)
+            return m_tick < rhs.m_tick;
+
+        if (m_status != rhs.m_status)
+            return m_status < rhs.m_status;
+
+        if (m_d0 != rhs.m_d0)
+            return m_d0 < rhs.m_d0;
+
+        if (m_d1 != rhs.m_d1)
+            return m_d1 < rhs.m_d1;
+
+        return m_selected < rhs.m_selected;
+    }
+
+    bool operator == (const event_item & rhs) const
+    {
+        return ! (*this < rhs) && ! (rhs < *this);
+    }
+
+};
+
+/**
+ *  Makes each bulk edit both ways and compares the results.
+ */
+
+class sequence_edit_check
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+    /**
+     *  The master buss of the sequences edited.
+     */
+
+    mastermidibus & m_master_bus;
+
+    /**
+     *  The pattern that each edit starts from, sorted.
+     */
+
+    event_list m_pattern;
+
+public:
+
+    sequence_edit_check (test_harness & h, mastermidibus & mmb)
+     :
+        m_harness       (h),
+        m_master_bus    (mmb),
+        m_pattern       ()
+    {
+        // Empty body
+    }
+
+    void fill (int notes, int controls);
+    bool check (int edit);
+
+private:
+
+    void load (sequence & s);
+    bool compare
+    (
+        const char * name, const event_list & got,
+        const event_list & expected, bool selection
+    );
+
+};
+
+/**
+ *  Makes the pattern:  notes of random pitch, velocity, and length at random
+ *  times, wrapping around the end if they are too long, and volume changes
+ *  at random times.
+ *
+ * \param notes
+ *      The number of notes.
+ *
+ * \param controls
+ *      The number of Control Change events.
+ */
+
+void
+sequence_edit_check::fill (int notes, int controls)
+{
+    for (int i = 0; i < notes; ++i)
+    {
+        midipulse on = rand() % SEQ64_CHECK_LENGTH;
+        midipulse off = (on + 1 + rand() % 383) % SEQ64_CHECK_LENGTH;
+        midibyte note = midibyte(rand() % 128);
+        event e;
+        e.set_timestamp(on);
+        e.set_status(EVENT_NOTE_ON);
+        e.set_data(note, midibyte(1 + rand() % 127));
+        (void) m_pattern.append(e);
+        e.set_timestamp(off);
+        e.set_status(EVENT_NOTE_OFF);
+        e.set_data(note, 0);
+        (void) m_pattern.append(e);
+    }
+    for (int i = 0; i < controls; ++i)
+    {
+        event e;
+        e.set_timestamp(rand() % SEQ64_CHECK_LENGTH);
+        e.set_status(EVENT_CONTROL_CHANGE);
+        e.set_data(7, midibyte(rand() % 128));
+        (void) m_pattern.append(e);
+    }
+    m_pattern.sort();
+}
+
+/**
+ *  Loads the pattern into a sequence, and selects its middle half:  the
+ *  notes that start there, and the volume changes there.
+ *
+ * \param s
+ *      The sequence to load.
+ */
+
+void
+sequence_edit_check::load (sequence & s)
+{
+    s.set_master_midi_bus(&m_master_bus);
+    s.set_length(SEQ64_CHECK_LENGTH);
+    s.set_snap_tick(SEQ64_CHECK_SNAP);
+    for
+    (
+        event_list::const_iterator i = m_pattern.begin();
+        i != m_pattern.end(); ++i
+    )
+    {
+        (void) s.append_event(event_list::dref(i));
+    }
+    s.sort_events();
+    s.set_length(SEQ64_CHECK_LENGTH);           /* links the notes          */
+    (void) s.select_note_events
+    (
+        SEQ64_CHECK_LENGTH / 4, 127, 3 * SEQ64_CHECK_LENGTH / 4, 0,
+        sequence::e_select
+    );
+    (void) s.select_events
+    (
+        SEQ64_CHECK_LENGTH / 4, 3 * SEQ64_CHECK_LENGTH / 4,
+        EVENT_CONTROL_CHANGE, 7, sequence::e_select
+    );
+}
+
+/**
+ *  Compares two event lists, in an order that does not depend on the
+ *  container, and checks that the first one is in time order and has as
+ *  many Note Ons as Note Offs, which the reference cannot check for itself.
+ *
+ * \param name
+ *      The name of the edit, for the failure message.
+ *
+ * \param got
+ *      The events of the sequence.
+ *
+ * \param expected
+ *      The events expected.
+ *
+ * \param selection
+ *      True if the selection of the events must be the same.
+ *
+ * \return
+ *      Returns true if the lists hold the same events.
+ */
+
+bool
+sequence_edit_check::compare
+(
+    const char * name, const event_list & got,
+    const event_list & expected, bool selection
+)
+{
+    std::vector<event_item> a;
+    std::vector<event_item> b;
+    midipulse last = 0;
+    int balance = 0;
+    for
+    (
+        event_list::const_iterator i = got.begin(); i != got.end(); ++i
+    )
+    {
+        const event & e = event_list::dref(i);
+        a.push_back(event_item(e));
+        if (! selection)
+            a.back().m_selected = false;
+
+        if (a.back().m_tick < last)
+            return m_harness.fail("%s: events out of order", name);
+
+        last = a.back().m_tick;
+        if (e.is_note_on())
+            ++balance;
+        else if (e.is_note_off())
+            --balance;
+    }
+    if (balance != 0)
+        return m_harness.fail("%s: %d more Note Ons than Offs", name, balance);
+
+    for
+    (
+        event_list::const_iterator i = expected.begin();
+        i != expected.end(); ++i
+    )
+    {
+        b.push_back(event_item(event_list::dref(i)));
+        if (! selection)
+            b.back().m_selected = false;
+    }
+    if (a.size() != b.size())
+    {
+        return m_harness.fail
+        (
+            "%s: %d events, expected %d", name, int(a.size()), int(b.size())
+        );
+    }
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (! (a[i] == b[i]))
+        {
+            return m_harness.fail
+            (
+                "%s: event at tick %ld differs", name, long(a[i].m_tick)
+            );
+        }
+    }
+    return true;
+}
+
+/**
+ *  Makes one of the edits on a sequence and on the reference, compares the
+ *  results, and then undoes the edit.
+ *
+ * \param edit
+ *      The number of the edit.
+ *
+ * \return
+ *      Returns false if there is no such edit, or if a check failed.
+ */
+
+bool
+sequence_edit_check::check (int edit)
+{
+    sequence s;
+    load(s);
+    reference r(s.events(), s.note_off_margin());
+    const char * name = "";
+    std::int64_t start = test_harness::now_us();
+    switch (edit)
+    {
+    case 0:
+        name = "move";
+        s.move_selected_notes(100, 3);
+        break;
+
+    case 1:
+        name = "move back";
+        s.move_selected_notes(-5000, -2);
+        break;
+
+    case 2:
+        name = "stretch";
+        s.stretch_selected(500);
+        break;
+
+    case 3:
+        name = "grow";
+        s.grow_selected(SEQ64_CHECK_SNAP);
+        break;
+
+    case 4:
+        name = "shrink";
+        s.grow_selected(-SEQ64_CHECK_SNAP / 2);
+        break;
+
+    case 5:
+        name = "transpose";
+        s.transpose_notes(2, c_scale_major);
+        break;
+
+    case 6:
+        name = "paste";
+        s.copy_selected();
+        s.paste_selected(1000, 90);
+        break;
+
+    case 7:
+        name = "quantize";
+        s.push_quantize(EVENT_NOTE_ON, 0, SEQ64_CHECK_SNAP, 1, true);
+        break;
+
+    case 8:
+        name = "tighten";
+        s.push_quantize(EVENT_NOTE_ON, 0, SEQ64_CHECK_SNAP, 2, true);
+        break;
+
+    default:
+        return false;
+    }
+    std::int64_t batched = test_harness::now_us() - start;
+
+    start = test_harness::now_us();
+    switch (edit)
+    {
+    case 0:     r.move_selected_notes(100, 3);                      break;
+    case 1:     r.move_selected_notes(-5000, -2);                   break;
+    case 2:     r.stretch_selected(500);                            break;
+    case 3:     r.grow_selected(SEQ64_CHECK_SNAP);                  break;
+    case 4:     r.grow_selected(-SEQ64_CHECK_SNAP / 2);             break;
+    case 5:     r.transpose_notes(2, c_scale_major);                break;
+    case 6:
+        r.copy_selected();
+        r.paste_selected(1000, 90);
+        break;
+
+    case 7:
+        r.quantize_events(EVENT_NOTE_ON, 0, SEQ64_CHECK_SNAP, 1, true);
+        break;
+
+    case 8:
+        r.quantize_events(EVENT_NOTE_ON, 0, SEQ64_CHECK_SNAP, 2, true);
+        break;
+    }
+    std::int64_t old = test_harness::now_us() - start;
+
+    int count = s.events().count();
+    if (! compare(name, s.events(), r.events(), true))
+        return false;
+
+    s.pop_undo();
+    if (! compare(name, s.events(), m_pattern, false))
+        return false;
+
+    printf
+    (
+        "%-10s %5d events, batched %7.3f ms, one at a time %7.3f ms\n",
+        name, count, batched / 1000.0, old / 1000.0
+    );
+    return true;
+}
+
+}           // namespace seq64
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+    seq64::test_performance tp;
+    if (! tp.create_master_bus())
+    {
+        printf("no MIDI system, skipped\n");
+        return SEQ64_TEST_SKIPPED;
+    }
+
+    seq64::sequence_edit_check check(h, tp.perf().master_bus());
+    check.fill(3000, 60);
+    for (int edit = 0; check.check(edit); ++edit)
+        ;
+
+    return h.status();
+}
+
+/*
+ * sequence_edit_check.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
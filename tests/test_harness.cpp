@@ -0,0 +1,196 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          test_harness.cpp
+ *
+ *  This module defines the pieces shared by the test and benchmark
+ *  programs in the tests directory.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+#include "test_harness.hpp"
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Saves the arguments, sets the default settings, and seeds the random
+ *  numbers, so that every run of a program does the same thing.
+ *
+ * \param argc
+ *      The number of command-line arguments, including the program name.
+ *
+ * \param argv
+ *      The command-line arguments.
+ */
+
+test_harness::test_harness (int argc, char * argv [])
+ :
+    m_args      (),
+    m_failures  (0)
+{
+    for (int i = 1; i < argc; ++i)
+        m_args.push_back(argv[i]);
+
+    rc().set_defaults();
+    usr().set_defaults();
+    srand(1);
+}
+
+/**
+ * \param index
+ *      The index of the argument, 0 for the first one after the program
+ *      name.
+ *
+ * \param defaultvalue
+ *      The value to use if there is no such argument.
+ *
+ * \return
+ *      Returns the argument as an integer, or the default value.
+ */
+
+int
+test_harness::int_arg (int index, int defaultvalue) const
+{
+    return index < int(m_args.size()) ?
+        atoi(m_args[index].c_str()) : defaultvalue ;
+}
+
+/**
+ * \param index
+ *      The index of the argument, 0 for the first one after the program
+ *      name.
+ *
+ * \param defaultvalue
+ *      The value to use if there is no such argument.
+ *
+ * \return
+ *      Returns the argument, or the default value.
+ */
+
+std::string
+test_harness::string_arg
+(
+    int index, const std::string & defaultvalue
+) const
+{
+    return index < int(m_args.size()) ? m_args[index] : defaultvalue ;
+}
+
+/**
+ *  Reports a failure, with a "? " prefix, and counts it.
+ *
+ * \param fmt
+ *      The printf() format of the message, without a newline.
+ *
+ * \return
+ *      Always returns false, so that a check can return fail(...).
+ */
+
+bool
+test_harness::fail (const char * fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    printf("? ");
+    vprintf(fmt, args);
+    printf("\n");
+    va_end(args);
+    ++m_failures;
+    return false;
+}
+
+/**
+ *  Converts a count of operations done in a time to a rate.
+ *
+ * \param count
+ *      The number of operations.
+ *
+ * \param us
+ *      The time they took, in microseconds.  A time of 0 counts as 1.
+ *
+ * \return
+ *      Returns the number of operations per second.
+ */
+
+double
+test_harness::per_second (long count, std::int64_t us)
+{
+    return double(count) * 1e6 / double(us > 0 ? us : 1);
+}
+
+/**
+ *  Creates the performance, without a master buss.
+ */
+
+test_performance::test_performance ()
+ :
+    m_keys      (),
+    m_gui       (m_keys),
+    m_perform   (m_gui)
+{
+    // Empty body
+}
+
+/**
+ *  Creates the master buss of the performance, without opening any port or
+ *  starting any thread, as perform::launch() would.  The sequences need it
+ *  when their channel is set, which parsing a file does.
+ *
+ * \return
+ *      Returns false if the MIDI system cannot be opened, in which case the
+ *      caller should exit with SEQ64_TEST_SKIPPED.
+ */
+
+bool
+test_performance::create_master_bus ()
+{
+    bool result = false;
+    try
+    {
+        result = m_perform.create_master_bus();
+    }
+    catch (...)
+    {
+        result = false;                 /* rterror, for one, if no ALSA     */
+    }
+    return result;
+}
+
+}           // namespace seq64
+
+/*
+ * test_harness.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,174 @@
+#ifndef SEQ64_TEST_HARNESS_HPP
+#define SEQ64_TEST_HARNESS_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          test_harness.hpp
+ *
+ *  This module declares the pieces shared by the test and benchmark
+ *  programs in the tests directory.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Each program creates one test_harness first, which sets the default
+ *  "rc" and "user" settings, and then, if it needs one, a test_performance.
+ *  The programs test the library through its public interface only.  A
+ *  program returns status(), or SEQ64_TEST_SKIPPED if it needs a MIDI
+ *  system that is not there, as "make check" expects.
+ */
+
+#include <string>
+#include <vector>
+
+#include "gui_assistant.hpp"            /* seq64::gui_assistant             */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "mutex.hpp"                    /* seq64::wakeup_event::now_us()    */
+#include "perform.hpp"                  /* seq64::perform                   */
+
+/**
+ *  The exit status that tells "make check" that a test was skipped.
+ */
+
+#define SEQ64_TEST_SKIPPED      77
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds the command-line arguments and the failure count of a test
+ *  program, and provides its timing helpers.
+ */
+
+class test_harness
+{
+
+private:
+
+    /**
+     *  The command-line arguments, without the program name.
+     */
+
+    std::vector<std::string> m_args;
+
+    /**
+     *  The number of calls to fail().
+     */
+
+    int m_failures;
+
+public:
+
+    test_harness (int argc, char * argv []);
+
+    int int_arg (int index, int defaultvalue) const;
+    std::string string_arg
+    (
+        int index, const std::string & defaultvalue
+    ) const;
+    bool fail (const char * fmt, ...);
+
+    /**
+     * \return
+     *      Returns the exit status of the program:  0 if nothing failed,
+     *      and 1 otherwise.
+     */
+
+    int status () const
+    {
+        return m_failures == 0 ? 0 : 1 ;
+    }
+
+    /**
+     * \return
+     *      Returns the current time in microseconds.
+     */
+
+    static std::int64_t now_us ()
+    {
+        return wakeup_event::now_us();
+    }
+
+    static double per_second (long count, std::int64_t us);
+
+};
+
+/**
+ *  A perform object, with the objects it needs, for the tests that work on
+ *  a whole performance.  Create it after the test_harness, which sets the
+ *  settings that perform reads.
+ */
+
+class test_performance
+{
+
+private:
+
+    /**
+     *  The keys of the performance, which are not used.
+     */
+
+    keys_perform m_keys;
+
+    /**
+     *  The user-interface assistant of the performance, not used either.
+     */
+
+    gui_assistant m_gui;
+
+    /**
+     *  The performance.
+     */
+
+    perform m_perform;
+
+public:
+
+    test_performance ();
+
+    /**
+     * \getter m_perform
+     */
+
+    perform & perf ()
+    {
+        return m_perform;
+    }
+
+    bool create_master_bus ();
+
+};
+
+}           // namespace seq64
+
+#endif      // SEQ64_TEST_HARNESS_HPP
+
+/*
+ * test_harness.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,411 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          triggers_check.cpp
+ *
+ *  This module defines a check of the trigger lookups of the triggers
+ *  class.
+ *
+ * \library       sequencer64 application
+ * \author        Sequencer64 contributors
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Ten thousand triggers, with gaps between them, are added in a shuffled
+ *  order, and then more triggers are added on top of them at random, so
+ *  that add() has to crop and erase the triggers they overlap.  After each
+ *  stage, the vector is checked to be sorted and free of overlaps, and
+ *  triggers::play_index() and triggers::find() are compared with a linear
+ *  scan of the vector, both for ticks in increasing order (where the hint
+ *  of play_index() is used) and for random ticks (where the binary search
+ *  is used).  Both lookups are then timed against the linear scan.
+ *
+ *  Built and run by "make check"; see tests/Makefile.am.  Run it by hand as
+ *  "./triggers_check [triggers]".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>                    /* std::swap()                      */
+#include <vector>
+
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "test_harness.hpp"             /* seq64::test_harness              */
+#include "triggers.hpp"                 /* seq64::triggers                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The vector of triggers, as returned by triggers::triggerlist().
+ */
+
+typedef std::vector<trigger> trigger_list;
+
+/**
+ *  Fills a triggers object and checks its lookups.
+ */
+
+class triggers_check
+{
+
+private:
+
+    /**
+     *  The test program, which counts the failures.
+     */
+
+    test_harness & m_harness;
+
+    /**
+     *  The triggers to check.
+     */
+
+    triggers & m_triggers;
+
+    /**
+     *  The tick past the end of the last trigger added.
+     */
+
+    midipulse m_limit;
+
+public:
+
+    triggers_check (test_harness & h, triggers & t)
+     :
+        m_harness   (h),
+        m_triggers  (t),
+        m_limit     (0)
+    {
+        // Empty body
+    }
+
+    void fill (int count);
+    void overlap (int count);
+    bool check (int lookups);
+    void run (int lookups);
+
+private:
+
+    bool check_order ();
+    bool check_tick (midipulse tick, std::size_t first = 0);
+    std::size_t scan_play_index (midipulse tick, std::size_t first) const;
+    std::size_t scan_find (midipulse tick, std::size_t first) const;
+
+};
+
+/**
+ *  Returns a random tick from 0 to a little past the end of the triggers.
+ *
+ * \param limit
+ *      The tick past the end of the last trigger.
+ */
+
+static midipulse
+random_tick (midipulse limit)
+{
+    return midipulse(rand()) % (limit + 100);
+}
+
+/**
+ *  Adds triggers of 1 to 200 ticks, with gaps of 0 to 99 ticks between
+ *  them, in a shuffled order.
+ *
+ * \param count
+ *      The number of triggers to add.
+ */
+
+void
+triggers_check::fill (int count)
+{
+    std::vector<trigger> slots;
+    midipulse tick = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        trigger t;
+        tick += rand() % 100;
+        t.tick_start(tick);
+        tick += 1 + rand() % 200;
+        t.tick_end(tick - 1);
+        slots.push_back(t);
+    }
+    m_limit = tick;
+    for (int i = count - 1; i > 0; --i)
+        std::swap(slots[i], slots[rand() % (i + 1)]);
+
+    for (int i = 0; i < count; ++i)
+    {
+        midipulse start = slots[i].tick_start();
+        midipulse len = slots[i].tick_end() - start + 1;
+        m_triggers.add(start, len, 0, false);
+    }
+}
+
+/**
+ *  Adds triggers of up to 1000 ticks at random places, overlapping the
+ *  triggers already there.
+ *
+ * \param count
+ *      The number of triggers to add.
+ */
+
+void
+triggers_check::overlap (int count)
+{
+    for (int i = 0; i < count; ++i)
+        m_triggers.add(random_tick(m_limit), 1 + rand() % 1000, 0, false);
+}
+
+/**
+ *  The old lookup of play_index():  the first trigger that ends after the
+ *  tick.
+ *
+ * \param tick
+ *      The tick to look up.
+ *
+ * \param first
+ *      The trigger at which to start the scan.  The triggers before it must
+ *      end before the tick.
+ *
+ * \return
+ *      Returns the index of the trigger, or the size of the vector if there
+ *      is none.
+ */
+
+std::size_t
+triggers_check::scan_play_index (midipulse tick, std::size_t first) const
+{
+    const trigger_list & tl = m_triggers.triggerlist();
+    std::size_t i = first;
+    while (i < tl.size() && tl[i].tick_end() <= tick)
+        ++i;
+
+    return i;
+}
+
+/**
+ *  The old lookup of find():  the first trigger that holds the tick.
+ *
+ * \param tick
+ *      The tick to look up.
+ *
+ * \param first
+ *      The trigger at which to start the scan.  The triggers before it must
+ *      end before the tick.
+ *
+ * \return
+ *      Returns the index of the trigger, or the size of the vector if there
+ *      is none.
+ */
+
+std::size_t
+triggers_check::scan_find (midipulse tick, std::size_t first) const
+{
+    const trigger_list & tl = m_triggers.triggerlist();
+    std::size_t i = first;
+    while (i < tl.size())
+    {
+        if (tl[i].tick_start() <= tick && tick <= tl[i].tick_end())
+            break;
+
+        ++i;
+    }
+    return i;
+}
+
+/**
+ *  Checks that the triggers are sorted, and that none of them overlap.
+ *
+ * \return
+ *      Returns true if the order is good.
+ */
+
+bool
+triggers_check::check_order ()
+{
+    const trigger_list & tl = m_triggers.triggerlist();
+    for (std::size_t i = 0; i < tl.size(); ++i)
+    {
+        bool ok = tl[i].tick_start() <= tl[i].tick_end();
+        if (ok && i > 0)
+            ok = tl[i - 1].tick_end() < tl[i].tick_start();
+
+        if (! ok)
+            return m_harness.fail("trigger %d out of order", int(i));
+    }
+    return true;
+}
+
+/**
+ *  Compares both lookups with the linear scans for one tick.
+ *
+ * \param tick
+ *      The tick to look up.
+ *
+ * \param first
+ *      The trigger at which to start the scans.  See scan_play_index().
+ *
+ * \return
+ *      Returns true if the lookups agree with the scans.
+ */
+
+bool
+triggers_check::check_tick (midipulse tick, std::size_t first)
+{
+    trigger_list & tl = m_triggers.triggerlist();
+    std::size_t expected = scan_play_index(tick, first);
+    std::size_t index = m_triggers.play_index(tick);
+    if (index != expected)
+    {
+        return m_harness.fail
+        (
+            "play_index(%ld) = %d, expected %d",
+            long(tick), int(index), int(expected)
+        );
+    }
+    expected = scan_find(tick, first);
+    index = std::size_t(m_triggers.find(tick) - tl.begin());
+    if (index != expected)
+    {
+        return m_harness.fail
+        (
+            "find(%ld) = %d, expected %d",
+            long(tick), int(index), int(expected)
+        );
+    }
+    return true;
+}
+
+/**
+ *  Checks the order of the triggers, and then the lookups for every tick up
+ *  to a little past the end, in order, and for random ticks.  Scanning the
+ *  whole vector for every tick would take too long, so the in-order scans
+ *  start at the trigger found for the previous tick, which the order check
+ *  allows.
+ *
+ * \param lookups
+ *      The number of random ticks to check.
+ *
+ * \return
+ *      Returns true if all of the checks pass.
+ */
+
+bool
+triggers_check::check (int lookups)
+{
+    if (! check_order())
+        return false;
+
+    std::size_t first = 0;
+    for (midipulse tick = 0; tick < m_limit + 100; ++tick)
+    {
+        if (! check_tick(tick, first))
+            return false;
+
+        first = scan_play_index(tick, first);
+    }
+    for (int i = 0; i < lookups; ++i)
+    {
+        if (! check_tick(random_tick(m_limit)))
+            return false;
+    }
+    printf
+    (
+        "%d triggers, %ld ticks in order, %d at random checked\n",
+        int(m_triggers.triggerlist().size()), long(m_limit + 100), lookups
+    );
+    return true;
+}
+
+/**
+ *  Times the lookups and the linear scans on random ticks.
+ *
+ * \param lookups
+ *      The number of ticks to look up.
+ */
+
+void
+triggers_check::run (int lookups)
+{
+    std::vector<midipulse> ticks;
+    for (int i = 0; i < lookups; ++i)
+        ticks.push_back(random_tick(m_limit));
+
+    trigger_list & tl = m_triggers.triggerlist();
+    std::size_t sum = 0;
+    std::int64_t start = test_harness::now_us();
+    for (int i = 0; i < lookups; ++i)
+    {
+        sum += m_triggers.play_index(ticks[i]);
+        sum += std::size_t(m_triggers.find(ticks[i]) - tl.begin());
+    }
+    std::int64_t indexed = test_harness::now_us() - start;
+
+    start = test_harness::now_us();
+    for (int i = 0; i < lookups; ++i)
+        sum -= scan_play_index(ticks[i], 0) + scan_find(ticks[i], 0);
+
+    std::int64_t scanned = test_harness::now_us() - start;
+    if (sum != 0)
+        (void) m_harness.fail("timed lookups differ from the scans");
+
+    printf
+    (
+        "%d random lookups\n"
+        "binary search: %.0f lookups/s\n"
+        "linear scan:   %.0f lookups/s\n",
+        lookups,
+        test_harness::per_second(lookups, indexed),
+        test_harness::per_second(lookups, scanned)
+    );
+}
+
+}           // namespace seq64
+
+/*
+ * This section provides a main routine for testing purposes.
+ */
+
+int main (int argc, char * argv [])
+{
+    seq64::test_harness h(argc, argv);
+    int count = h.int_arg(0, 10000);
+    seq64::sequence s;
+    seq64::triggers t(s);
+    seq64::triggers_check check(h, t);
+    check.fill(count);
+    if (check.check(10000))
+    {
+        check.overlap(count / 10);
+        if (check.check(10000))
+            check.run(10000);
+    }
+    return h.status();
+}
+
+/*
+ * triggers_check.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */